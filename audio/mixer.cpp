@@ -23,6 +23,7 @@
 #include "gui/EventRecorder.h"
 
 #include "common/util.h"
+#include "common/profiler.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -44,7 +45,8 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent,
+	        const SincFilterBank *sincFilters = 0);
 	~Channel();
 
 	/**
@@ -123,9 +125,14 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Copies the state needed to compute how long the channel has been playing.
 	 */
-	Timestamp getElapsedTime();
+	void getTimeState(ChannelTimeState &state) const;
+
+	/**
+	 * Computes how long a channel has been playing from its time state.
+	 */
+	static Timestamp computeElapsedTime(const ChannelTimeState &state, uint32 rate);
 
 	/**
 	 * Queries the channel's sound type.
@@ -173,19 +180,46 @@ private:
 #pragma mark --- Mixer ---
 #pragma mark -
 
+// Orders the memory accesses between the engine threads and the mixer thread
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define MIXER_MEMORY_BARRIER() __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define MIXER_MEMORY_BARRIER() _ReadWriteBarrier()
+#else
+#define MIXER_MEMORY_BARRIER() do {} while (0)
+#endif
+
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandRead(0), _commandWrite(0), _resamplingQuality(kResamplingLinear) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_channelStates[i].active = false;
+		_finishedHandles[i] = 0xFFFFFFFF;
+		_timeSequences[i] = 0;
+		_timeStates[i].handle = 0xFFFFFFFF;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// Channels which were never started
+	while (_commandRead != _commandWrite) {
+		const Command &command = _commands[_commandRead % COMMAND_QUEUE_SIZE];
+		if (command.type == Command::kPlay)
+			delete command.channel;
+		_commandRead++;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	for (uint i = 0; i < _sincFilterBanks.size(); i++)
+		delete _sincFilterBanks[i];
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -196,10 +230,146 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+void MixerImpl::setResamplingQuality(ResamplingQuality quality) {
+	Common::StackLock lock(_commandMutex);
+	_resamplingQuality = quality;
+}
+
+Mixer::ResamplingQuality MixerImpl::getResamplingQuality() const {
+	return _resamplingQuality;
+}
+
+const SincFilterBank *MixerImpl::getSincFilterBank(uint inputRate) {
+	for (uint i = 0; i < _sincFilterBanks.size(); i++) {
+		if (_sincFilterBanks[i]->getInputRate() == inputRate)
+			return _sincFilterBanks[i];
+	}
+
+	// The tables are kept for the lifetime of the mixer, there are only
+	// a handful of different input rates
+	SincFilterBank *filters = SincFilterBank::create(inputRate, _sampleRate);
+	if (filters)
+		_sincFilterBanks.push_back(filters);
+
+	return filters;
+}
+
+bool MixerImpl::isChannelStateActive(int index) const {
+	return _channelStates[index].active && _finishedHandles[index] != _channelStates[index].handle;
+}
+
+MixerImpl::ChannelState *MixerImpl::findChannelState(SoundHandle handle) {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!isChannelStateActive(index) || _channelStates[index].handle != handle._val)
+		return 0;
+
+	return &_channelStates[index];
+}
+
+void MixerImpl::queueCommand(Command::Type type, uint32 handle, int value, int id, Channel *channel) {
+	if (_commandWrite - _commandRead == COMMAND_QUEUE_SIZE) {
+		// The mixer thread is not keeping up, or not running at all
+		Common::StackLock lock(_mutex);
+		applyCommands();
+	}
+
+	Command &command = _commands[_commandWrite % COMMAND_QUEUE_SIZE];
+	command.type = type;
+	command.channel = channel;
+	command.handle = handle;
+	command.id = id;
+	command.value = value;
+	MIXER_MEMORY_BARRIER();
+	_commandWrite++;
+}
+
+void MixerImpl::applyCommands() {
+	uint32 write = _commandWrite;
+	MIXER_MEMORY_BARRIER();
+
+	while (_commandRead != write) {
+		applyCommand(_commands[_commandRead % COMMAND_QUEUE_SIZE]);
+		MIXER_MEMORY_BARRIER();
+		_commandRead++;
+	}
+}
+
+void MixerImpl::applyCommand(const Command &command) {
+	const int index = command.handle % NUM_CHANNELS;
+	Channel *chan = _channels[index];
+	if (chan && chan->getHandle()._val != command.handle)
+		chan = 0;
+
+	switch (command.type) {
+	case Command::kPlay:
+		assert(!_channels[index]);
+		_channels[index] = command.channel;
+		publishTimeState(index);
+		break;
+	case Command::kSetVolume:
+		if (chan)
+			chan->setVolume(command.value);
+		break;
+	case Command::kSetBalance:
+		if (chan)
+			chan->setBalance(command.value);
+		break;
+	case Command::kPauseAll:
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0) {
+				_channels[i]->pause(command.value);
+				publishTimeState(i);
+			}
+		}
+		break;
+	case Command::kPauseID:
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0 && _channels[i]->getId() == command.id) {
+				_channels[i]->pause(command.value);
+				publishTimeState(i);
+				break;
+			}
+		}
+		break;
+	case Command::kPauseHandle:
+		if (chan) {
+			chan->pause(command.value);
+			publishTimeState(index);
+		}
+		break;
+	case Command::kUpdateVolumes:
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == command.value)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		break;
+	}
+}
+
+void MixerImpl::deleteChannel(int index) {
+	delete _channels[index];
+	_channels[index] = 0;
+	publishTimeState(index);
+}
+
+void MixerImpl::publishTimeState(int index) {
+	_timeSequences[index]++;
+	MIXER_MEMORY_BARRIER();
+
+	ChannelTimeState &state = _timeStates[index];
+	if (_channels[index])
+		_channels[index]->getTimeState(state);
+	else
+		state.handle = 0xFFFFFFFF;
+
+	MIXER_MEMORY_BARRIER();
+	_timeSequences[index]++;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (!isChannelStateActive(i)) {
 			index = i;
 			break;
 		}
@@ -210,8 +380,6 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
@@ -219,6 +387,16 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	ChannelState &state = _channelStates[index];
+	state.active = true;
+	state.handle = chanHandle._val;
+	state.id = chan->getId();
+	state.type = chan->getType();
+	state.volume = chan->getVolume();
+	state.balance = chan->getBalance();
+
+	queueCommand(Command::kPlay, chanHandle._val, 0, -1, chan);
 }
 
 void MixerImpl::playStream(
@@ -229,7 +407,7 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 	if (stream == 0) {
 		warning("stream is 0");
@@ -242,7 +420,7 @@ void MixerImpl::playStream(
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (isChannelStateActive(i) && _channelStates[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -259,8 +437,13 @@ void MixerImpl::playStream(
 	reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	// Rates the sinc filter can't handle fall back to the linear converters
+	const SincFilterBank *sincFilters = 0;
+	if (_resamplingQuality == kResamplingSinc && (uint)stream->getRate() != _sampleRate)
+		sincFilters = getSincFilterBank(stream->getRate());
+
+	// Create the channel, the mixer thread takes it over once the command is applied
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, sincFilters);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -270,6 +453,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
 	Common::StackLock lock(_mutex);
+	PROFILE_THREAD_ZONE("Mixer callback", kThreadAudio);
+
+	applyCommands();
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -287,10 +473,15 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
+				uint32 finishedHandle = _channels[i]->getHandle()._val;
+				deleteChannel(i);
+
+				// Let the engine threads reuse the slot
+				MIXER_MEMORY_BARRIER();
+				_finishedHandles[i] = finishedHandle;
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
+				publishTimeState(i);
 
 				if (tmp > res)
 					res = tmp;
@@ -301,45 +492,54 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 }
 
 void MixerImpl::stopAll() {
+	Common::StackLock commandLock(_commandMutex);
 	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+			deleteChannel(i);
+			_channelStates[i].active = false;
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
+	Common::StackLock commandLock(_commandMutex);
 	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+			deleteChannel(i);
+			_channelStates[i].active = false;
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock commandLock(_commandMutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
+		deleteChannel(index);
+	state->active = false;
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_commandMutex);
+	queueCommand(Command::kUpdateVolumes, 0, type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -348,39 +548,45 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setVolume(volume);
+	state->volume = volume;
+	queueCommand(Command::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_commandMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return state->volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setBalance(balance);
+	state->balance = balance;
+	queueCommand(Command::kSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_commandMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return state->balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -388,81 +594,81 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+
+	// Read a consistent copy of the state published by the mixer thread
+	ChannelTimeState state;
+	uint32 sequence;
+	do {
+		sequence = _timeSequences[index];
+		MIXER_MEMORY_BARRIER();
+		state = _timeStates[index];
+		MIXER_MEMORY_BARRIER();
+	} while ((sequence & 1) || sequence != _timeSequences[index]);
+
+	// Also covers the channels not started by the mixer thread yet
+	if (state.handle != handle._val)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return Channel::computeElapsedTime(state, _sampleRate);
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
-	}
+	Common::StackLock lock(_commandMutex);
+	queueCommand(Command::kPauseAll, 0, paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
-		}
-	}
+	Common::StackLock lock(_commandMutex);
+	queueCommand(Command::kPauseID, 0, paused, id);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannelState(handle))
 		return;
 
-	_channels[index]->pause(paused);
+	queueCommand(Command::kPauseHandle, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isChannelStateActive(i) && _channelStates[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Common::StackLock lock(_commandMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (state)
+		return state->id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannelState(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isChannelStateActive(i) && _channelStates[i].type == type)
 			return true;
 	return false;
 }
@@ -479,13 +685,10 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(Command::kUpdateVolumes, 0, type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -500,7 +703,8 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent,
+                 const SincFilterBank *sincFilters)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
@@ -509,7 +713,10 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	if (sincFilters)
+		_converter = makeSincRateConverter(*sincFilters, _stream->isStereo(), reverseStereo);
+	else
+		_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
 }
 
 Channel::~Channel() {
@@ -579,23 +786,31 @@ void Channel::pause(bool paused) {
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
+void Channel::getTimeState(ChannelTimeState &state) const {
+	state.handle = _handle._val;
+	state.samplesConsumed = _samplesConsumed;
+	state.mixerTimeStamp = _mixerTimeStamp;
+	state.pauseStartTime = _pauseStartTime;
+	state.pauseTime = _pauseTime;
+	state.paused = isPaused();
+}
+
+Timestamp Channel::computeElapsedTime(const ChannelTimeState &state, uint32 rate) {
 	uint32 delta = 0;
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	if (state.mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (state.paused)
+		delta = state.pauseStartTime - state.mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - state.mixerTimeStamp - state.pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(state.samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
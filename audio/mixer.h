@@ -65,6 +65,11 @@ public:
 		kMaxMixerVolume = 256
 	};
 
+	enum ResamplingQuality {
+		kResamplingLinear = 0,	///< Nearest sample or linear interpolation
+		kResamplingSinc = 1		///< Polyphase windowed sinc filter
+	};
+
 public:
 	Mixer() {}
 	virtual ~Mixer() {}
@@ -277,6 +282,21 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Set how the sounds are converted to the output sample rate.
+	 * Only affects the sounds started afterwards.
+	 *
+	 * @param quality the resampling method
+	 */
+	virtual void setResamplingQuality(ResamplingQuality quality) = 0;
+
+	/**
+	 * Query how the sounds are converted to the output sample rate.
+	 *
+	 * @return the resampling method
+	 */
+	virtual ResamplingQuality getResamplingQuality() const = 0;
 };
 
 
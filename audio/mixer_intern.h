@@ -24,11 +24,27 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
 namespace Audio {
 
+class SincFilterBank;
+
+/**
+ * The timing state of a channel, as published by the mixer thread
+ * for Mixer::getElapsedTime.
+ */
+struct ChannelTimeState {
+	uint32 handle;
+	uint32 samplesConsumed;
+	uint32 mixerTimeStamp;
+	uint32 pauseStartTime;
+	uint32 pauseTime;
+	bool paused;
+};
+
 /**
  * The (default) implementation of the ScummVM audio mixing subsystem.
  *
@@ -46,20 +62,81 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * The engine threads don't touch the channels directly. Starting a sound
+ * and changing the volume, balance or pause state of the channels queue
+ * commands in a lock-free ring, which the mixer applies at the start of
+ * each callback. The queries are answered from the engine side view of
+ * the channels, and from the state published by the mixer thread. Only
+ * stopping sounds still waits for the mixer, as the caller may free the
+ * data of a stream as soon as it is stopped.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32 // ResidualVM specific
+		NUM_CHANNELS = 32, // ResidualVM specific
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/** Guards the channels, held by the mixer thread while mixing */
 	Common::Mutex _mutex;
 
+	struct Command {
+		enum Type {
+			kPlay,
+			kSetVolume,
+			kSetBalance,
+			kPauseAll,
+			kPauseID,
+			kPauseHandle,
+			kUpdateVolumes
+		};
+
+		Type type;
+		Channel *channel;
+		uint32 handle;
+		int id;
+		int value;
+	};
+
+	/**
+	 * Single producer / single consumer ring of commands. The engine threads
+	 * queuing commands are serialized by _commandMutex, which the mixer thread
+	 * never takes. Commands are only applied while holding _mutex.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	volatile uint32 _commandRead;
+	volatile uint32 _commandWrite;
+	Common::Mutex _commandMutex;
+
+	/** The channels as seen by the engine threads, guarded by _commandMutex */
+	struct ChannelState {
+		bool active;
+		uint32 handle;
+		int id;
+		SoundType type;
+		byte volume;
+		int8 balance;
+	};
+
+	ChannelState _channelStates[NUM_CHANNELS];
+
+	/** Handle of the last channel of each slot that ended on its own, written by the mixer thread */
+	volatile uint32 _finishedHandles[NUM_CHANNELS];
+
+	/** Timing state of the channels, written by the mixer thread under a sequence lock */
+	volatile uint32 _timeSequences[NUM_CHANNELS];
+	ChannelTimeState _timeStates[NUM_CHANNELS];
+
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
+	/** Filter tables of the sinc rate converters for each input rate, guarded by _commandMutex */
+	ResamplingQuality _resamplingQuality;
+	Common::Array<SincFilterBank *> _sincFilterBanks;
+
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
@@ -118,9 +195,28 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	virtual void setResamplingQuality(ResamplingQuality quality);
+	virtual ResamplingQuality getResamplingQuality() const;
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/** Get the sinc filter tables for an input rate, or nullptr, the caller must hold _commandMutex */
+	const SincFilterBank *getSincFilterBank(uint inputRate);
+
+	/** Find the engine side state of an active channel, or nullptr */
+	ChannelState *findChannelState(SoundHandle handle);
+	bool isChannelStateActive(int index) const;
+
+	/** Queue a command for the mixer thread, the caller must hold _commandMutex */
+	void queueCommand(Command::Type type, uint32 handle, int value, int id = -1, Channel *channel = 0);
+	/** Apply the queued commands, the caller must hold _mutex */
+	void applyCommands();
+	void applyCommand(const Command &command);
+	/** Delete a channel, the caller must hold _mutex */
+	void deleteChannel(int index);
+	void publishTimeState(int index);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
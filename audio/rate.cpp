@@ -30,6 +30,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
@@ -38,14 +39,6 @@
 namespace Audio {
 
 
-/**
- * The size of the intermediate input cache. Bigger values may increase
- * performance, but only until some point (depends largely on cache size,
- * target processor and various other factors), at which it will decrease
- * again.
- */
-#define INTERMEDIATE_BUFFER_SIZE 512
-
 /**
  * The default fractional type in frac.h (with 16 fractional bits) limits
  * the rate conversion code to 65536Hz audio: we need to able to handle
@@ -70,6 +63,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** resampled frames, waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -118,39 +114,50 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
+	// The resampled frames are gathered in outBuf, and mixed a block at a time
+	const int maxOutFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_sample_t *outPtr = outBuf;
+	int outFrames = 0;
 
-		// read enough input samples so that opos >= 0
+	while (obuf + outFrames * 2 < oend) {
+
+		// read enough input samples so that opos < 0, skipping all of the
+		// buffered frames at once when possible
 		do {
 			// Check if we have to refill the buffer
 			if (inLen == 0) {
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
+				if (inLen <= 0) {
+					mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+					return (obuf - ostart) / 2 + outFrames;
+				}
 			}
+			long frames = MIN<long>(opos + 1, inLen / (stereo ? 2 : 1));
+			inLen -= frames * (stereo ? 2 : 1);
+			opos -= frames;
+
+			// The last frame is left for the output
+			inPtr += (opos >= 0 ? frames : frames - 1) * (stereo ? 2 : 1);
 		} while (opos >= 0);
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+		*outPtr++ = *inPtr++;
+		if (stereo)
+			*outPtr++ = *inPtr++;
 
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-		obuf += 2;
+		if (++outFrames == maxOutFrames) {
+			mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+			obuf += outFrames * 2;
+			outPtr = outBuf;
+			outFrames = 0;
+		}
 	}
+
+	mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+	obuf += outFrames * 2;
 	return (obuf - ostart) / 2;
 }
 
@@ -172,6 +179,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** interpolated frames, waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** fractional position of the output stream in input stream unit */
 	frac_t opos;
 
@@ -227,7 +237,12 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
+	// The interpolated frames are gathered in outBuf, and mixed a block at a time
+	const int maxOutFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_sample_t *outPtr = outBuf;
+	int outFrames = 0;
+
+	while (obuf + outFrames * 2 < oend) {
 
 		// read enough input samples so that opos < 0
 		while ((frac_t)FRAC_ONE_LOW <= opos) {
@@ -235,8 +250,10 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			if (inLen == 0) {
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+				if (inLen <= 0) {
+					mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+					return (obuf - ostart) / 2 + outFrames;
+				}
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -250,26 +267,26 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 
 		// Loop as long as the outpos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
+		while (opos < (frac_t)FRAC_ONE_LOW && obuf + outFrames * 2 < oend) {
 			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+			*outPtr++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (stereo)
+				*outPtr++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
 			// Increment output position
 			opos += opos_inc;
+
+			if (++outFrames == maxOutFrames) {
+				mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+				obuf += outFrames * 2;
+				outPtr = outBuf;
+				outFrames = 0;
+			}
 		}
 	}
+
+	mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+	obuf += outFrames * 2;
 	return (obuf - ostart) / 2;
 }
 
@@ -293,11 +310,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -313,23 +327,13 @@ public:
 
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
+		if ((int)len <= 0)
+			return 0;
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		int frames = len / (stereo ? 2 : 1);
+		mixSamples<stereo, reverseStereo>(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -80,6 +80,53 @@ public:
 
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
 
+/**
+ * Filter tables of a polyphase windowed sinc rate converter, for a given
+ * pair of input and output rates. A filter bank can be shared by any number
+ * of converters, but must outlive them.
+ */
+class SincFilterBank {
+public:
+	~SincFilterBank();
+
+	/**
+	 * Compute the filter tables for converting from inrate to outrate.
+	 *
+	 * @return the filter bank, or 0 if the ratio between the two rates
+	 *         would need too many filter phases
+	 */
+	static SincFilterBank *create(st_rate_t inrate, st_rate_t outrate);
+
+	st_rate_t getInputRate() const { return _inrate; }
+	st_rate_t getOutputRate() const { return _outrate; }
+
+	/** Number of filter phases, one per output position between two input samples */
+	int getPhases() const { return _phases; }
+
+	/** Number of input samples consumed after each output phase wraps */
+	int getStep() const { return _step; }
+
+	/** Number of taps of each phase, always a multiple of 8 */
+	int getTaps() const { return _taps; }
+
+	/** The coefficients of a phase, in 2.14 fixed point */
+	const int16 *getCoefficients(int phase) const { return _coefficients + phase * _taps; }
+
+private:
+	SincFilterBank(st_rate_t inrate, st_rate_t outrate, int phases, int step, int taps);
+
+	st_rate_t _inrate, _outrate;
+	int _phases, _step, _taps;
+	int16 *_coefficients;
+};
+
+/**
+ * Create a rate converter using a polyphase windowed sinc filter. It has
+ * much less aliasing than the converters returned by makeRateConverter(),
+ * at a slightly higher CPU cost.
+ */
+RateConverter *makeSincRateConverter(const SincFilterBank &filters, bool stereo, bool reverseStereo = false);
+
 } // End of namespace Audio
 
 #endif
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "common/scummsys.h"
+
+#if !defined(OUTPUT_UNSIGNED_AUDIO) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AUDIO_RATE_SSE2
+#include <emmintrin.h>
+#elif !defined(OUTPUT_UNSIGNED_AUDIO) && defined(SCUMM_LITTLE_ENDIAN) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define AUDIO_RATE_NEON
+#include <arm_neon.h>
+#endif
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+/**
+ * Internal helpers shared by the rate converter implementations.
+ */
+
+namespace Audio {
+
+/**
+ * The size of the intermediate input cache. Bigger values may increase
+ * performance, but only until some point (depends largely on cache size,
+ * target processor and various other factors), at which it will decrease
+ * again.
+ */
+#define INTERMEDIATE_BUFFER_SIZE 512
+
+/**
+ * The vectorized kernels divide by kMaxMixerVolume using a shift.
+ */
+enum {
+	MIXER_VOLUME_SHIFT = 8
+};
+
+#if defined(AUDIO_RATE_SSE2)
+
+typedef __m128i SampleVec;
+
+static inline SampleVec vSetVolumes(st_volume_t even, st_volume_t odd) {
+	return _mm_set1_epi32((int)(((uint32)odd << 16) | even));
+}
+
+static inline SampleVec vLoad(const st_sample_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+static inline void vStore(st_sample_t *p, SampleVec v) { _mm_storeu_si128((__m128i *)p, v); }
+static inline SampleVec vAddSaturate(SampleVec a, SampleVec b) { return _mm_adds_epi16(a, b); }
+static inline SampleVec vSwapPairs(SampleVec a) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xB1), 0xB1); }
+static inline SampleVec vDuplicateLow(SampleVec a) { return _mm_unpacklo_epi16(a, a); }
+static inline SampleVec vDuplicateHigh(SampleVec a) { return _mm_unpackhi_epi16(a, a); }
+
+// Same as (sample * vol) / kMaxMixerVolume for each lane, rounding towards zero
+static inline SampleVec vScale(SampleVec samples, SampleVec vol) {
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	__m128i lo = _mm_mullo_epi16(samples, vol);
+	__m128i hi = _mm_mulhi_epi16(samples, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), MIXER_VOLUME_SHIFT);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), MIXER_VOLUME_SHIFT);
+	return _mm_packs_epi32(p0, p1);
+}
+
+#elif defined(AUDIO_RATE_NEON)
+
+typedef int16x8_t SampleVec;
+
+static inline SampleVec vSetVolumes(st_volume_t even, st_volume_t odd) {
+	return vreinterpretq_s16_u32(vdupq_n_u32(((uint32)odd << 16) | even));
+}
+
+static inline SampleVec vLoad(const st_sample_t *p) { return vld1q_s16(p); }
+static inline void vStore(st_sample_t *p, SampleVec v) { vst1q_s16(p, v); }
+static inline SampleVec vAddSaturate(SampleVec a, SampleVec b) { return vqaddq_s16(a, b); }
+static inline SampleVec vSwapPairs(SampleVec a) { return vrev32q_s16(a); }
+static inline SampleVec vDuplicateLow(SampleVec a) { return vzipq_s16(a, a).val[0]; }
+static inline SampleVec vDuplicateHigh(SampleVec a) { return vzipq_s16(a, a).val[1]; }
+
+// Same as (sample * vol) / kMaxMixerVolume for each lane, rounding towards zero
+static inline SampleVec vScale(SampleVec samples, SampleVec vol) {
+	const int32x4_t bias = vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	int32x4_t p0 = vmull_s16(vget_low_s16(samples), vget_low_s16(vol));
+	int32x4_t p1 = vmull_s16(vget_high_s16(samples), vget_high_s16(vol));
+
+	p0 = vshrq_n_s32(vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), bias)), MIXER_VOLUME_SHIFT);
+	p1 = vshrq_n_s32(vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), bias)), MIXER_VOLUME_SHIFT);
+	return vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+}
+
+#endif
+
+/**
+ * Scale a block of frames by the channel volumes and add them to the
+ * interleaved stereo output buffer, saturating the result.
+ *
+ * @param obuf   the output buffer, holding two samples per frame
+ * @param in     the input samples, one or two per frame depending on stereo
+ * @param frames the number of frames to mix
+ */
+template<bool stereo, bool reverseStereo>
+static void mixSamples(st_sample_t *obuf, const st_sample_t *in, int frames, st_volume_t vol_l, st_volume_t vol_r) {
+	int i = 0;
+
+#if defined(AUDIO_RATE_SSE2) || defined(AUDIO_RATE_NEON)
+	// The output lanes alternate between the left and right channels
+	const SampleVec vol = reverseStereo ? vSetVolumes(vol_r, vol_l) : vSetVolumes(vol_l, vol_r);
+
+	if (stereo) {
+		for (; i + 4 <= frames; i += 4) {
+			SampleVec samples = vLoad(in + i * 2);
+			if (reverseStereo)
+				samples = vSwapPairs(samples);
+
+			vStore(obuf + i * 2, vAddSaturate(vLoad(obuf + i * 2), vScale(samples, vol)));
+		}
+	} else {
+		for (; i + 8 <= frames; i += 8) {
+			SampleVec samples = vLoad(in + i);
+
+			vStore(obuf + i * 2, vAddSaturate(vLoad(obuf + i * 2), vScale(vDuplicateLow(samples), vol)));
+			vStore(obuf + i * 2 + 8, vAddSaturate(vLoad(obuf + i * 2 + 8), vScale(vDuplicateHigh(samples), vol)));
+		}
+	}
+#endif
+
+	for (; i < frames; i++) {
+		st_sample_t out0, out1;
+		out0 = (stereo ? in[i * 2] : in[i]);
+		out1 = (stereo ? in[i * 2 + 1] : out0);
+
+		// output left channel
+		clampedAdd(obuf[i * 2 + reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[i * 2 + (reverseStereo ^ 1)], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	}
+}
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,340 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#include <math.h>
+
+namespace Audio {
+
+enum {
+	/** Number of fractional bits of the filter coefficients */
+	SINC_COEF_BITS = 14,
+
+	/** Filters needing more phases than this are not supported */
+	SINC_MAX_PHASES = 1024,
+
+	/** Number of taps per phase when upsampling */
+	SINC_BASE_TAPS = 16,
+
+	/** Upper bound on the number of taps per phase when downsampling */
+	SINC_MAX_TAPS = 64
+};
+
+static uint32 greatestCommonDivisor(uint32 a, uint32 b) {
+	while (b) {
+		uint32 t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+SincFilterBank::SincFilterBank(st_rate_t inrate, st_rate_t outrate, int phases, int step, int taps) :
+		_inrate(inrate), _outrate(outrate), _phases(phases), _step(step), _taps(taps) {
+	_coefficients = new int16[phases * taps];
+
+	// Cut off a bit below the lowest of the two Nyquist frequencies
+	const double cutoff = 0.9 * MIN<double>(1.0, (double)phases / step);
+	const int center = taps / 2 - 1;
+
+	double *phase = new double[taps];
+	for (int p = 0; p < phases; p++) {
+		// Distance from the output position to each of the input samples
+		// covered by the filter, in input samples
+		double sum = 0.0;
+		for (int j = 0; j < taps; j++) {
+			const double d = j - center - (double)p / phases;
+			const double x = cutoff * d * M_PI;
+			const double sinc = (x == 0.0) ? 1.0 : sin(x) / x;
+
+			// Blackman window over the span of the filter
+			const double w = (d + taps / 2.0) / taps;
+			const double window = 0.42 - 0.5 * cos(2 * M_PI * w) + 0.08 * cos(4 * M_PI * w);
+
+			phase[j] = sinc * window;
+			sum += phase[j];
+		}
+
+		// Normalize to unity gain, and put the rounding error on the largest
+		// coefficient so that constant signals are preserved exactly
+		int16 *coefs = _coefficients + p * taps;
+		int total = 0, largest = 0;
+		for (int j = 0; j < taps; j++) {
+			coefs[j] = (int16)floor(phase[j] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[j];
+			if (ABS(coefs[j]) > ABS(coefs[largest]))
+				largest = j;
+		}
+		coefs[largest] += (1 << SINC_COEF_BITS) - total;
+	}
+	delete[] phase;
+}
+
+SincFilterBank::~SincFilterBank() {
+	delete[] _coefficients;
+}
+
+SincFilterBank *SincFilterBank::create(st_rate_t inrate, st_rate_t outrate) {
+	if (inrate == 0 || outrate == 0)
+		return 0;
+
+	const uint32 gcd = greatestCommonDivisor(inrate, outrate);
+	const int phases = outrate / gcd;
+	const int step = inrate / gcd;
+
+	if (phases > SINC_MAX_PHASES)
+		return 0;
+
+	// Widen the filter when downsampling, as the cutoff frequency goes down
+	int taps = SINC_BASE_TAPS;
+	if (step > phases)
+		taps = MIN<int>(SINC_MAX_TAPS, ((SINC_BASE_TAPS * step / phases) + 7) & ~7);
+
+	return new SincFilterBank(inrate, outrate, phases, step, taps);
+}
+
+/**
+ * Dot product of samples and filter coefficients, taps must be a multiple of 8.
+ */
+static inline st_sample_t applyFilter(const st_sample_t *samples, const int16 *coefs, int taps) {
+	int32 sum;
+
+#if defined(AUDIO_RATE_SSE2)
+	__m128i acc = _mm_setzero_si128();
+	for (int j = 0; j < taps; j += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(samples + j)), _mm_loadu_si128((const __m128i *)(coefs + j))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+	sum = _mm_cvtsi128_si32(acc);
+#elif defined(AUDIO_RATE_NEON)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (int j = 0; j < taps; j += 8) {
+		int16x8_t x = vld1q_s16(samples + j);
+		int16x8_t h = vld1q_s16(coefs + j);
+		acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(h));
+		acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(h));
+	}
+	int32x2_t pair = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	sum = vget_lane_s32(vpadd_s32(pair, pair), 0);
+#else
+	sum = 0;
+	for (int j = 0; j < taps; j++)
+		sum += samples[j] * coefs[j];
+#endif
+
+	sum = (sum + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+	return (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+/**
+ * Same as applyFilter for the two channels of a stereo stream at once.
+ */
+static inline void applyFilterStereo(const st_sample_t *left, const st_sample_t *right, const int16 *coefs, int taps, st_sample_t *out) {
+#if defined(AUDIO_RATE_SSE2)
+	__m128i accL = _mm_setzero_si128();
+	__m128i accR = _mm_setzero_si128();
+	for (int j = 0; j < taps; j += 8) {
+		__m128i h = _mm_loadu_si128((const __m128i *)(coefs + j));
+		accL = _mm_add_epi32(accL, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(left + j)), h));
+		accR = _mm_add_epi32(accR, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(right + j)), h));
+	}
+
+	// Sum the lanes of both accumulators, the left sum ends up in lane 0 and the right one in lane 1
+	__m128i sum = _mm_add_epi32(_mm_unpacklo_epi32(accL, accR), _mm_unpackhi_epi32(accL, accR));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << (SINC_COEF_BITS - 1))), SINC_COEF_BITS);
+	sum = _mm_packs_epi32(sum, sum);
+
+	out[0] = (st_sample_t)_mm_extract_epi16(sum, 0);
+	out[1] = (st_sample_t)_mm_extract_epi16(sum, 1);
+#else
+	out[0] = applyFilter(left, coefs, taps);
+	out[1] = applyFilter(right, coefs, taps);
+#endif
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed sinc filter.
+ *
+ * Output frame k is at position k * step / phases in the input stream. The
+ * filter phase (k * step) % phases is applied to the input samples around
+ * that position. The input channels are kept in separate history buffers,
+ * so that the filters run over contiguous samples.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	const SincFilterBank &_filters;
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** filtered frames, waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** input samples of each channel, the filter window starts at histPos */
+	st_sample_t *hist[2];
+	int histSize;
+	int histLen;
+	int histPos;
+
+	/** filter phase of the next output frame */
+	int phase;
+
+	bool fillHistory(AudioStream &input);
+
+public:
+	SincRateConverter(const SincFilterBank &filters);
+	~SincRateConverter();
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(const SincFilterBank &filters) : _filters(filters) {
+	histSize = filters.getTaps() + INTERMEDIATE_BUFFER_SIZE;
+	hist[0] = new st_sample_t[histSize];
+	hist[1] = stereo ? new st_sample_t[histSize] : 0;
+
+	// Center the filter of the first output frame on the first input frame
+	histLen = filters.getTaps() / 2 - 1;
+	histPos = 0;
+	memset(hist[0], 0, histLen * sizeof(st_sample_t));
+	if (stereo)
+		memset(hist[1], 0, histLen * sizeof(st_sample_t));
+
+	phase = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] hist[0];
+	delete[] hist[1];
+}
+
+/*
+ * Move the samples still needed to the start of the history buffers, and
+ * append new input samples after them.
+ * Return false when the input stream has no more data.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::fillHistory(AudioStream &input) {
+	histLen -= histPos;
+	memmove(hist[0], hist[0] + histPos, histLen * sizeof(st_sample_t));
+	if (stereo)
+		memmove(hist[1], hist[1] + histPos, histLen * sizeof(st_sample_t));
+	histPos = 0;
+
+	int frames = MIN<int>(histSize - histLen, ARRAYSIZE(inBuf) / (stereo ? 2 : 1));
+	int len = input.readBuffer(inBuf, frames * (stereo ? 2 : 1));
+	if (len <= 0)
+		return false;
+
+	if (stereo) {
+		for (int i = 0; i < len / 2; i++) {
+			hist[0][histLen + i] = inBuf[i * 2];
+			hist[1][histLen + i] = inBuf[i * 2 + 1];
+		}
+		histLen += len / 2;
+	} else {
+		memcpy(hist[0] + histLen, inBuf, len * sizeof(st_sample_t));
+		histLen += len;
+	}
+
+	return true;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const int taps = _filters.getTaps();
+	const int phases = _filters.getPhases();
+	const int step = _filters.getStep();
+
+	// The filtered frames are gathered in outBuf, and mixed a block at a time
+	const int maxOutFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_sample_t *outPtr = outBuf;
+	int outFrames = 0;
+
+	while (obuf + outFrames * 2 < oend) {
+		// read enough input samples to cover the filter
+		while (histPos + taps > histLen) {
+			if (!fillHistory(input)) {
+				mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+				return (obuf - ostart) / 2 + outFrames;
+			}
+		}
+
+		const int16 *coefs = _filters.getCoefficients(phase);
+		if (stereo) {
+			applyFilterStereo(hist[0] + histPos, hist[1] + histPos, coefs, taps, outPtr);
+			outPtr += 2;
+		} else {
+			*outPtr++ = applyFilter(hist[0] + histPos, coefs, taps);
+		}
+
+		// Increment output position
+		phase += step;
+		while (phase >= phases) {
+			phase -= phases;
+			histPos++;
+		}
+
+		if (++outFrames == maxOutFrames) {
+			mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+			obuf += outFrames * 2;
+			outPtr = outBuf;
+			outFrames = 0;
+		}
+	}
+
+	mixSamples<stereo, reverseStereo>(obuf, outBuf, outFrames, vol_l, vol_r);
+	obuf += outFrames * 2;
+	return (obuf - ostart) / 2;
+}
+
+RateConverter *makeSincRateConverter(const SincFilterBank &filters, bool stereo, bool reverseStereo) {
+	if (stereo) {
+		if (reverseStereo)
+			return new SincRateConverter<true, true>(filters);
+		else
+			return new SincRateConverter<true, false>(filters);
+	} else
+		return new SincRateConverter<false, false>(filters);
+}
+
+} // End of namespace Audio
@@ -183,6 +183,14 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Maps the file referred by this node in memory. Backends without
+	 * support for memory mapped files keep the default implementation.
+	 *
+	 * @return pointer to the mapping, 0 in case of a failure
+	 */
+	virtual Common::MappedFile *createMappedFile() { return 0; }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
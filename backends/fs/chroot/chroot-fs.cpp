@@ -104,6 +104,10 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::MappedFile *ChRootFilesystemNode::createMappedFile() {
+	return _realNode->createMappedFile();
+}
+
 Common::WriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
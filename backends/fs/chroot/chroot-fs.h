@@ -48,6 +48,7 @@ public:
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::MappedFile *createMappedFile();
 	virtual Common::WriteStream *createWriteStream();
 
 private:
@@ -33,9 +33,12 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
+#include "common/mappedfile.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <dirent.h>
 #include <stdio.h>
 
@@ -247,6 +250,46 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
+namespace {
+
+class POSIXMappedFile : public Common::MappedFile {
+public:
+	POSIXMappedFile(void *data, uint32 size) : _data(data), _size(size) {}
+	~POSIXMappedFile() { munmap(_data, _size); }
+
+	const byte *getData() const { return (const byte *)_data; }
+	uint32 size() const { return _size; }
+
+private:
+	void *_data;
+	uint32 _size;
+};
+
+} // End of anonymous namespace
+
+Common::MappedFile *POSIXFilesystemNode::createMappedFile() {
+	int fd = open(_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || (uint64)st.st_size > 0xFFFFFFFF) {
+		close(fd);
+		return 0;
+	}
+
+	uint32 size = (uint32)st.st_size;
+	void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping holds its own reference on the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return 0;
+
+	return new POSIXMappedFile(data, size);
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return StdioStream::makeFromPath(getPath(), true);
 }
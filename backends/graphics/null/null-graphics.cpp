@@ -0,0 +1,99 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/null/null-graphics.h"
+
+#include "common/rect.h"
+#include "common/textconsole.h"
+#include "graphics/pixelbuffer.h"
+
+static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
+		{0, 0, 0}
+};
+
+// The format of a usual 32 bits desktop screen
+static const Graphics::PixelFormat s_screenFormat(4, 8, 8, 8, 0, 16, 8, 0, 0);
+
+NullGraphicsManager::NullGraphicsManager() :
+	_overlayVisible(false),
+	_screenChangeCount(0) {
+}
+
+NullGraphicsManager::~NullGraphicsManager() {
+	_screen.free();
+	_overlay.free();
+}
+
+const OSystem::GraphicsMode *NullGraphicsManager::getSupportedGraphicsModes() const {
+	return s_supportedGraphicsModes;
+}
+
+#ifdef USE_RGB_COLOR
+Common::List<Graphics::PixelFormat> NullGraphicsManager::getSupportedFormats() const {
+	Common::List<Graphics::PixelFormat> formats;
+	formats.push_back(s_screenFormat);
+	return formats;
+}
+#endif
+
+void NullGraphicsManager::setupScreen(uint screenW, uint screenH, bool fullscreen, bool accel3d) {
+	if (accel3d)
+		error("The null backend only supports the software renderer");
+
+	_screen.free();
+	_overlay.free();
+	_screen.create(screenW, screenH, s_screenFormat);
+	_overlay.create(screenW, screenH, s_screenFormat);
+
+	_screenChangeCount++;
+}
+
+Graphics::PixelBuffer NullGraphicsManager::getScreenPixelBuffer() {
+	return Graphics::PixelBuffer(_screen.format, (byte *)_screen.getPixels());
+}
+
+void NullGraphicsManager::clearOverlay() {
+	if (!_overlayVisible || !_overlay.getPixels())
+		return;
+
+	_overlay.copyRectToSurface(_screen, 0, 0, Common::Rect(_screen.w, _screen.h));
+}
+
+void NullGraphicsManager::grabOverlay(void *buf, int pitch) {
+	const byte *src = (const byte *)_overlay.getPixels();
+	byte *dst = (byte *)buf;
+	for (int y = 0; y < _overlay.h; y++) {
+		memcpy(dst, src, _overlay.w * _overlay.format.bytesPerPixel);
+		src += _overlay.pitch;
+		dst += pitch;
+	}
+}
+
+void NullGraphicsManager::copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {
+	Common::Rect rect(x, y, x + w, y + h);
+	rect.clip(_overlay.w, _overlay.h);
+	if (rect.isEmpty())
+		return;
+
+	const byte *src = (const byte *)buf + (rect.top - y) * pitch + (rect.left - x) * _overlay.format.bytesPerPixel;
+	_overlay.copyRectToSurface(src, pitch, rect.left, rect.top, rect.width(), rect.height());
+}
@@ -0,0 +1,103 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_NULL_H
+#define BACKENDS_GRAPHICS_NULL_H
+
+#include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
+
+/**
+ * Null graphics manager
+ *
+ * The game and the overlay are drawn into memory surfaces which are never
+ * displayed, so that the software renderer does all of its work headless.
+ */
+class NullGraphicsManager : public GraphicsManager {
+public:
+	NullGraphicsManager();
+	virtual ~NullGraphicsManager();
+
+	// GraphicsManager API - Features
+	virtual bool hasFeature(OSystem::Feature f) { return false; }
+	virtual void setFeatureState(OSystem::Feature f, bool enable) {}
+	virtual bool getFeatureState(OSystem::Feature f) { return false; }
+
+	// GraphicsManager API - Graphics mode
+	virtual const OSystem::GraphicsMode *getSupportedGraphicsModes() const;
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return true; }
+	virtual void resetGraphicsScale() {}
+	virtual int getGraphicsMode() const { return 0; }
+#ifdef USE_RGB_COLOR
+	virtual Graphics::PixelFormat getScreenFormat() const { return _screen.format; }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const;
+#endif
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	virtual int getScreenChangeID() const { return _screenChangeCount; }
+
+	virtual void beginGFXTransaction() {}
+	virtual OSystem::TransactionError endGFXTransaction() { return OSystem::kTransactionSuccess; }
+
+	virtual void setupScreen(uint screenW, uint screenH, bool fullscreen, bool accel3d); // ResidualVM specific method
+	virtual Graphics::PixelBuffer getScreenPixelBuffer(); // ResidualVM specific method
+	virtual void suggestSideTextures(Graphics::Surface *left, Graphics::Surface *right) {} // ResidualVM specific method
+
+	// GraphicsManager API - Draw methods
+	virtual int16 getHeight() { return _screen.h; }
+	virtual int16 getWidth() { return _screen.w; }
+	virtual void setPalette(const byte *colors, uint start, uint num) {}
+	virtual void grabPalette(byte *colors, uint start, uint num) {}
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return NULL; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void setFocusRectangle(const Common::Rect& rect) {}
+	virtual void clearFocusRectangle() {}
+
+	// GraphicsManager API - Overlay
+	virtual void showOverlay() { _overlayVisible = true; }
+	virtual void hideOverlay() { _overlayVisible = false; }
+	virtual Graphics::PixelFormat getOverlayFormat() const { return _overlay.format; }
+	virtual void clearOverlay();
+	virtual void grabOverlay(void *buf, int pitch);
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h);
+	virtual int16 getOverlayHeight() { return _overlay.h; }
+	virtual int16 getOverlayWidth() { return _overlay.w; }
+
+	// GraphicsManager API - Mouse
+	virtual bool showMouse(bool visible) { return !visible; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	virtual void setCursorPalette(const byte *colors, uint start, uint num) {}
+	virtual bool lockMouse(bool lock) { return false; } // ResidualVM specific method
+
+private:
+	Graphics::Surface _screen;
+	Graphics::Surface _overlay;
+	bool _overlayVisible;
+	int _screenChangeCount;
+};
+
+#endif
@@ -122,6 +122,9 @@ void SdlMixerManager::init() {
 	assert(_mixer);
 	_mixer->setReady(true);
 
+	if (ConfMan.hasKey("resampler") && ConfMan.get("resampler") == "sinc")
+		_mixer->setResamplingQuality(Audio::Mixer::kResamplingSinc);
+
 	startAudio();
 }
 
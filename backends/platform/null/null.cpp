@@ -0,0 +1,385 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_FILE
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+#define FORBIDDEN_SYMBOL_EXCEPTION_fputs
+#define FORBIDDEN_SYMBOL_EXCEPTION_fflush
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
+#include "backends/modular-backend.h"
+#include "base/main.h"
+
+#if defined(USE_NULL_DRIVER)
+#include "backends/events/default/default-events.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mutex/null/null-mutex.h"
+#include "backends/saves/default/default-saves.h"
+#include "backends/timer/default/default-timer.h"
+#include "audio/mixer_intern.h"
+#include "common/config-manager.h"
+#include "common/framestats.h"
+#include "common/recorderfile.h"
+#include "common/scummsys.h"
+#include "common/textconsole.h"
+
+#include <time.h>
+
+#ifdef POSIX
+#include "backends/fs/posix/posix-fs-factory.h"
+#include "backends/plugins/posix/posix-provider.h"
+#include "backends/saves/posix/posix-saves.h"
+#include "backends/workerpool/posix/posix-workerpool.h"
+
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+/**
+ * Backend without any display, input or sound output.
+ *
+ * The time is virtual: it only goes forward when the game waits or updates
+ * the screen, in fixed steps driving the timers and the mixer. This makes a
+ * game run the same way whatever the speed of the host, as fast as it can
+ * render its frames, which are timed with the real clock. This is used to
+ * benchmark the software renderer, --benchmark-frames stops the game after
+ * the given number of frames. --benchmark-record replays the events of a
+ * recording at their recorded times, and stops the game at its end.
+ */
+class OSystem_NULL : public ModularBackend, Common::EventSource {
+public:
+	OSystem_NULL();
+	virtual ~OSystem_NULL();
+
+	virtual void initBackend();
+
+	virtual bool pollEvent(Common::Event &event);
+
+	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
+	virtual void delayMillis(uint msecs);
+	virtual void getTimeAndDate(TimeDate &t) const;
+
+	virtual void launcherInitSize(uint w, uint h);
+	virtual void updateScreen();
+
+	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+	/** Report the frame times and the memory usage, if any frame was drawn. */
+	void reportBenchmark();
+
+protected:
+	virtual Common::EventSource *getDefaultEventSource() { return this; }
+
+private:
+	enum {
+		kSampleRate = 22050,
+		kTimerStep = 10000,			// in microseconds
+		kFrameDuration = 1000000 / 60	// in microseconds
+	};
+
+	/** Move the virtual time forward, firing the timers and mixing the sound on the way. */
+	void advanceTime(uint32 micros);
+
+	/** Return the next event of the recording, if its time has come. */
+	bool pollRecordedEvent(Common::Event &event);
+
+	uint64 _virtualTime;
+	uint64 _mixedSamples;
+
+	uint64 _lastFrameTime;
+	int _benchmarkFrames;
+	bool _quitRequested;
+	Common::FrameStatistics _frameStatistics;
+
+	Common::PlaybackFile *_playbackFile;
+	Common::RecorderEvent _nextRecordedEvent;
+	bool _playbackStarted;
+	uint32 _playbackStart;
+};
+
+/** Return the real time in microseconds, or 0 if there is no clock. */
+static uint64 getRealMicros() {
+#ifdef POSIX
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	return 0;
+#endif
+}
+
+/** Return the peak resident memory in kilobytes, or -1 if it is unknown. */
+static long getPeakMemoryUsage() {
+#ifdef POSIX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		// In kilobytes on Linux, in bytes on Mac OS X
+#ifdef MACOSX
+		return usage.ru_maxrss / 1024;
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return -1;
+}
+
+OSystem_NULL::OSystem_NULL() :
+	_virtualTime(0),
+	_mixedSamples(0),
+	_lastFrameTime(0),
+	_benchmarkFrames(0),
+	_quitRequested(false),
+	_playbackFile(0),
+	_playbackStarted(false),
+	_playbackStart(0) {
+#ifdef POSIX
+	_fsFactory = new POSIXFilesystemFactory();
+#else
+	#error Unknown and unsupported FS backend
+#endif
+}
+
+OSystem_NULL::~OSystem_NULL() {
+	delete _playbackFile;
+	_playbackFile = 0;
+
+	// The managers using mutexes must be deleted while the mutex manager
+	// is still there, which is not the case in the OSystem destructor.
+	delete _mixer;
+	_mixer = 0;
+	delete _timerManager;
+	_timerManager = 0;
+	delete _eventManager;
+	_eventManager = 0;
+	delete _savefileManager;
+	_savefileManager = 0;
+	delete _graphicsManager;
+	_graphicsManager = 0;
+	delete _mutexManager;
+	_mutexManager = 0;
+}
+
+void OSystem_NULL::initBackend() {
+	_mutexManager = new NullMutexManager();
+	_timerManager = new DefaultTimerManager();
+	_graphicsManager = new NullGraphicsManager();
+#ifdef POSIX
+	_savefileManager = new POSIXSaveFileManager();
+
+	// Create the worker threads, if more than one is asked for
+	if (ConfMan.getInt("worker_threads") > 1)
+		_workerPool = new POSIXWorkerPool(ConfMan.getInt("worker_threads"));
+#else
+	_savefileManager = new DefaultSaveFileManager();
+#endif
+
+	// The mixer is pumped by advanceTime(), and its output thrown away
+	_mixer = new Audio::MixerImpl(this, kSampleRate);
+	((Audio::MixerImpl *)_mixer)->setReady(true);
+
+	_benchmarkFrames = ConfMan.getInt("benchmark_frames");
+
+	Common::String recordFile = ConfMan.get("benchmark_record");
+	if (!recordFile.empty()) {
+		_playbackFile = new Common::PlaybackFile();
+		if (!_playbackFile->openRead(recordFile))
+			error("Could not open the recording '%s'", recordFile.c_str());
+		_nextRecordedEvent = _playbackFile->getNextEvent();
+	}
+
+	// Note that the event manager is created by BaseBackend
+	ModularBackend::initBackend();
+}
+
+bool OSystem_NULL::pollEvent(Common::Event &event) {
+	if (_playbackFile && !_quitRequested && pollRecordedEvent(event))
+		return true;
+
+	if (_quitRequested) {
+		_quitRequested = false;
+		event.type = Common::EVENT_QUIT;
+		return true;
+	}
+
+	return false;
+}
+
+bool OSystem_NULL::pollRecordedEvent(Common::Event &event) {
+	// The recorded times are counted from the first poll
+	if (!_playbackStarted) {
+		_playbackStart = getMillis();
+		_playbackStarted = true;
+	}
+
+	// The timer records are only used by the event recorder to replay the
+	// time itself, here the time is always virtual
+	while (_nextRecordedEvent.recordedtype == Common::kRecorderEventTypeTimer)
+		_nextRecordedEvent = _playbackFile->getNextEvent();
+
+	// Quit once at the end of the recording
+	if (_nextRecordedEvent.type == Common::EVENT_INVALID) {
+		delete _playbackFile;
+		_playbackFile = 0;
+		_quitRequested = true;
+		return false;
+	}
+
+	if (_nextRecordedEvent.time > getMillis() - _playbackStart)
+		return false;
+
+	event = _nextRecordedEvent;
+	_nextRecordedEvent = _playbackFile->getNextEvent();
+	return true;
+}
+
+uint32 OSystem_NULL::getMillis(bool skipRecord) {
+	return (uint32)(_virtualTime / 1000);
+}
+
+uint64 OSystem_NULL::getMicros() {
+	// The profiler measures the time really spent, not the virtual time
+#ifdef POSIX
+	return getRealMicros();
+#else
+	return ModularBackend::getMicros();
+#endif
+}
+
+void OSystem_NULL::delayMillis(uint msecs) {
+	advanceTime(msecs * 1000);
+}
+
+void OSystem_NULL::getTimeAndDate(TimeDate &td) const {
+	time_t curTime = time(0);
+	struct tm t = *localtime(&curTime);
+	td.tm_sec = t.tm_sec;
+	td.tm_min = t.tm_min;
+	td.tm_hour = t.tm_hour;
+	td.tm_mday = t.tm_mday;
+	td.tm_mon = t.tm_mon;
+	td.tm_year = t.tm_year;
+	td.tm_wday = t.tm_wday;
+}
+
+void OSystem_NULL::launcherInitSize(uint w, uint h) {
+	setupScreen(w, h, false, false);
+}
+
+void OSystem_NULL::updateScreen() {
+	ModularBackend::updateScreen();
+
+	// The frame times only include the time spent by the game and the
+	// renderer, as the delays between the frames are not waited for.
+	// The frames drawn after the quit request are not counted.
+	bool benchmarkDone = _benchmarkFrames > 0 && (int)_frameStatistics.getFrameCount() >= _benchmarkFrames;
+	uint64 time = getRealMicros();
+	if (_lastFrameTime != 0 && !benchmarkDone) {
+		_frameStatistics.addFrame((uint32)(time - _lastFrameTime));
+		if (_benchmarkFrames > 0 && (int)_frameStatistics.getFrameCount() >= _benchmarkFrames)
+			_quitRequested = true;
+	}
+	_lastFrameTime = time;
+
+	// Every frame takes the same virtual time, whether the game waits for
+	// the next one or not.
+	advanceTime(kFrameDuration);
+}
+
+void OSystem_NULL::advanceTime(uint32 micros) {
+	byte samples[4096];
+
+	while (micros > 0) {
+		uint32 step = MIN<uint32>(micros, kTimerStep);
+		_virtualTime += step;
+		micros -= step;
+
+		// 16 bits stereo samples
+		uint64 sampleCount = _virtualTime * kSampleRate / 1000000;
+		while (_mixedSamples < sampleCount) {
+			uint32 count = MIN<uint64>(sampleCount - _mixedSamples, sizeof(samples) / 4);
+			((Audio::MixerImpl *)_mixer)->mixCallback(samples, count * 4);
+			_mixedSamples += count;
+		}
+
+		((DefaultTimerManager *)_timerManager)->handler();
+	}
+}
+
+void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
+	FILE *output = 0;
+
+	if (type == LogMessageType::kInfo || type == LogMessageType::kDebug)
+		output = stdout;
+	else
+		output = stderr;
+
+	fputs(message, output);
+	fflush(output);
+}
+
+void OSystem_NULL::reportBenchmark() {
+	if (_frameStatistics.getFrameCount() == 0)
+		return;
+
+	// Printed whatever the debug level is
+	Common::String report = Common::String::format(
+	      "benchmark:frames=%u time=%.3fs fps=%.2f p50=%.2fms p90=%.2fms p99=%.2fms max=%.2fms peak_rss=%ldKB\n",
+	      _frameStatistics.getFrameCount(), _frameStatistics.getTotalTime() / 1000000.0,
+	      _frameStatistics.getFramesPerSecond(),
+	      _frameStatistics.getPercentile(50) / 1000.0, _frameStatistics.getPercentile(90) / 1000.0,
+	      _frameStatistics.getPercentile(99) / 1000.0, _frameStatistics.getPercentile(100) / 1000.0,
+	      getPeakMemoryUsage());
+	fputs(report.c_str(), stdout);
+	fflush(stdout);
+}
+
+OSystem *OSystem_NULL_create() {
+	return new OSystem_NULL();
+}
+
+int main(int argc, char *argv[]) {
+	g_system = OSystem_NULL_create();
+	assert(g_system);
+
+#ifdef DYNAMIC_MODULES
+	PluginManager::instance().addPluginProvider(new POSIXPluginProvider());
+#endif
+
+	// Invoke the actual ScummVM main entry point:
+	int res = scummvm_main(argc, argv);
+
+	((OSystem_NULL *)g_system)->reportBenchmark();
+
+	delete (OSystem_NULL *)g_system;
+	return res;
+}
+
+#else /* USE_NULL_DRIVER */
+
+OSystem *OSystem_NULL_create() {
+	return NULL;
+}
+
+#endif
@@ -34,6 +34,9 @@
 #include "backends/saves/posix/posix-saves.h"
 #include "backends/fs/posix/posix-fs-factory.h"
 #include "backends/taskbar/unity/unity-taskbar.h"
+#include "backends/workerpool/posix/posix-workerpool.h"
+
+#include "common/config-manager.h"
 
 #include <errno.h>
 #include <sys/stat.h>
@@ -64,6 +67,10 @@ void OSystem_POSIX::initBackend() {
 	if (_savefileManager == 0)
 		_savefileManager = new POSIXSaveFileManager();
 
+	// Create the worker threads, if more than one is asked for
+	if (_workerPool == 0 && ConfMan.getInt("worker_threads") > 1)
+		_workerPool = new POSIXWorkerPool(ConfMan.getInt("worker_threads"));
+
 	// Invoke parent implementation of this method
 	OSystem_SDL::initBackend();
 
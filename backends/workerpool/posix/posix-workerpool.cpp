@@ -0,0 +1,155 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// pthread.h includes time.h
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX)
+
+#include "backends/workerpool/posix/posix-workerpool.h"
+
+#include "common/textconsole.h"
+
+POSIXWorkerPool::POSIXWorkerPool(uint workerCount) : _job(nullptr), _data(nullptr), _jobCount(0), _nextJob(0),
+		_busyWorkers(0), _generation(0), _quit(false) {
+	pthread_key_create(&_workerKey, nullptr);
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_jobsAvailable, nullptr);
+	pthread_cond_init(&_jobsDone, nullptr);
+
+	// The thread calling run() is worker 0, so one thread less is needed.
+	for (uint worker = 1; worker < workerCount; worker++) {
+		Thread *thread = new Thread();
+		thread->pool = this;
+		thread->worker = worker;
+		if (pthread_create(&thread->thread, nullptr, threadProc, thread) != 0) {
+			warning("Could not create worker thread %d", worker);
+			delete thread;
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+POSIXWorkerPool::~POSIXWorkerPool() {
+	pthread_mutex_lock(&_mutex);
+	_quit = true;
+	pthread_cond_broadcast(&_jobsAvailable);
+	pthread_mutex_unlock(&_mutex);
+
+	for (uint i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i]->thread, nullptr);
+		delete _threads[i];
+	}
+
+	pthread_cond_destroy(&_jobsDone);
+	pthread_cond_destroy(&_jobsAvailable);
+	pthread_mutex_destroy(&_mutex);
+	pthread_key_delete(_workerKey);
+}
+
+uint POSIXWorkerPool::getWorkerCount() const {
+	return _threads.size() + 1;
+}
+
+uint POSIXWorkerPool::getCurrentWorker() const {
+	// The key is only set by the pool threads, it reads as 0 everywhere else.
+	return (uint)(size_t)pthread_getspecific(_workerKey);
+}
+
+void POSIXWorkerPool::run(Job job, void *data, uint count) {
+	if (_threads.empty()) {
+		for (uint i = 0; i < count; i++) {
+			job(data, i);
+		}
+		return;
+	}
+
+	pthread_mutex_lock(&_mutex);
+	_job = job;
+	_data = data;
+	_jobCount = count;
+	_nextJob = 0;
+	_generation++;
+	pthread_cond_broadcast(&_jobsAvailable);
+	pthread_mutex_unlock(&_mutex);
+
+	runJobs();
+
+	// Every job has been handed out, wait for the ones still running.
+	pthread_mutex_lock(&_mutex);
+	while (_busyWorkers > 0) {
+		pthread_cond_wait(&_jobsDone, &_mutex);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void *POSIXWorkerPool::threadProc(void *thread) {
+	Thread *self = (Thread *)thread;
+	self->pool->workerLoop(self->worker);
+	return nullptr;
+}
+
+void POSIXWorkerPool::workerLoop(uint worker) {
+	pthread_setspecific(_workerKey, (void *)(size_t)worker);
+
+	uint generation = 0;
+	pthread_mutex_lock(&_mutex);
+	while (true) {
+		while (!_quit && _generation == generation) {
+			pthread_cond_wait(&_jobsAvailable, &_mutex);
+		}
+		if (_quit) {
+			break;
+		}
+		generation = _generation;
+
+		_busyWorkers++;
+		pthread_mutex_unlock(&_mutex);
+		runJobs();
+		pthread_mutex_lock(&_mutex);
+		if (--_busyWorkers == 0) {
+			pthread_cond_signal(&_jobsDone);
+		}
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void POSIXWorkerPool::runJobs() {
+	while (true) {
+		pthread_mutex_lock(&_mutex);
+		if (_nextJob >= _jobCount) {
+			pthread_mutex_unlock(&_mutex);
+			return;
+		}
+		uint index = _nextJob++;
+		Job job = _job;
+		void *data = _data;
+		pthread_mutex_unlock(&_mutex);
+
+		job(data, index);
+	}
+}
+
+#endif
@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_WORKERPOOL_POSIX_H
+#define BACKENDS_WORKERPOOL_POSIX_H
+
+#include "common/workerpool.h"
+#include "common/array.h"
+
+#include <pthread.h>
+
+/**
+ * Worker pool based on POSIX threads. The threads wait for jobs between
+ * calls to run(), which hand out the job indices one at a time.
+ */
+class POSIXWorkerPool : public Common::WorkerPool {
+public:
+	/**
+	 * @param workerCount	the number of workers, the thread calling run() included
+	 */
+	POSIXWorkerPool(uint workerCount);
+	virtual ~POSIXWorkerPool();
+
+	virtual uint getWorkerCount() const;
+	virtual uint getCurrentWorker() const;
+	virtual void run(Job job, void *data, uint count);
+
+private:
+	struct Thread {
+		POSIXWorkerPool *pool;
+		uint worker;
+		pthread_t thread;
+	};
+
+	static void *threadProc(void *thread);
+	void workerLoop(uint worker);
+	void runJobs();
+
+	Common::Array<Thread *> _threads;
+	pthread_key_t _workerKey;
+	pthread_mutex_t _mutex;
+	pthread_cond_t _jobsAvailable;
+	pthread_cond_t _jobsDone;
+
+	Job _job;
+	void *_data;
+	uint _jobCount;
+	uint _nextJob;
+	uint _busyWorkers;
+	uint _generation;
+	bool _quit;
+};
+
+#endif
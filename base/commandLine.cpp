@@ -118,6 +118,14 @@ static const char HELP_STRING[] =
 	"  --show-fps               Set the turn on display FPS info\n"
 	"  --no-show-fps            Set the turn off display FPS info\n"
 	"  --renderer=RENDERER      Select renderer (software, opengl, opengl_shaders)\n"
+	"  --worker-threads=NUM     Number of threads used by the software renderer\n"
+	"                           (default: 1)\n"
+#ifdef USE_NULL_DRIVER
+	"  --benchmark-frames=NUM   Quit after NUM frames, and report the frame times and\n"
+	"                           the memory usage\n"
+	"  --benchmark-record=FILE  Replay the events of the recording FILE, from the\n"
+	"                           save path, and quit at its end\n"
+#endif
 	"  --aspect-ratio           Enable aspect ratio correction\n"
 #ifdef ENABLE_EVENTRECORDER
 	"  --record-mode=MODE       Specify record mode for event recorder (record, playback,\n"
@@ -205,6 +213,11 @@ void registerDefaults() {
 	ConfMan.registerDefault("joystick_num", -1);
 	ConfMan.registerDefault("confirm_exit", false);
 	ConfMan.registerDefault("disable_sdl_parachute", false);
+	ConfMan.registerDefault("worker_threads", 1);
+#ifdef USE_NULL_DRIVER
+	ConfMan.registerDefault("benchmark_frames", 0);
+	ConfMan.registerDefault("benchmark_record", "");
+#endif
 
 	ConfMan.registerDefault("disable_display", false);
 	ConfMan.registerDefault("record_mode", "none");
@@ -496,6 +509,17 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 					usage("Unrecognized renderer type '%s'", option);
 			END_OPTION
 
+			DO_LONG_OPTION_INT("worker-threads")
+			END_OPTION
+
+#ifdef USE_NULL_DRIVER
+			DO_LONG_OPTION_INT("benchmark-frames")
+			END_OPTION
+
+			DO_LONG_OPTION("benchmark-record")
+			END_OPTION
+#endif
+
 			DO_LONG_OPTION_BOOL("show-fps")
 			END_OPTION
 
@@ -0,0 +1,70 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/framestats.h"
+#include "common/algorithm.h"
+
+namespace Common {
+
+FrameStatistics::FrameStatistics() :
+		_sorted(true),
+		_totalTime(0) {
+}
+
+void FrameStatistics::reset() {
+	_frames.clear();
+	_totalTime = 0;
+	_sorted = true;
+}
+
+void FrameStatistics::addFrame(uint32 duration) {
+	_frames.push_back(duration);
+	_totalTime += duration;
+	_sorted = false;
+}
+
+double FrameStatistics::getFramesPerSecond() const {
+	if (_totalTime == 0)
+		return 0.0;
+
+	return _frames.size() * 1000000.0 / _totalTime;
+}
+
+uint32 FrameStatistics::getPercentile(uint percent) const {
+	if (_frames.empty())
+		return 0;
+
+	if (!_sorted) {
+		sort(_frames.begin(), _frames.end());
+		_sorted = true;
+	}
+
+	uint rank = (percent * _frames.size() + 99) / 100;
+	if (rank > 0)
+		rank--;
+	if (rank >= _frames.size())
+		rank = _frames.size() - 1;
+
+	return _frames[rank];
+}
+
+} // End of namespace Common
@@ -0,0 +1,71 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_FRAMESTATS_H
+#define COMMON_FRAMESTATS_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+
+namespace Common {
+
+/**
+ * Collects the durations of the frames of a session, to report the
+ * frame rate and the frame time distribution.
+ */
+class FrameStatistics {
+public:
+	FrameStatistics();
+
+	/** Forget all the frames */
+	void reset();
+
+	/** Add the duration of a frame, in microseconds */
+	void addFrame(uint32 duration);
+
+	/** Get the number of frames */
+	uint getFrameCount() const { return _frames.size(); }
+
+	/** Get the total duration of the frames, in microseconds */
+	uint64 getTotalTime() const { return _totalTime; }
+
+	/** Get the average number of frames per second, 0 without any frame */
+	double getFramesPerSecond() const;
+
+	/**
+	 * Get a percentile of the frame durations, using the nearest rank method
+	 *
+	 * @param percent the percentile, between 0 and 100
+	 * @return the duration in microseconds, 0 without any frame
+	 */
+	uint32 getPercentile(uint percent) const;
+
+private:
+	// Sorted in place the first time a percentile is needed
+	mutable Array<uint32> _frames;
+	mutable bool _sorted;
+	uint64 _totalTime;
+};
+
+} // End of namespace Common
+
+#endif
@@ -222,6 +222,15 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Maps the file referred by this node in memory, when supported by
+	 * the backend. This assumes that the node actually refers to a readable
+	 * file. If this is not the case, 0 is returned.
+	 *
+	 * @return pointer to the mapping, 0 in case of a failure
+	 */
+	virtual MappedFile *createMappedFile() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -0,0 +1,66 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/mappedfile.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+namespace {
+
+class BufferMappedFile : public MappedFile {
+public:
+	BufferMappedFile(byte *data, uint32 size) : _data(data), _size(size) {}
+	~BufferMappedFile() { free(_data); }
+
+	const byte *getData() const { return _data; }
+	uint32 size() const { return _size; }
+
+private:
+	byte *_data;
+	uint32 _size;
+};
+
+} // End of anonymous namespace
+
+MappedFile *MappedFile::createFromStream(SeekableReadStream &stream) {
+	uint32 size = stream.size();
+	byte *data = (byte *)malloc(size);
+	if (!data)
+		return 0;
+
+	stream.seek(0, SEEK_SET);
+	if (stream.read(data, size) != size) {
+		free(data);
+		return 0;
+	}
+
+	return new BufferMappedFile(data, size);
+}
+
+MappedFileReadStream::MappedFileReadStream(const MappedFilePtr &file, uint32 offset, uint32 len) :
+		MemoryReadStream(file->getData() + offset, len),
+		_file(file) {
+	assert(offset + len <= file->size());
+}
+
+} // End of namespace Common
@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+namespace Common {
+
+/**
+ * Read-only view of the whole contents of a file.
+ *
+ * Backends able to map files in memory provide implementations through
+ * ArchiveMember::createMappedFile(). The contents stay valid for as long as
+ * the MappedFile object is alive.
+ */
+class MappedFile {
+public:
+	virtual ~MappedFile() {}
+
+	/** Returns a pointer to the first byte of the file */
+	virtual const byte *getData() const = 0;
+
+	/** Returns the size of the file in bytes */
+	virtual uint32 size() const = 0;
+
+	/**
+	 * Reads a stream in its entirety into a heap allocated buffer.
+	 * Used as a fallback when the file can't be mapped.
+	 *
+	 * @return the buffer-backed file, 0 in case of a failure
+	 */
+	static MappedFile *createFromStream(SeekableReadStream &stream);
+};
+
+typedef SharedPtr<MappedFile> MappedFilePtr;
+
+/**
+ * Zero-copy stream over a range of a mapped file.
+ * The stream keeps a reference on the mapping, so it can outlive the
+ * archive it was created from.
+ */
+class MappedFileReadStream : public MemoryReadStream {
+private:
+	MappedFilePtr _file;
+
+public:
+	MappedFileReadStream(const MappedFilePtr &file, uint32 offset, uint32 len);
+};
+
+} // End of namespace Common
+
+#endif
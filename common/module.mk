@@ -10,6 +10,7 @@ MODULE_OBJS := \
 	EventDispatcher.o \
 	EventMapper.o \
 	file.o \
+	framestats.o \
 	fs.o \
 	gui_options.o \
 	hashmap.o \
@@ -19,11 +20,13 @@ MODULE_OBJS := \
 	language.o \
 	localization.o \
 	macresman.o \
+	mappedfile.o \
 	memorypool.o \
 	md5.o \
 	mdct.o \
 	mutex.o \
 	platform.o \
+	profiler.o \
 	quicktime.o \
 	random.o \
 	rational.o \
@@ -57,6 +60,12 @@ MODULE_OBJS += \
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
 	recorderfile.o
+else
+ifeq ($(BACKEND),null)
+# The null backend replays recordings for benchmarking
+MODULE_OBJS += \
+	recorderfile.o
+endif
 endif
 
 ifdef USE_ICONV
@@ -0,0 +1,221 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/profiler.h"
+#include "common/algorithm.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(Profiler);
+
+volatile bool Profiler::_recording = false;
+
+static const char *const threadNames[] = { "Main", "Audio", "Timer" };
+
+Profiler::Profiler() :
+		_recordingStart(0),
+		_frameStart(0),
+		_frameFirstEvent(0),
+		_lastFrameTime(0) {
+	for (uint i = 0; i < kThreadCount; i++) {
+		_threads[i].events = 0;
+		_threads[i].total = 0;
+	}
+}
+
+Profiler::~Profiler() {
+	_recording = false;
+	freeBuffers();
+}
+
+uint64 Profiler::getTimestamp() {
+	return g_system->getMicros();
+}
+
+void Profiler::setEnabled(bool enabled) {
+	if (enabled == _recording)
+		return;
+
+	if (!enabled) {
+		_recording = false;
+		freeBuffers();
+		_lastFrameTime = 0;
+		_lastFrameZones.clear();
+		return;
+	}
+
+	for (uint i = 0; i < kThreadCount; i++) {
+		StackLock lock(_threads[i].mutex);
+		_threads[i].events = new Event[kEventsPerThread];
+		_threads[i].total = 0;
+	}
+
+	_recordingStart = getTimestamp();
+	_frameStart = _recordingStart;
+	_frameFirstEvent = 0;
+	_recording = true;
+}
+
+void Profiler::freeBuffers() {
+	for (uint i = 0; i < kThreadCount; i++) {
+		StackLock lock(_threads[i].mutex);
+		delete[] _threads[i].events;
+		_threads[i].events = 0;
+		_threads[i].total = 0;
+	}
+}
+
+void Profiler::pushEvent(RingBuffer &ring, const char *name, uint64 start, uint32 duration) {
+	if (!ring.events)
+		return;
+
+	Event &event = ring.events[ring.total % kEventsPerThread];
+	event.name = name;
+	event.start = start;
+	event.duration = duration;
+	ring.total++;
+}
+
+void Profiler::endZone(Thread thread, const char *name, uint64 start) {
+	uint64 end = getTimestamp();
+	RingBuffer &ring = _threads[thread];
+
+	// The main thread is the only one reading the buffers,
+	// it does not need to lock its own.
+	if (thread == kThreadMain) {
+		pushEvent(ring, name, start, (uint32)(end - start));
+	} else {
+		StackLock lock(ring.mutex);
+		pushEvent(ring, name, start, (uint32)(end - start));
+	}
+}
+
+void Profiler::endFrame() {
+	if (!_recording)
+		return;
+
+	uint64 end = getTimestamp();
+	RingBuffer &ring = _threads[kThreadMain];
+
+	_lastFrameTime = (uint32)(end - _frameStart);
+	summarizeFrame(_frameFirstEvent, ring.total);
+	pushEvent(ring, "Frame", _frameStart, _lastFrameTime);
+
+	_frameStart = end;
+	_frameFirstEvent = ring.total;
+}
+
+struct ZoneTotalLess {
+	bool operator()(const Profiler::ZoneTotal &a, const Profiler::ZoneTotal &b) const {
+		return a.time > b.time;
+	}
+};
+
+void Profiler::summarizeFrame(uint32 firstEvent, uint32 lastEvent) {
+	const RingBuffer &ring = _threads[kThreadMain];
+
+	// The oldest events of long frames may have been overwritten
+	if (lastEvent - firstEvent > kEventsPerThread)
+		firstEvent = lastEvent - kEventsPerThread;
+
+	_lastFrameZones.clear();
+	for (uint32 i = firstEvent; i != lastEvent; i++) {
+		const Event &event = ring.events[i % kEventsPerThread];
+
+		uint j = 0;
+		while (j < _lastFrameZones.size() && strcmp(_lastFrameZones[j].name, event.name) != 0)
+			j++;
+
+		if (j == _lastFrameZones.size()) {
+			ZoneTotal total;
+			total.name = event.name;
+			total.time = 0;
+			total.count = 0;
+			_lastFrameZones.push_back(total);
+		}
+
+		_lastFrameZones[j].time += event.duration;
+		_lastFrameZones[j].count++;
+	}
+
+	sort(_lastFrameZones.begin(), _lastFrameZones.end(), ZoneTotalLess());
+}
+
+void Profiler::getOverlayLines(Array<String> &lines, uint maxZones) const {
+	if (!_recording)
+		return;
+
+	lines.push_back(String::format("frame %6.2f ms", _lastFrameTime / 1000.0f));
+
+	for (uint i = 0; i < _lastFrameZones.size() && i < maxZones; i++) {
+		const ZoneTotal &zone = _lastFrameZones[i];
+		lines.push_back(String::format("%-16.16s %6.2f ms %3d", zone.name, zone.time / 1000.0f, zone.count));
+	}
+}
+
+static String escapeJSON(const char *str) {
+	String escaped;
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			escaped += '\\';
+		escaped += *str;
+	}
+	return escaped;
+}
+
+uint32 Profiler::exportChromeTrace(WriteStream &stream) {
+	uint32 written = 0;
+
+	stream.writeString("{\"traceEvents\":[\n");
+
+	for (uint i = 0; i < kThreadCount; i++) {
+		stream.writeString(String::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+		                                  i + 1, threadNames[i]));
+		stream.writeString(i + 1 < kThreadCount ? ",\n" : "");
+	}
+
+	for (uint i = 0; i < kThreadCount; i++) {
+		RingBuffer &ring = _threads[i];
+		StackLock lock(ring.mutex);
+
+		if (!ring.events)
+			continue;
+
+		uint32 first = ring.total > kEventsPerThread ? ring.total - kEventsPerThread : 0;
+		for (uint32 j = first; j != ring.total; j++) {
+			const Event &event = ring.events[j % kEventsPerThread];
+			// The timestamps are in microseconds since the recording started
+			stream.writeString(String::format(",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.0f,\"dur\":%u}",
+			                                  escapeJSON(event.name).c_str(), i + 1,
+			                                  (double)(event.start - _recordingStart), event.duration));
+			written++;
+		}
+	}
+
+	stream.writeString("\n]}\n");
+
+	return written;
+}
+
+} // End of namespace Common
@@ -0,0 +1,181 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * Records the time spent in named zones of code, to find out where the
+ * frame time goes.
+ *
+ * Zones are recorded with the PROFILE_ZONE macro. Nothing is recorded until
+ * the profiler is enabled, and disabled zones only cost a test.
+ *
+ * Each thread the engines run code on has its own ring buffer, only holding
+ * the most recent zones. The buffers can be exported as a Chrome trace,
+ * to be opened with chrome://tracing. The time spent in the main thread
+ * zones during the last frame is also summarized, for the engines to draw.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	/** The threads zones are recorded from */
+	enum Thread {
+		kThreadMain,  ///< The engine main loop
+		kThreadAudio, ///< The mixer callback
+		kThreadTimer, ///< The timer callbacks
+		kThreadCount
+	};
+
+	/** The total time spent in a zone during a frame */
+	struct ZoneTotal {
+		const char *name;
+		uint32 time;  ///< In microseconds
+		uint32 count; ///< Number of times the zone was entered
+	};
+
+	/** Start or stop recording, the recorded zones are lost when stopping */
+	void setEnabled(bool enabled);
+
+	/** Is the profiler recording? Safe to call without an instance. */
+	static bool isEnabled() { return _recording; }
+
+	/** Get the current time for the zones, in microseconds */
+	static uint64 getTimestamp();
+
+	/**
+	 * Record a zone which just ended.
+	 *
+	 * Only one thread may record zones for each of the Thread values.
+	 */
+	void endZone(Thread thread, const char *name, uint64 start);
+
+	/**
+	 * Mark the end of a frame of the main thread, and summarize its zones
+	 */
+	void endFrame();
+
+	/** Get the duration of the last complete frame, in microseconds */
+	uint32 getLastFrameTime() const { return _lastFrameTime; }
+
+	/** Get the main thread zones of the last complete frame, by decreasing time */
+	const Array<ZoneTotal> &getLastFrameZones() const { return _lastFrameZones; }
+
+	/**
+	 * Get a text summary of the last frame, for drawing over the game
+	 *
+	 * @param lines    the lines of text are appended to this array
+	 * @param maxZones the maximum number of zones to list
+	 */
+	void getOverlayLines(Array<String> &lines, uint maxZones) const;
+
+	/**
+	 * Write the recorded zones as a Chrome trace event JSON file
+	 *
+	 * @return the number of written zones
+	 */
+	uint32 exportChromeTrace(WriteStream &stream);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	Profiler();
+	~Profiler();
+
+	enum {
+		kEventsPerThread = 16384
+	};
+
+	struct Event {
+		const char *name;
+		uint64 start;
+		uint32 duration;
+	};
+
+	struct RingBuffer {
+		Event *events;
+		uint32 total; ///< Number of events pushed since the recording started
+		Mutex mutex;  ///< Guards the buffers of the threads other than the main one
+	};
+
+	static volatile bool _recording;
+
+	RingBuffer _threads[kThreadCount];
+
+	uint64 _recordingStart;
+	uint64 _frameStart;
+	uint32 _frameFirstEvent;
+	uint32 _lastFrameTime;
+	Array<ZoneTotal> _lastFrameZones;
+
+	void pushEvent(RingBuffer &ring, const char *name, uint64 start, uint32 duration);
+	void summarizeFrame(uint32 firstEvent, uint32 lastEvent);
+	void freeBuffers();
+};
+
+/**
+ * Records the time spent in its scope as a profiler zone.
+ */
+class ProfilerZone {
+public:
+	ProfilerZone(const char *name, Profiler::Thread thread = Profiler::kThreadMain) :
+			_name(name), _thread(thread), _active(Profiler::isEnabled()), _start(0) {
+		if (_active)
+			_start = Profiler::getTimestamp();
+	}
+
+	~ProfilerZone() {
+		if (_active)
+			Profiler::instance().endZone(_thread, _name, _start);
+	}
+
+private:
+	const char *_name;
+	Profiler::Thread _thread;
+	bool _active;
+	uint64 _start;
+};
+
+} // End of namespace Common
+
+#define PROFILE_ZONE_CONCAT2(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT2(a, b)
+
+/** Profile the enclosing scope as a zone of the main thread */
+#define PROFILE_ZONE(name) \
+	::Common::ProfilerZone PROFILE_ZONE_CONCAT(profilerZone, __LINE__)(name)
+
+/** Profile the enclosing scope as a zone of another thread */
+#define PROFILE_THREAD_ZONE(name, thread) \
+	::Common::ProfilerZone PROFILE_ZONE_CONCAT(profilerZone, __LINE__)(name, ::Common::Profiler::thread)
+
+#define ProfileMan (::Common::Profiler::instance())
+
+#endif
@@ -80,7 +80,9 @@ bool PlaybackFile::openRead(const String &fileName) {
 		debugC(1, kDebugLevelEventRec, "playback:action=\"Load File\" result=fail reason=\"header parsing failed\"");
 		return false;
 	}
+#ifdef ENABLE_EVENTRECORDER
 	_screenshotsFile = wrapBufferedWriteStream(g_system->getSavefileManager()->openForSaving("screenshots.bin"), 128 * 1024);
+#endif
 	debugC(1, kDebugLevelEventRec, "playback:action=\"Load File\" result=success");
 	_mode = kRead;
 	return true;
@@ -347,6 +349,13 @@ RecorderEvent PlaybackFile::getNextEvent() {
 		}
 	}
 	RecorderEvent result;
+	if (isEventsBufferEmpty()) {
+		// The end of the recording
+		result.recordedtype = kRecorderEventTypeNormal;
+		result.type = EVENT_INVALID;
+		result.time = 0;
+		return result;
+	}
 	readEvent(result);
 	return result;
 }
@@ -399,6 +408,8 @@ void PlaybackFile::readEventsToBuffer(uint32 size) {
 	_eventsSize = size;
 }
 
+#ifdef ENABLE_EVENTRECORDER
+// The screenshots are only handled by the event recorder
 void PlaybackFile::saveScreenShot(Graphics::Surface &screen, byte md5[16]) {
 	dumpRecordsToFile();
 	_writeStream->writeUint32LE(kMD5Tag);
@@ -406,6 +417,7 @@ void PlaybackFile::saveScreenShot(Graphics::Surface &screen, byte md5[16]) {
 	_writeStream->write(md5, 16);
 	Graphics::saveThumbnail(*_writeStream, screen);
 }
+#endif
 
 void PlaybackFile::dumpRecordsToFile() {
 	if (!_headerDumped) {
@@ -598,6 +610,7 @@ bool PlaybackFile::skipToNextScreenshot() {
 	return false;
 }
 
+#ifdef ENABLE_EVENTRECORDER
 Graphics::Surface *PlaybackFile::getScreenShot(int number) {
 	if (_mode != kRead) {
 		return NULL;
@@ -617,6 +630,7 @@ Graphics::Surface *PlaybackFile::getScreenShot(int number) {
 	}
 	return NULL;
 }
+#endif
 
 void PlaybackFile::updateHeader() {
 	if (_mode == kWrite) {
@@ -693,6 +707,10 @@ void PlaybackFile::writeSaveFilesSection() {
 
 
 void PlaybackFile::checkRecordedMD5() {
+#ifndef ENABLE_EVENTRECORDER
+	// Only the event recorder can grab the screen to compare it
+	_readStream->skip(16);
+#else
 	uint8 currentMD5[16];
 	uint8 savedMD5[16];
 	Graphics::Surface screen;
@@ -710,6 +728,7 @@ void PlaybackFile::checkRecordedMD5() {
 	}
 	Graphics::saveThumbnail(*_screenshotsFile, screen);
 	screen.free();
+#endif
 }
 
 
@@ -30,6 +30,7 @@
 #include "common/taskbar.h"
 #include "common/updates.h"
 #include "common/textconsole.h"
+#include "common/workerpool.h"
 #ifdef ENABLE_EVENTRECORDER
 #include "gui/EventRecorder.h"
 #endif
@@ -45,6 +46,7 @@ OSystem::OSystem() {
 	_eventManager = 0;
 	_timerManager = 0;
 	_savefileManager = 0;
+	_workerPool = 0;
 #if defined(USE_TASKBAR)
 	_taskbarManager = 0;
 #endif
@@ -64,6 +66,9 @@ OSystem::~OSystem() {
 	delete _timerManager;
 	_timerManager = 0;
 
+	delete _workerPool;
+	_workerPool = 0;
+
 #if defined(USE_TASKBAR)
 	delete _taskbarManager;
 	_taskbarManager = 0;
@@ -51,6 +51,7 @@ class TaskbarManager;
 class UpdateManager;
 #endif
 class TimerManager;
+class WorkerPool;
 class SeekableReadStream;
 class WriteStream;
 #ifdef ENABLE_KEYMAPPER
@@ -162,6 +163,14 @@ protected:
 	 */
 	Common::SaveFileManager *_savefileManager;
 
+	/**
+	 * No default value is provided for _workerPool by OSystem, backends
+	 * without threads leave it unset.
+	 *
+	 * @note _workerPool is deleted by the OSystem destructor.
+	 */
+	Common::WorkerPool *_workerPool;
+
 #if defined(USE_TASKBAR)
 	/**
 	 * No default value is provided for _taskbarManager by OSystem.
@@ -999,6 +1008,13 @@ public:
 	*/
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get a high resolution timestamp in microseconds, for performance
+	 * measurements. Only the difference between two timestamps is
+	 * meaningful. The default implementation relies on getMillis().
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1023,6 +1039,14 @@ public:
 		return _eventManager;
 	}
 
+	/**
+	 * Return the worker threads of the backend, or 0 if it has none.
+	 * For more information, refer to the WorkerPool documentation.
+	 */
+	inline Common::WorkerPool *getWorkerPool() {
+		return _workerPool;
+	}
+
 #ifdef ENABLE_KEYMAPPER
 	/**
 	 * Register hardware inputs with keymapper
@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * Threads provided by the backend to run independent jobs in parallel.
+ * Backends without threads don't provide any pool, see OSystem::getWorkerPool().
+ */
+class WorkerPool : NonCopyable {
+public:
+	typedef void (*Job)(void *data, uint index);
+
+	virtual ~WorkerPool() {}
+
+	/**
+	 * Return the number of workers running the jobs, the thread calling run()
+	 * included.
+	 */
+	virtual uint getWorkerCount() const = 0;
+
+	/**
+	 * Return the index of the worker running the calling code, between 0 and
+	 * getWorkerCount() - 1. The thread calling run() is always worker 0.
+	 */
+	virtual uint getCurrentWorker() const = 0;
+
+	/**
+	 * Call job(data, index) for every index from 0 to count - 1 and return once
+	 * all of them are done. The jobs run concurrently and in any order, the
+	 * calling thread takes part in running them.
+	 *
+	 * @param job	the function to call for every index
+	 * @param data	an arbitrary pointer passed to every job
+	 * @param count	the number of jobs
+	 */
+	virtual void run(Job job, void *data, uint count) = 0;
+};
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,101 @@
+# -------- Generated by configure -----------
+
+CXX := g++
+CXXFLAGS :=   -g -ansi -W -Wno-unused-parameter -Wno-empty-body -pedantic -Wno-long-long 
+LD := g++
+LIBS += -lpthread -lm  -ljpeg  -lpng -lz  -lz 
+RANLIB := ranlib
+STRIP := strip
+AR := ar cru
+AS := as
+ASFLAGS := 
+WINDRES := windres
+WINDRESFLAGS := 
+STAGINGPATH=staging
+WIN32PATH=C:/residualvm
+AMIGAOSPATH=Games:ResidualVM
+STATICLIBPATH=
+SDLCONFIG=sdl-config
+
+ABI := 
+
+BACKEND := null
+MODULES += backends/platform/null
+MODULE_DIRS += 
+EXEPRE := 
+EXEEXT := 
+NASM := 
+NASMFLAGS := 
+
+prefix = /usr/local
+exec_prefix = ${prefix}
+bindir = ${exec_prefix}/bin
+libdir = ${exec_prefix}/lib
+datarootdir = ${prefix}/share
+datadir = ${datarootdir}/residualvm
+mandir = ${datarootdir}/man
+docdir = ${datarootdir}/doc/residualvm
+
+
+HAVE_GCC = 1
+HAVE_GCC3 = 1
+CXX_UPDATE_DEP_FLAG = -MMD -MF "$(*D)/$(DEPDIR)/$(*F).d" -MQ "$@" -MP
+POSIX = 1
+# VERBOSE_BUILD = 1
+# USE_ELF_LOADER = 1
+# DYNAMIC_MODULES = 1
+# USE_MT32EMU = 1
+# USE_RGB_COLOR = 1
+USE_SAVEGAME_TIMESTAMP = 1
+# USE_SCALERS = 1
+# USE_HQ_SCALERS = 1
+# USE_VORBIS = 1
+# USE_TREMOR = 1
+# USE_FLAC = 1
+# USE_MAD = 1
+# USE_ALSA = 1
+USE_JPEG = 1
+USE_PNG = 1
+# USE_THEORADEC = 1
+# USE_FAAD = 1
+USE_ZLIB = 1
+# USE_MPEG2 = 1
+# USE_FLUIDSYNTH = 1
+# USE_FREETYPE2 = 1
+# USE_GLEW = 1
+# ICONV_USES_CONST = 1
+USE_ICONV = 1
+# USE_OPENGL = 1
+# USE_GLES = 1
+# USE_GLES2 = 1
+# USE_OPENGL_SHADERS = 1
+# USE_NASM = 1
+# ENABLE_VKEYBD = 1
+# ENABLE_KEYMAPPER = 1
+# ENABLE_EVENTRECORDER = 1
+USE_TRANSLATION = 1
+# USE_TASKBAR = 1
+USE_BINK = 1
+# USE_UPDATES = 1
+ENABLE_GRIM = STATIC_PLUGIN
+ENABLE_MONKEY4 = 1
+ENABLE_MYST3 = STATIC_PLUGIN
+# ENABLE_STARK
+
+INCLUDES += 
+OBJS += 
+DEFINES += -DUSE_NULL_DRIVER -DPOSIX -DDATA_PATH=\"${datarootdir}/residualvm\" -DPLUGIN_DIRECTORY=\"${exec_prefix}/lib/residualvm\"
+LDFLAGS += 
+
+
+
+port_mk = ports.mk
+
+SAVED_CONFIGFLAGS  := --backend=null --enable-all-engines
+SAVED_LDFLAGS      := 
+SAVED_CXX          := 
+SAVED_CXXFLAGS     := 
+SAVED_CPPFLAGS     := 
+SAVED_ASFLAGS      := 
+SAVED_WINDRESFLAGS := 
+SAVED_SDL_CONFIG   := 
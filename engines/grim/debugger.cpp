@@ -26,6 +26,7 @@
 #include "engines/grim/debugger.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/resource.h"
 
 namespace Grim {
 
@@ -38,6 +39,7 @@ Debugger::Debugger() :
 	registerCmd("set_renderer", WRAP_METHOD(Debugger, cmd_set_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("resource_cache", WRAP_METHOD(Debugger, cmd_resource_cache));
 }
 
 Debugger::~Debugger() {
@@ -127,4 +129,21 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_resource_cache(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		g_resourceloader->resetCacheStatistics();
+	} else if (argc == 3 && !strcmp(argv[1], "budget")) {
+		g_resourceloader->setCacheMemoryBudget(atoi(argv[2]) * 1024 * 1024);
+	} else if (argc != 1) {
+		debugPrintf("Usage: resource_cache [reset | budget <megabytes>]\n");
+		return true;
+	}
+
+	ResourceLoader::CacheStatistics stats = g_resourceloader->getCacheStatistics();
+	debugPrintf("File cache: %d files, %d / %d bytes\n", stats.entries, stats.memorySize, stats.memoryBudget);
+	debugPrintf("File cache: %d hits, %d misses, %d evictions\n", stats.hits, stats.misses, stats.evictions);
+	debugPrintf("Loaded resources: %d hits, %d misses\n", stats.resourceHits, stats.resourceMisses);
+	return true;
+}
+
 }
@@ -33,6 +33,14 @@
 #include "engines/grim/emi/animationemi.h"
 #include "engines/grim/emi/skeleton.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRIM_SKINNING_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define GRIM_SKINNING_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Grim {
 
 struct Vector3int {
@@ -44,11 +52,112 @@ struct Vector3int {
 	}
 };
 
-struct BoneInfo {
-	int _incFac;
-	int _joint;
-	float _weight;
-};
+#if defined(GRIM_SKINNING_SSE2) || defined(GRIM_SKINNING_NEON)
+
+// The helpers below are the only place where SSE2 and NEON differ.
+
+#ifdef GRIM_SKINNING_SSE2
+typedef __m128 SkinVec;
+
+static inline SkinVec skinLoad(const float *v) { return _mm_loadu_ps(v); }
+static inline SkinVec skinSplat(float f) { return _mm_set1_ps(f); }
+static inline SkinVec skinMulAdd(SkinVec acc, SkinVec a, SkinVec b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+static inline void skinStore(float *v, SkinVec a) { _mm_storeu_ps(v, a); }
+#else
+typedef float32x4_t SkinVec;
+
+static inline SkinVec skinLoad(const float *v) { return vld1q_f32(v); }
+static inline SkinVec skinSplat(float f) { return vdupq_n_f32(f); }
+static inline SkinVec skinMulAdd(SkinVec acc, SkinVec a, SkinVec b) { return vmlaq_f32(acc, a, b); }
+static inline void skinStore(float *v, SkinVec a) { vst1q_f32(v, a); }
+#endif
+
+static inline void storeSkinnedVertex(SkinVec vert, SkinVec normal, Math::Vector3d *drawVertex, Math::Vector3d *drawNormal) {
+	float v[4];
+	skinStore(v, vert);
+	drawVertex->set(v[0], v[1], v[2]);
+	skinStore(v, normal);
+	drawNormal->set(v[0], v[1], v[2]);
+}
+
+/**
+ * Blend the bone matrices over the bind pose of the vertices. The influences are
+ * sorted by vertex, and a new vertex starts with each influence having _incFac set.
+ * The palette holds a column-major matrix for each bone.
+ */
+static void skinVertices(const float *palette, const BoneInfo *boneInfos, int numBoneInfos,
+                         const Math::Vector3d *vertices, const Math::Vector3d *normals,
+                         Math::Vector3d *drawVertices, Math::Vector3d *drawNormals) {
+	const SkinVec zero = skinSplat(0.0f);
+	SkinVec vert = zero, normal = zero;
+	SkinVec x = zero, y = zero, z = zero, nx = zero, ny = zero, nz = zero;
+
+	int boneVert = -1;
+	for (int i = 0; i < numBoneInfos; i++) {
+		if (boneInfos[i]._incFac == 1) {
+			if (boneVert >= 0)
+				storeSkinnedVertex(vert, normal, &drawVertices[boneVert], &drawNormals[boneVert]);
+			boneVert++;
+			vert = normal = zero;
+
+			const Math::Vector3d &v = vertices[boneVert];
+			const Math::Vector3d &n = normals[boneVert];
+			x = skinSplat(v.x());
+			y = skinSplat(v.y());
+			z = skinSplat(v.z());
+			nx = skinSplat(n.x());
+			ny = skinSplat(n.y());
+			nz = skinSplat(n.z());
+		}
+		if (boneVert < 0)
+			continue;
+
+		const float *m = palette + 16 * boneInfos[i]._joint;
+		SkinVec col0 = skinLoad(m), col1 = skinLoad(m + 4), col2 = skinLoad(m + 8), col3 = skinLoad(m + 12);
+		SkinVec weight = skinSplat(boneInfos[i]._weight);
+
+		SkinVec p = skinMulAdd(skinMulAdd(skinMulAdd(col3, col0, x), col1, y), col2, z);
+		vert = skinMulAdd(vert, p, weight);
+
+		SkinVec q = skinMulAdd(skinMulAdd(skinMulAdd(zero, col0, nx), col1, ny), col2, nz);
+		normal = skinMulAdd(normal, q, weight);
+	}
+
+	if (boneVert >= 0)
+		storeSkinnedVertex(vert, normal, &drawVertices[boneVert], &drawNormals[boneVert]);
+}
+
+#else
+
+static void skinVertices(const float *palette, const BoneInfo *boneInfos, int numBoneInfos,
+                         const Math::Vector3d *vertices, const Math::Vector3d *normals,
+                         Math::Vector3d *drawVertices, Math::Vector3d *drawNormals) {
+	int boneVert = -1;
+	for (int i = 0; i < numBoneInfos; i++) {
+		if (boneInfos[i]._incFac == 1) {
+			boneVert++;
+		}
+		if (boneVert < 0)
+			continue;
+
+		const float *m = palette + 16 * boneInfos[i]._joint;
+		const float weight = boneInfos[i]._weight;
+		const Math::Vector3d &v = vertices[boneVert];
+		const Math::Vector3d &n = normals[boneVert];
+
+		Math::Vector3d vert(m[0] * v.x() + m[4] * v.y() + m[8] * v.z() + m[12],
+		                    m[1] * v.x() + m[5] * v.y() + m[9] * v.z() + m[13],
+		                    m[2] * v.x() + m[6] * v.y() + m[10] * v.z() + m[14]);
+		drawVertices[boneVert] += vert * weight;
+
+		Math::Vector3d normal(m[0] * n.x() + m[4] * n.y() + m[8] * n.z(),
+		                      m[1] * n.x() + m[5] * n.y() + m[9] * n.z(),
+		                      m[2] * n.x() + m[6] * n.y() + m[10] * n.z());
+		drawNormals[boneVert] += normal * weight;
+	}
+}
+
+#endif
 
 Common::String readLAString(Common::ReadStream *ms) {
 	int strLength = ms->readUint32LE();
@@ -225,49 +334,67 @@ void EMIModel::setSkeleton(Skeleton *skel) {
 	if (!skel || !_numBoneInfos) {
 		return;
 	}
-	delete[] _vertexBoneInfo; _vertexBoneInfo = nullptr;
-	_vertexBoneInfo = new int[_numBoneInfos];
+	delete[] _boneJoints; _boneJoints = nullptr;
+	_boneJoints = new int[_numBones];
+	for (int i = 0; i < _numBones; i++) {
+		_boneJoints[i] = _skeleton->findJointIndex(_boneNames[i]);
+	}
+
+	delete[] _skinPalette; _skinPalette = nullptr;
+	_skinPalette = new float[_numBones * 16];
+
+	delete[] _boneBounds; _boneBounds = nullptr;
+	_boneBounds = new Math::AABB[_numBones];
+	int boneVert = -1;
 	for (int i = 0; i < _numBoneInfos; i++) {
-		_vertexBoneInfo[i] = _skeleton->findJointIndex(_boneNames[_boneInfos[i]._joint]);
+		if (_boneInfos[i]._incFac == 1) {
+			boneVert++;
+		}
+		if (boneVert < 0)
+			continue;
+
+		int jointIndex = _boneJoints[_boneInfos[i]._joint];
+		Math::Vector3d vert = _vertices[boneVert];
+		if (jointIndex >= 0)
+			_skeleton->_joints[jointIndex]._inverseBindMatrix.transform(&vert, true);
+		_boneBounds[_boneInfos[i]._joint].expand(vert);
 	}
 }
 
 void EMIModel::prepareForRender() {
-	if (!_skeleton || !_vertexBoneInfo)
+	if (!_skeleton || !_boneJoints)
 		return;
 
-	for (int i = 0; i < _numVertices; i++) {
-		_drawVertices[i].set(0.0f, 0.0f, 0.0f);
-		_drawNormals[i].set(0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < _numBones; i++) {
+		Math::Matrix4 skinMatrix;
+		if (_boneJoints[i] >= 0)
+			skinMatrix = _skeleton->_joints[_boneJoints[i]]._skinMatrix;
+		skinMatrix.transpose();
+		memcpy(_skinPalette + 16 * i, skinMatrix.getData(), 16 * sizeof(float));
 	}
 
-	int boneVert = -1;
-	for (int i = 0; i < _numBoneInfos; i++) {
-		if (_boneInfos[i]._incFac == 1) {
-			boneVert++;
-		}
+	_drawVerticesDirty = true;
+	if (!g_driver->supportsEMIModelSkinning(this))
+		updateDrawVertices();
 
-		int jointIndex = _vertexBoneInfo[i];
-		const Math::Matrix4 &jointMatrix = _skeleton->_joints[jointIndex]._finalMatrix;
-		const Math::Matrix4 &bindPose = _skeleton->_joints[jointIndex]._absMatrix;
+	g_driver->updateEMIModel(this);
+}
 
-		Math::Vector3d vert = _vertices[boneVert];
-		bindPose.inverseTranslate(&vert);
-		bindPose.inverseRotate(&vert);
-		jointMatrix.transform(&vert, true);
-		_drawVertices[boneVert] += vert * _boneInfos[i]._weight;
-
-		Math::Vector3d normal = _normals[boneVert];
-		bindPose.inverseRotate(&normal);
-		jointMatrix.transform(&normal, false);
-		_drawNormals[boneVert] += normal * _boneInfos[i]._weight;
+void EMIModel::updateDrawVertices() const {
+	if (!_drawVerticesDirty)
+		return;
+	_drawVerticesDirty = false;
+
+	for (int i = 0; i < _numVertices; i++) {
+		_drawVertices[i].set(0.0f, 0.0f, 0.0f);
+		_drawNormals[i].set(0.0f, 0.0f, 0.0f);
 	}
 
+	skinVertices(_skinPalette, _boneInfos, _numBoneInfos, _vertices, _normals, _drawVertices, _drawNormals);
+
 	for (int i = 0; i < _numVertices; i++) {
 		_drawNormals[i].normalize();
 	}
-
-	g_driver->updateEMIModel(this);
 }
 
 void EMIModel::prepareTextures() {
@@ -421,8 +548,23 @@ void EMIModel::getBoundingBox(int *x1, int *y1, int *x2, int *y2) const {
 
 Math::AABB EMIModel::calculateWorldBounds(const Math::Matrix4 &matrix) const {
 	Math::AABB bounds;
-	for (int i = 0; i < _numVertices; i++) {
-		bounds.expand(_drawVertices[i]);
+	if (_drawVerticesDirty && _skeleton) {
+		// The vertices are skinned by the renderer, use the bounds of the bones
+		// to avoid skinning them on the CPU as well.
+		for (int i = 0; i < _numBones; i++) {
+			if (!_boneBounds[i].isValid())
+				continue;
+
+			Math::AABB boneBounds = _boneBounds[i];
+			if (_boneJoints[i] >= 0)
+				boneBounds.transform(_skeleton->_joints[_boneJoints[i]]._finalMatrix);
+			bounds.expand(boneBounds.getMin());
+			bounds.expand(boneBounds.getMax());
+		}
+	} else {
+		for (int i = 0; i < _numVertices; i++) {
+			bounds.expand(_drawVertices[i]);
+		}
 	}
 	bounds.transform(matrix);
 	return bounds;
@@ -447,7 +589,10 @@ EMIModel::EMIModel(const Common::String &filename, Common::SeekableReadStream *d
 	_numBones = 0;
 	_boneInfos = nullptr;
 	_numBoneInfos = 0;
-	_vertexBoneInfo = nullptr;
+	_boneJoints = nullptr;
+	_skinPalette = nullptr;
+	_boneBounds = nullptr;
+	_drawVerticesDirty = false;
 	_skeleton = nullptr;
 	_radius = 0;
 	_center = new Math::Vector3d();
@@ -477,7 +622,9 @@ EMIModel::~EMIModel() {
 	delete[] _texNames;
 	delete[] _mats;
 	delete[] _boneInfos;
-	delete[] _vertexBoneInfo;
+	delete[] _boneJoints;
+	delete[] _skinPalette;
+	delete[] _boneBounds;
 	delete[] _boneNames;
 	delete[] _lighting;
 	delete[] _texFlags;
@@ -48,7 +48,12 @@ struct Vector3int;
 
 class EMICostume;
 class EMIModel;
-struct BoneInfo;
+struct BoneInfo {
+	int _incFac;
+	int _joint;
+	float _weight;
+};
+
 struct Bone;
 class Skeleton;
 
@@ -113,7 +118,12 @@ public:
 	int _numBoneInfos;
 	BoneInfo *_boneInfos;
 	Common::String *_boneNames;
-	int *_vertexBoneInfo;
+	int *_boneJoints;
+	// Column-major skinning matrix of each bone, refreshed every frame
+	float *_skinPalette;
+	// Bounds of the vertices influenced by each bone, in the space of the bone
+	Math::AABB *_boneBounds;
+	mutable bool _drawVerticesDirty;
 
 	// Stuff we dont know how to use:
 	float _radius;
@@ -136,6 +146,13 @@ public:
 	void setSkeleton(Skeleton *skel);
 	void loadMesh(Common::SeekableReadStream *data);
 	void prepareForRender();
+	/**
+	 * Skin the vertices and normals on the CPU, if they were not already
+	 * for the current frame. When the renderer does the skinning in its
+	 * vertex shader, this is only needed by the code working with the
+	 * animated vertices.
+	 */
+	void updateDrawVertices() const;
 	void prepareTextures();
 	void draw();
 	void updateLighting(const Math::Matrix4 &modelToWorld);
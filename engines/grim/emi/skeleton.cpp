@@ -82,6 +82,11 @@ void Skeleton::initBone(int index) {
 		// Might be the other way around.
 		_joints[index]._absMatrix =  _joints[index]._absMatrix * _joints[index]._relMatrix;
 	}
+
+	// The bind pose never changes, invert it once instead of for every skinned vertex.
+	_joints[index]._inverseBindMatrix = _joints[index]._absMatrix;
+	_joints[index]._inverseBindMatrix.invertAffineOrthonormal();
+	_joints[index]._skinMatrix = _joints[index]._finalMatrix * _joints[index]._inverseBindMatrix;
 }
 
 void Skeleton::initBones() {
@@ -180,6 +185,7 @@ void Skeleton::commitAnim() {
 			_joints[m]._finalMatrix = _joints[m]._animMatrix;
 			_joints[m]._finalQuat = _joints[m]._animQuat;
 		}
+		_joints[m]._skinMatrix = _joints[m]._finalMatrix * _joints[m]._inverseBindMatrix;
 	}
 }
 
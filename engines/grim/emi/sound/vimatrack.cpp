@@ -121,7 +121,7 @@ void VimaTrack::parseSoundHeader(SoundDesc *sound, int &headerSize) {
 	}
 }
 
-int32 VimaTrack::getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size) {
+int32 VimaTrack::getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size) {
 	//assert(checkForProperHandle(sound));
 	assert(buf && offset >= 0 && size >= 0);
 	assert(region >= 0 && region < sound->numRegions);
@@ -139,9 +139,8 @@ int32 VimaTrack::getDataFromRegion(SoundDesc *sound, int region, byte **buf, int
 	if (sound->mcmpData) {
 		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, buf);
 	} else {
-		*buf = new byte[size];
 		sound->inStream->seek(region_offset + offset + sound->headerSize, SEEK_SET);
-		sound->inStream->read(*buf, size);
+		sound->inStream->read(buf, size);
 	}
 
 	return size;
@@ -190,7 +189,9 @@ void VimaTrack::playTrack(const Audio::Timestamp *start) {
 		return;
 
 	do {
-		result = getDataFromRegion(_desc, curRegion, &data, regionOffset, mixer_size);
+		// The whole sound is queued at once, each buffer is owned by the stream
+		data = new byte[mixer_size];
+		result = getDataFromRegion(_desc, curRegion, data, regionOffset, mixer_size);
 		if (channels == 1) {
 			result &= ~1;
 		}
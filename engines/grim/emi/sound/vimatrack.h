@@ -39,7 +39,7 @@ class McmpMgr;
 class VimaTrack : public SoundTrack {
 	Common::SeekableReadStream *_file;
 	void parseSoundHeader(SoundDesc *sound, int &headerSize);
-	int32 getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size);
+	int32 getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size);
 public:
 	VimaTrack();
 	virtual ~VimaTrack();
@@ -267,6 +267,11 @@ public:
 	virtual void createEMIModel(EMIModel *model) {}
 	virtual void updateEMIModel(const EMIModel *model) {}
 	virtual void destroyEMIModel(EMIModel *model) {}
+	/**
+	 * Check if the renderer skins the model in its vertex shader, in which
+	 * case updateEMIModel only needs the skinning palette of the model.
+	 */
+	virtual bool supportsEMIModelSkinning(const EMIModel *model) const { return false; }
 
 	virtual int genBuffer() { return 0; }
 	virtual void delBuffer(int buffer) {}
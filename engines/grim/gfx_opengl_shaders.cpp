@@ -52,6 +52,7 @@
 
 #include "graphics/surface.h"
 #include "graphics/pixelbuffer.h"
+#include "graphics/opengl/context.h"
 
 #include "engines/grim/actor.h"
 #include "engines/grim/bitmap.h"
@@ -127,6 +128,19 @@ struct EMIModelUserData {
 	uint32 _colorMapVBO;
 	uint32 _verticesVBO;
 	uint32 _normalsVBO;
+	uint32 _bonesVBO;
+	bool _skinned;
+};
+
+// The joints are indexed with bytes in the vertex buffers
+static const int kMaxSkinningJoints = 64;
+static const int kMaxSkinningInfluences = 4;
+// The vec4 uniforms of emi_actor.vertex other than the skinning matrices, one per scalar
+static const int kEMIActorUniformVectors = 65;
+
+struct EMIVertexBones {
+	byte _joints[kMaxSkinningInfluences];
+	float _weights[kMaxSkinningInfluences];
 };
 
 struct ModelUserData {
@@ -218,6 +232,7 @@ GfxOpenGLS::GfxOpenGLS() {
 	_selectedTexture = NULL;
 	_emergTexture = 0;
 	_maxLights = 8;
+	_maxSkinningJoints = 0;
 	_lights = new Light[_maxLights];
 	_lightsEnabled = false;
 	_hasAmbientLight = false;
@@ -379,8 +394,14 @@ void GfxOpenGLS::setupShaders() {
 	_emergProgram = OpenGL::Shader::fromFiles("emerg", commonAttributes);
 
 	static const char* actorAttributes[] = {"position", "texcoord", "color", "normal", NULL};
-	_actorProgram = OpenGL::Shader::fromFiles(isEMI ? "emi_actor" : "grim_actor", actorAttributes);
-	_spriteProgram = OpenGL::Shader::fromFiles(isEMI ? "emi_actor" : "grim_actor", actorAttributes);
+	static const char* emiActorAttributes[] = {"position", "texcoord", "color", "normal", "boneJoints", "boneWeights", NULL};
+	// Each skinning matrix takes three vec4 uniforms, the palette uses the ones left
+	// by the other uniforms. The models with more bones are skinned on the CPU.
+	_maxSkinningJoints = CLIP((OpenGLContext.maxVertexUniformVectors - kEMIActorUniformVectors) / 3, 0, kMaxSkinningJoints);
+	Common::String actorDefines = Common::String::format("#define MAX_SKINNING_JOINTS %d\n", MAX(_maxSkinningJoints, 1));
+	_actorProgram = OpenGL::Shader::fromFiles(isEMI ? "emi_actor" : "grim_actor", isEMI ? emiActorAttributes : actorAttributes, actorDefines.c_str());
+	_spriteProgram = OpenGL::Shader::fromFiles(isEMI ? "emi_actor" : "grim_actor", isEMI ? emiActorAttributes : actorAttributes, actorDefines.c_str());
+	resolveActorUniforms();
 
 	static const char* primAttributes[] = { "position", NULL };
 	_shadowPlaneProgram = OpenGL::Shader::fromFiles("shadowplane", primAttributes);
@@ -405,6 +426,27 @@ void GfxOpenGLS::setupShaders() {
 	}
 }
 
+void GfxOpenGLS::resolveActorUniforms() {
+	_actorUniforms._textured = _actorProgram->getUniform("textured");
+	_actorUniforms._texScale = _actorProgram->getUniform("texScale");
+	_actorUniforms._extraMatrix = _actorProgram->getUniform("extraMatrix");
+	_actorUniforms._lightsEnabled = _actorProgram->getUniform("lightsEnabled");
+	_actorUniforms._swapRandB = _actorProgram->getUniform("swapRandB");
+	_actorUniforms._useVertexAlpha = _actorProgram->getUniform("useVertexAlpha");
+	_actorUniforms._meshAlpha = _actorProgram->getUniform("meshAlpha");
+	_actorUniforms._skinned = _actorProgram->getUniform("skinned");
+	_actorUniforms._skinMatrices = _actorProgram->getUniform("skinMatrices");
+
+	_actorUniforms._lights.resize(_maxLights);
+	for (int i = 0; i < _maxLights; ++i) {
+		LightUniforms &light = _actorUniforms._lights[i];
+		light._position = _actorProgram->getUniform(Common::String::format("lights[%u]._position", i).c_str());
+		light._direction = _actorProgram->getUniform(Common::String::format("lights[%u]._direction", i).c_str());
+		light._color = _actorProgram->getUniform(Common::String::format("lights[%u]._color", i).c_str());
+		light._params = _actorProgram->getUniform(Common::String::format("lights[%u]._params", i).c_str());
+	}
+}
+
 byte *GfxOpenGLS::setupScreen(int screenW, int screenH, bool fullscreen) {
 	_screenWidth = screenW;
 	_screenHeight = screenH;
@@ -547,6 +589,8 @@ void GfxOpenGLS::getScreenBoundingBox(const EMIModel *model, int *x1, int *y1, i
 	double left = 1000;
 	double bottom = -1000;
 
+	model->updateDrawVertices();
+
 	for (uint i = 0; i < model->_numFaces; i++) {
 		int *indices = (int *)model->_faces[i]._indexes;
 
@@ -778,29 +822,23 @@ void GfxOpenGLS::startActorDraw(const Actor *actor) {
 		_actorProgram->setUniform("shadow._active", false);
 	}
 
-	_actorProgram->setUniform("lightsEnabled", _lightsEnabled);
+	_actorProgram->setUniform(_actorUniforms._lightsEnabled, _lightsEnabled);
 	_actorProgram->setUniform("hasAmbient", _hasAmbientLight);
 	if (_lightsEnabled) {
 		for (int i = 0; i < _maxLights; ++i) {
 			const Light &l = _lights[i];
-			Common::String uniform;
-			uniform = Common::String::format("lights[%u]._position", i);
+			const LightUniforms &uniforms = _actorUniforms._lights[i];
 
-			_actorProgram->setUniform(uniform.c_str(), viewMatrix * l._position);
+			_actorProgram->setUniform(uniforms._position, viewMatrix * l._position);
 
 			Math::Vector4d direction = l._direction;
 			direction.w() = 0.0;
 			viewMatrix.transformVector(&direction);
 			direction.w() = l._direction.w();
 
-			uniform = Common::String::format("lights[%u]._direction", i);
-			_actorProgram->setUniform(uniform.c_str(), direction);
-
-			uniform = Common::String::format("lights[%u]._color", i);
-			_actorProgram->setUniform(uniform.c_str(), l._color);
-
-			uniform = Common::String::format("lights[%u]._params", i);
-			_actorProgram->setUniform(uniform.c_str(), l._params);
+			_actorProgram->setUniform(uniforms._direction, direction);
+			_actorProgram->setUniform(uniforms._color, l._color);
+			_actorProgram->setUniform(uniforms._params, l._params);
 		}
 	}
 }
@@ -951,6 +989,25 @@ void GfxOpenGLS::translateViewpointFinish() {
 
 void GfxOpenGLS::updateEMIModel(const EMIModel* model) {
 	const EMIModelUserData *mud = (const EMIModelUserData *)model->_userData;
+	if (mud->_skinned) {
+		// The bind pose stays in the vertex buffers, only upload the bone matrices.
+		// The shader takes the first three rows of the column major palette matrices.
+		float rows[kMaxSkinningJoints * 12];
+		for (int i = 0; i < model->_numBones; i++) {
+			const float *matrix = model->_skinPalette + i * 16;
+			for (int row = 0; row < 3; row++) {
+				for (int column = 0; column < 4; column++) {
+					rows[i * 12 + row * 4 + column] = matrix[column * 4 + row];
+				}
+			}
+		}
+
+		mud->_shader->use();
+		GLint pos = mud->_shader->getUniformLocation(_actorUniforms._skinMatrices);
+		if (pos != -1)
+			glUniform4fv(pos, model->_numBones * 3, rows);
+		return;
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, mud->_verticesVBO);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, model->_numVertices * 3 * sizeof(float), model->_drawVertices);
 	glBindBuffer(GL_ARRAY_BUFFER, mud->_normalsVBO);
@@ -964,11 +1021,12 @@ void GfxOpenGLS::drawEMIModelFace(const EMIModel* model, const EMIMeshFace* face
 	const EMIModelUserData *mud = (const EMIModelUserData *)model->_userData;
 	mud->_shader->use();
 	bool textured = face->_hasTexture && !_currentShadowArray;
-	mud->_shader->setUniform("textured", textured ? GL_TRUE : GL_FALSE);
-	mud->_shader->setUniform("lightsEnabled", (face->_flags & EMIMeshFace::kNoLighting) ? false : _lightsEnabled);
-	mud->_shader->setUniform("swapRandB", _selectedTexture->_colorFormat == BM_BGRA || _selectedTexture->_colorFormat == BM_BGR888);
-	mud->_shader->setUniform("useVertexAlpha", _selectedTexture->_colorFormat == BM_BGRA);
-	mud->_shader->setUniform1f("meshAlpha", (model->_meshAlphaMode == Actor::AlphaReplace) ? model->_meshAlpha : 1.0f);
+	mud->_shader->setUniform(_actorUniforms._textured, textured ? GL_TRUE : GL_FALSE);
+	mud->_shader->setUniform(_actorUniforms._lightsEnabled, (face->_flags & EMIMeshFace::kNoLighting) ? false : _lightsEnabled);
+	mud->_shader->setUniform(_actorUniforms._swapRandB, _selectedTexture->_colorFormat == BM_BGRA || _selectedTexture->_colorFormat == BM_BGR888);
+	mud->_shader->setUniform(_actorUniforms._useVertexAlpha, _selectedTexture->_colorFormat == BM_BGRA);
+	mud->_shader->setUniform1f(_actorUniforms._meshAlpha, (model->_meshAlphaMode == Actor::AlphaReplace) ? model->_meshAlpha : 1.0f);
+	mud->_shader->setUniform(_actorUniforms._skinned, mud->_skinned && model->_skeleton);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, face->_indicesEBO);
 
@@ -983,8 +1041,8 @@ void GfxOpenGLS::drawMesh(const Mesh *mesh) {
 	OpenGL::Shader *actorShader = mud->_shader;
 
 	actorShader->use();
-	actorShader->setUniform("extraMatrix", _matrixStack.top());
-	actorShader->setUniform("lightsEnabled", _lightsEnabled && !isShadowModeActive());
+	actorShader->setUniform(_actorUniforms._extraMatrix, _matrixStack.top());
+	actorShader->setUniform(_actorUniforms._lightsEnabled, _lightsEnabled && !isShadowModeActive());
 
 	const Material *curMaterial = NULL;
 	for (int i = 0; i < mesh->_numFaces;) {
@@ -1001,8 +1059,8 @@ void GfxOpenGLS::drawMesh(const Mesh *mesh) {
 		}
 
 		bool textured = face->hasTexture() && !_currentShadowArray;
-		actorShader->setUniform("textured", textured ? GL_TRUE : GL_FALSE);
-		actorShader->setUniform("texScale", Math::Vector2d(_selectedTexture->_width, _selectedTexture->_height));
+		actorShader->setUniform(_actorUniforms._textured, textured ? GL_TRUE : GL_FALSE);
+		actorShader->setUniform(_actorUniforms._texScale, Math::Vector2d(_selectedTexture->_width, _selectedTexture->_height));
 
 		glDrawArrays(GL_TRIANGLES, *(int *)face->_userData, faces);
 	}
@@ -1973,12 +2031,55 @@ void GfxOpenGLS::renderZBitmaps(bool render) {
 }
 
 
+bool GfxOpenGLS::supportsEMIModelSkinning(const EMIModel *model) const {
+	const EMIModelUserData *mud = (const EMIModelUserData *)model->_userData;
+	return mud && mud->_skinned;
+}
+
+static EMIVertexBones *createEMIVertexBones(const EMIModel *model, int maxJoints) {
+	if (model->_numBoneInfos == 0 || model->_numBones > maxJoints)
+		return nullptr;
+
+	EMIVertexBones *vertexBones = new EMIVertexBones[model->_numVertices];
+	memset(vertexBones, 0, model->_numVertices * sizeof(EMIVertexBones));
+
+	int boneVert = -1;
+	int influence = 0;
+	for (int i = 0; i < model->_numBoneInfos; i++) {
+		const BoneInfo &info = model->_boneInfos[i];
+		if (info._incFac == 1) {
+			boneVert++;
+			influence = 0;
+		}
+		if (boneVert < 0)
+			continue;
+
+		if (boneVert >= model->_numVertices || influence >= kMaxSkinningInfluences) {
+			delete[] vertexBones;
+			return nullptr;
+		}
+
+		vertexBones[boneVert]._joints[influence] = info._joint;
+		vertexBones[boneVert]._weights[influence] = info._weight;
+		influence++;
+	}
+
+	return vertexBones;
+}
+
 void GfxOpenGLS::createEMIModel(EMIModel *model) {
 	EMIModelUserData *mud = new EMIModelUserData;
 	model->_userData = mud;
-	mud->_verticesVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * 3 * sizeof(float), model->_vertices, GL_STREAM_DRAW);
 
-	mud->_normalsVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * 3 * sizeof(float), model->_normals, GL_STREAM_DRAW);
+	// Models with few enough bones, and bones per vertex, are skinned in the vertex
+	// shader, the others are skinned on the CPU and uploaded every frame.
+	EMIVertexBones *vertexBones = createEMIVertexBones(model, _maxSkinningJoints);
+	mud->_skinned = vertexBones != nullptr;
+	GLenum skinnedUsage = mud->_skinned ? GL_STATIC_DRAW : GL_STREAM_DRAW;
+
+	mud->_verticesVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * 3 * sizeof(float), model->_vertices, skinnedUsage);
+
+	mud->_normalsVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * 3 * sizeof(float), model->_normals, skinnedUsage);
 
 	mud->_texCoordsVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * 2 * sizeof(float), model->_texVerts, GL_STATIC_DRAW);
 
@@ -1989,6 +2090,14 @@ void GfxOpenGLS::createEMIModel(EMIModel *model) {
 	actorShader->enableVertexAttribute("normal", mud->_normalsVBO, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
 	actorShader->enableVertexAttribute("texcoord", mud->_texCoordsVBO, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
 	actorShader->enableVertexAttribute("color", mud->_colorMapVBO, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 * sizeof(byte), 0);
+
+	mud->_bonesVBO = 0;
+	if (vertexBones) {
+		mud->_bonesVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, model->_numVertices * sizeof(EMIVertexBones), vertexBones, GL_STATIC_DRAW);
+		actorShader->enableVertexAttribute("boneJoints", mud->_bonesVBO, 4, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(EMIVertexBones), 0);
+		actorShader->enableVertexAttribute("boneWeights", mud->_bonesVBO, 4, GL_FLOAT, GL_FALSE, sizeof(EMIVertexBones), kMaxSkinningInfluences * sizeof(byte));
+		delete[] vertexBones;
+	}
 	mud->_shader = actorShader;
 
 	for (uint32 i = 0; i < model->_numFaces; ++i) {
@@ -2013,6 +2122,8 @@ void GfxOpenGLS::destroyEMIModel(EMIModel *model) {
 		OpenGL::Shader::freeBuffer(mud->_normalsVBO);
 		OpenGL::Shader::freeBuffer(mud->_texCoordsVBO);
 		OpenGL::Shader::freeBuffer(mud->_colorMapVBO);
+		if (mud->_bonesVBO)
+			OpenGL::Shader::freeBuffer(mud->_bonesVBO);
 
 		delete mud->_shader;
 		delete mud;
@@ -208,6 +208,7 @@ public:
 	virtual void createEMIModel(EMIModel *model) override;
 	virtual void updateEMIModel(const EMIModel* model) override;
 	virtual void destroyEMIModel(EMIModel *model) override;
+	virtual bool supportsEMIModelSkinning(const EMIModel *model) const override;
 
 	virtual void setBlendMode(bool additive) override;
 
@@ -221,6 +222,7 @@ private:
 	const Actor *_currentActor;
 	float _alpha;
 	int _maxLights;
+	int _maxSkinningJoints;
 	GLuint _emergTexture;
 	OpenGL::Shader* _emergProgram;
 
@@ -276,6 +278,33 @@ private:
 	bool _hasAmbientLight;
 	bool _lightsEnabled;
 
+	struct LightUniforms {
+		OpenGL::UniformHandle _position;
+		OpenGL::UniformHandle _direction;
+		OpenGL::UniformHandle _color;
+		OpenGL::UniformHandle _params;
+	};
+
+	/**
+	 * The actor uniforms set for each face or light, resolved once.
+	 * They can be used with the actor program and its clones.
+	 */
+	struct ActorUniforms {
+		OpenGL::UniformHandle _textured;
+		OpenGL::UniformHandle _texScale;
+		OpenGL::UniformHandle _extraMatrix;
+		OpenGL::UniformHandle _lightsEnabled;
+		OpenGL::UniformHandle _swapRandB;
+		OpenGL::UniformHandle _useVertexAlpha;
+		OpenGL::UniformHandle _meshAlpha;
+		OpenGL::UniformHandle _skinned;
+		OpenGL::UniformHandle _skinMatrices;
+		Common::Array<LightUniforms> _lights;
+	};
+
+	ActorUniforms _actorUniforms;
+	void resolveActorUniforms();
+
 	void setupPrimitives();
 	GLuint nextPrimitive();
 	GLuint _primitiveVBOs[32];
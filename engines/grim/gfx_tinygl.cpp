@@ -96,6 +96,12 @@ byte *GfxTinyGL::setupScreen(int screenW, int screenH, bool fullscreen) {
 	_zb = new TinyGL::FrameBuffer(screenW, screenH, buf);
 	TinyGL::glInit(_zb, 256);
 
+	// Split the frame in tiles rendered by the worker threads of the backend, if it has any
+	if (g_system->getWorkerPool()) {
+		tglSetWorkerPool(g_system->getWorkerPool());
+		tglEnableTiledRendering(true);
+	}
+
 	_storedDisplay.create(_pixelFormat, _gameWidth * _gameHeight, DisposeAfterUse::YES);
 	_storedDisplay.clear(_gameWidth * _gameHeight);
 
@@ -31,6 +31,7 @@
 #include "common/foreach.h"
 #include "common/fs.h"
 #include "common/config-manager.h"
+#include "common/profiler.h"
 #include "common/translation.h"
 
 #include "graphics/pixelbuffer.h"
@@ -108,6 +109,7 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 	ConfMan.registerDefault("fullscreen", false);
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("use_arb_shaders", true);
+	ConfMan.registerDefault("resource_cache_size", 32); // In megabytes
 
 	_showFps = ConfMan.getBool("show_fps");
 
@@ -556,6 +558,8 @@ void GrimEngine::luaUpdate() {
 	if (_savegameLoadRequest || _savegameSaveRequest || _changeHardwareState)
 		return;
 
+	PROFILE_ZONE("Lua update");
+
 	// Update timing information
 	unsigned newStart = g_system->getMillis();
 	if (newStart < _frameStart) {
@@ -572,6 +576,8 @@ void GrimEngine::luaUpdate() {
 	LuaBase::instance()->update(_frameTime, _movieTime);
 
 	if (_currSet && (_mode == NormalMode || _mode == SmushMode)) {
+		PROFILE_ZONE("Actor update");
+
 		// call updateTalk() before calling update(), since it may modify costumes state, and
 		// the costumes are updated in update().
 		for (Common::List<Actor *>::iterator i = _talkingActors.begin(); i != _talkingActors.end(); ++i) {
@@ -600,6 +606,8 @@ void GrimEngine::luaUpdate() {
 }
 
 void GrimEngine::updateDisplayScene() {
+	PROFILE_ZONE("Draw");
+
 	_doFlip = true;
 
 	if (_mode == SmushMode) {
@@ -730,8 +738,16 @@ void GrimEngine::doFlip() {
 	if (_showFps && _mode != DrawMode)
 		g_driver->drawEmergString(550, 25, _fps, Color(255, 255, 255));
 
-	if (_flipEnable)
+	if (Common::Profiler::isEnabled() && _mode != DrawMode)
+		drawProfilerOverlay();
+
+	if (_flipEnable) {
+		PROFILE_ZONE("Present");
 		g_driver->flipBuffer();
+	}
+
+	if (Common::Profiler::isEnabled())
+		ProfileMan.endFrame();
 
 	if (_showFps && _mode != DrawMode) {
 		unsigned int currentTime = g_system->getMillis();
@@ -744,6 +760,14 @@ void GrimEngine::doFlip() {
 	}
 }
 
+void GrimEngine::drawProfilerOverlay() {
+	Common::Array<Common::String> lines;
+	ProfileMan.getOverlayLines(lines, 8);
+
+	for (uint i = 0; i < lines.size(); i++)
+		g_driver->drawEmergString(10, 25 + i * 15, lines[i].c_str(), Color(255, 255, 255));
+}
+
 void GrimEngine::mainLoop() {
 	_movieTime = 0;
 	_frameTime = 0;
@@ -813,6 +837,7 @@ void GrimEngine::mainLoop() {
 		g_sound->flushTracks();
 		if (g_imuse) {
 			g_imuse->refreshScripts();
+			g_imuse->readAhead();
 		}
 
 		_debugger->onFrame();
@@ -107,6 +107,7 @@ public:
 	void luaUpdate();
 	void updateDisplayScene();
 	void doFlip();
+	void drawProfilerOverlay();
 	void setFlipEnable(bool state) { _flipEnable = state; }
 	bool getFlipEnable() { return _flipEnable; }
 	virtual void drawTextObjects();
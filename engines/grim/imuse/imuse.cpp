@@ -75,6 +75,7 @@ Imuse::Imuse(int fps, bool demo) {
 Imuse::~Imuse() {
 	g_system->getTimerManager()->removeTimerProc(timerHandler);
 	stopAllSounds();
+	freeStreamBuffers(true);
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		delete _track[l];
 	}
@@ -146,6 +147,7 @@ void Imuse::restoreState(SaveGame *savedState) {
 		g_system->getMixer()->playStream(track->getType(), &track->handle, track->stream, -1, track->getVol(),
 											track->getPan(), DisposeAfterUse::YES, false,
 											(track->mixerFlags & kFlagReverseStereo) != 0);
+		addStreamBuffers(track);
 		g_system->getMixer()->pauseHandle(track->handle, true);
 	}
 	savedState->endSection();
@@ -200,9 +202,81 @@ int32 Imuse::makeMixerFlags(int32 flags) {
 	return mixerFlags;
 }
 
+void Imuse::addStreamBuffers(Track *track) {
+	// A stream allocated where a deleted one was reuses its buffers
+	StreamBuffers *buffers = findStreamBuffers(track->stream);
+	if (!buffers) {
+		buffers = new StreamBuffers();
+		buffers->stream = track->stream;
+		for (int i = 0; i < kNumStreamBuffers; i++) {
+			buffers->data[i] = nullptr;
+			buffers->size[i] = 0;
+		}
+		_streamBuffers.push_back(buffers);
+	}
+	buffers->handle = track->handle;
+	buffers->next = 0;
+}
+
+Imuse::StreamBuffers *Imuse::findStreamBuffers(Audio::QueuingAudioStream *stream) {
+	for (Common::List<StreamBuffers *>::iterator i = _streamBuffers.begin(); i != _streamBuffers.end(); ++i) {
+		if ((*i)->stream == stream)
+			return *i;
+	}
+	return nullptr;
+}
+
+byte *Imuse::getStreamBuffer(Track *track, int32 size, DisposeAfterUse::Flag &disposeAfterUse) {
+	// The buffers are queued in turn, so the next one has been played if
+	// fewer buffers than there are in total are still in the queue
+	StreamBuffers *buffers = findStreamBuffers(track->stream);
+	if (buffers && track->stream->numQueuedStreams() < kNumStreamBuffers) {
+		int i = buffers->next;
+		if (buffers->size[i] < size) {
+			delete[] buffers->data[i];
+			buffers->data[i] = new byte[size];
+			buffers->size[i] = size;
+		}
+		disposeAfterUse = DisposeAfterUse::NO;
+		return buffers->data[i];
+	}
+
+	disposeAfterUse = DisposeAfterUse::YES;
+	return new byte[size];
+}
+
+void Imuse::queueStreamBuffer(Track *track, byte *data, int32 size, DisposeAfterUse::Flag disposeAfterUse) {
+	track->stream->queueBuffer(data, size, disposeAfterUse, makeMixerFlags(track->mixerFlags));
+	if (disposeAfterUse == DisposeAfterUse::NO) {
+		StreamBuffers *buffers = findStreamBuffers(track->stream);
+		buffers->next = (buffers->next + 1) % kNumStreamBuffers;
+	}
+}
+
+void Imuse::freeStreamBuffers(bool all) {
+	Common::List<StreamBuffers *>::iterator i = _streamBuffers.begin();
+	while (i != _streamBuffers.end()) {
+		StreamBuffers *buffers = *i;
+		if (all) {
+			g_system->getMixer()->stopHandle(buffers->handle);
+		} else if (g_system->getMixer()->isSoundHandleActive(buffers->handle)) {
+			++i;
+			continue;
+		}
+
+		// The stream has been deleted by the mixer
+		for (int j = 0; j < kNumStreamBuffers; j++)
+			delete[] buffers->data[j];
+		delete buffers;
+		i = _streamBuffers.erase(i);
+	}
+}
+
 void Imuse::callback() {
 	Common::StackLock lock(_mutex);
 
+	freeStreamBuffers(false);
+
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used) {
@@ -266,6 +340,7 @@ void Imuse::callback() {
 
 			assert(track->stream);
 			byte *data = nullptr;
+			DisposeAfterUse::Flag disposeAfterUse;
 			int32 result = 0;
 
 			if (track->curRegion == -1) {
@@ -290,7 +365,8 @@ void Imuse::callback() {
 				continue;
 
 			do {
-				result = _sound->getDataFromRegion(track->soundDesc, track->curRegion, &data, track->regionOffset, mixer_size);
+				data = getStreamBuffer(track, mixer_size, disposeAfterUse);
+				result = _sound->getDataFromRegion(track->soundDesc, track->curRegion, data, track->regionOffset, mixer_size);
 				if (channels == 1) {
 					result &= ~1;
 				}
@@ -302,9 +378,9 @@ void Imuse::callback() {
 					result = mixer_size;
 
 				if (g_system->getMixer()->isReady()) {
-					track->stream->queueBuffer(data, result, DisposeAfterUse::YES, makeMixerFlags(track->mixerFlags));
+					queueStreamBuffer(track, data, result, disposeAfterUse);
 					track->regionOffset += result;
-				} else
+				} else if (disposeAfterUse == DisposeAfterUse::YES)
 					delete[] data;
 
 				if (_sound->isEndOfRegion(track->soundDesc, track->curRegion)) {
@@ -323,6 +399,37 @@ void Imuse::callback() {
 	}
 }
 
+void Imuse::readAhead() {
+	ImuseSndMgr::SoundDesc *sounds[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
+	int regions[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
+	int32 offsets[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
+	int count = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
+			Track *track = _track[l];
+			if (track->used && track->stream && track->soundDesc && track->curRegion != -1) {
+				_sound->holdSound(track->soundDesc);
+				sounds[count] = track->soundDesc;
+				regions[count] = track->curRegion;
+				offsets[count] = track->regionOffset;
+				count++;
+			}
+		}
+	}
+
+	// Decode the compressed sounds ahead of the playback position from the
+	// engine thread, so callback() doesn't have to wait on disk I/O. This is
+	// done without holding _mutex, which callback() would wait for instead.
+	for (int i = 0; i < count; i++)
+		_sound->readAhead(sounds[i], regions[i], offsets[i]);
+
+	Common::StackLock lock(_mutex);
+	for (int i = 0; i < count; i++)
+		_sound->releaseSound(sounds[i]);
+}
+
 void Imuse::switchToNextRegion(Track *track) {
 	assert(track);
 
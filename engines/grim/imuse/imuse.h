@@ -23,6 +23,7 @@
 #ifndef GRIM_IMUSE_H
 #define GRIM_IMUSE_H
 
+#include "common/list.h"
 #include "common/mutex.h"
 
 #include "engines/grim/imuse/imuse_track.h"
@@ -38,12 +39,28 @@ class SaveGame;
 class Imuse {
 private:
 
+	// The buffers queued to a stream are reused once the mixer has played
+	// them. They are attached to the stream rather than to the track, as a
+	// stream keeps playing after being flushed from its track.
+	enum {
+		kNumStreamBuffers = 8
+	};
+
+	struct StreamBuffers {
+		Audio::QueuingAudioStream *stream;
+		Audio::SoundHandle handle;
+		byte *data[kNumStreamBuffers];
+		int32 size[kNumStreamBuffers];
+		int next;
+	};
+
 	int _callbackFps;
 
 	Track *_track[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
 
 	Common::Mutex _mutex;
 	ImuseSndMgr *_sound;
+	Common::List<StreamBuffers *> _streamBuffers;
 
 	bool _pause;
 	bool _demo;
@@ -71,6 +88,12 @@ private:
 
 	void flushTrack(Track *track);
 
+	void addStreamBuffers(Track *track);
+	StreamBuffers *findStreamBuffers(Audio::QueuingAudioStream *stream);
+	byte *getStreamBuffer(Track *track, int32 size, DisposeAfterUse::Flag &disposeAfterUse);
+	void queueStreamBuffer(Track *track, byte *data, int32 size, DisposeAfterUse::Flag disposeAfterUse);
+	void freeStreamBuffers(bool all);
+
 public:
 	Imuse(int fps, bool demo);
 	~Imuse();
@@ -100,6 +123,7 @@ public:
 	void setMusicState(int stateId);
 	int setMusicSequence(int seqId);
 	void refreshScripts();
+	void readAhead();
 	void flushTracks();
 	bool isVoicePlaying();
 	char *getCurMusicSoundName();
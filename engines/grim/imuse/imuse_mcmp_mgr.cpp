@@ -36,14 +36,24 @@ McmpMgr::McmpMgr() {
 	_numCompItems = 0;
 	_curSample = -1;
 	_compInput = nullptr;
-	_outputSize = 0;
+	_readAheadInput = nullptr;
+	_blockPool = nullptr;
 	_file = nullptr;
-	_lastBlock = -1;
+	for (int i = 0; i < NUM_DECODED_BLOCKS; i++) {
+		_decodedBlocks[i].block = -1;
+		_decodedBlocks[i].size = 0;
+		_decodedBlocks[i].data = nullptr;
+	}
+	_readAheadBlock.block = -1;
+	_readAheadBlock.size = 0;
+	_readAheadBlock.data = nullptr;
 }
 
 McmpMgr::~McmpMgr() {
 	delete[] _compTable;
 	delete[] _compInput;
+	delete[] _readAheadInput;
+	delete[] _blockPool;
 }
 
 bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData) {
@@ -83,12 +93,62 @@ bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data,
 	_file->seek(sizeCodecs, SEEK_CUR);
 	// hack: two more bytes at the end of input buffer
 	_compInput = new byte[maxSize + 2];
+	_readAheadInput = new byte[maxSize + 2];
 	offsetData = headerSize;
 
+	// All the decoded blocks share a single allocation, including the one
+	// readAhead() decodes into before swapping it into the ring
+	_blockPool = new byte[(NUM_DECODED_BLOCKS + 1) * BLOCK_SIZE];
+	for (i = 0; i < NUM_DECODED_BLOCKS; i++) {
+		_decodedBlocks[i].data = _blockPool + i * BLOCK_SIZE;
+	}
+	_readAheadBlock.data = _blockPool + NUM_DECODED_BLOCKS * BLOCK_SIZE;
+
 	return true;
 }
 
-int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
+void McmpMgr::decodeBlock(int block, byte *input, DecodedBlock &decoded) {
+	// hack: two more zero bytes at the end of input buffer
+	input[_compTable[block].compSize] = 0;
+	input[_compTable[block].compSize + 1] = 0;
+	{
+		Common::StackLock lock(_fileMutex);
+		_file->seek(_compTable[block].offset, SEEK_SET);
+		_file->read(input, _compTable[block].compSize);
+	}
+
+	decoded.size = _compTable[block].decompSize;
+	if (decoded.size > BLOCK_SIZE) {
+		error("McmpMgr::decodeBlock() _outputSize: %d", decoded.size);
+	}
+	decompressVima(input, (int16 *)decoded.data, decoded.size, imuseDestTable);
+	decoded.block = block;
+}
+
+void McmpMgr::readAhead(int32 offset) {
+	if (!_file)
+		return;
+
+	int first_block = offset / BLOCK_SIZE;
+	int last_block = MIN<int>(first_block + NUM_READ_AHEAD_BLOCKS, _numCompItems - 1);
+
+	for (int i = first_block; i <= last_block; i++) {
+		{
+			Common::StackLock lock(_mutex);
+			if (_decodedBlocks[i % NUM_DECODED_BLOCKS].block == i)
+				continue;
+		}
+
+		decodeBlock(i, _readAheadInput, _readAheadBlock);
+
+		// Publish the block, the previous content of its slot is recycled
+		Common::StackLock lock(_mutex);
+		SWAP(_decodedBlocks[i % NUM_DECODED_BLOCKS], _readAheadBlock);
+		_readAheadBlock.block = -1;
+	}
+}
+
+int32 McmpMgr::decompressSample(int32 offset, int32 size, byte *buf) {
 	int32 i, final_size, output_size;
 	int skip, first_block, last_block;
 
@@ -97,44 +157,32 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 		return 0;
 	}
 
-	first_block = offset / 0x2000;
-	last_block = (offset + size - 1) / 0x2000;
-	skip = offset % 0x2000;
+	first_block = offset / BLOCK_SIZE;
+	last_block = (offset + size - 1) / BLOCK_SIZE;
+	skip = offset % BLOCK_SIZE;
 
 	// Clip last_block by the total number of blocks (= "comp items")
 	if ((last_block >= _numCompItems) && (_numCompItems > 0))
 		last_block = _numCompItems - 1;
 
-	int32 blocks_final_size = 0x2000 * (1 + last_block - first_block);
-	*comp_final = new byte[blocks_final_size];
+	Common::StackLock lock(_mutex);
 	final_size = 0;
 
 	for (i = first_block; i <= last_block; i++) {
-		if (_lastBlock != i) {
-			// hack: two more zero bytes at the end of input buffer
-			_compInput[_compTable[i].compSize] = 0;
-			_compInput[_compTable[i].compSize + 1] = 0;
-			_file->seek(_compTable[i].offset, SEEK_SET);
-			_file->read(_compInput, _compTable[i].compSize);
-			decompressVima(_compInput, (int16 *)_compOutput, _compTable[i].decompSize, imuseDestTable);
-			_outputSize = _compTable[i].decompSize;
-			if (_outputSize > 0x2000) {
-				error("McmpMgr::decompressSample() _outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
+		// Usually already decoded by readAhead()
+		DecodedBlock &decoded = _decodedBlocks[i % NUM_DECODED_BLOCKS];
+		if (decoded.block != i)
+			decodeBlock(i, _compInput, decoded);
 
-		output_size = _outputSize - skip;
+		output_size = decoded.size - skip;
 
-		if ((output_size + skip) > 0x2000) // workaround
-			output_size -= (output_size + skip) - 0x2000;
+		if ((output_size + skip) > BLOCK_SIZE) // workaround
+			output_size -= (output_size + skip) - BLOCK_SIZE;
 
 		if (output_size > size)
 			output_size = size;
 
-		assert(final_size + output_size <= blocks_final_size);
-
-		memcpy(*comp_final + final_size, _compOutput + skip, output_size);
+		memcpy(buf + final_size, decoded.data + skip, output_size);
 		final_size += output_size;
 
 		size -= output_size;
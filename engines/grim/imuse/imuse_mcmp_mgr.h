@@ -23,6 +23,8 @@
 #ifndef GRIM_MCMP_MGR_H
 #define GRIM_MCMP_MGR_H
 
+#include "common/mutex.h"
+
 namespace Grim {
 
 class McmpMgr {
@@ -35,14 +37,33 @@ private:
 		int32 offset;
 	};
 
+	// Decoded blocks are kept in a ring, block i lives in slot i % NUM_DECODED_BLOCKS.
+	// The ring belongs to the sound, all the tracks playing it share it.
+	enum {
+		BLOCK_SIZE = 0x2000,
+		NUM_DECODED_BLOCKS = 8,
+		NUM_READ_AHEAD_BLOCKS = NUM_DECODED_BLOCKS - 1
+	};
+
+	struct DecodedBlock {
+		int block;
+		int32 size;
+		byte *data;
+	};
+
 	CompTable *_compTable;
 	int16 _numCompItems;
 	int _curSample;
 	Common::SeekableReadStream *_file;
-	byte _compOutput[0x2000];
 	byte *_compInput;
-	int _outputSize;
-	int _lastBlock;
+	byte *_readAheadInput;
+	byte *_blockPool;
+	DecodedBlock _decodedBlocks[NUM_DECODED_BLOCKS];
+	DecodedBlock _readAheadBlock;
+	Common::Mutex _mutex;		// guards _decodedBlocks
+	Common::Mutex _fileMutex;	// guards _file
+
+	void decodeBlock(int block, byte *input, DecodedBlock &decoded);
 
 public:
 
@@ -50,7 +71,21 @@ public:
 	~McmpMgr();
 
 	bool openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData);
-	int32 decompressSample(int32 offset, int32 size, byte **comp_final);
+
+	/**
+	 * Copy the decoded samples at the given offset into the given buffer,
+	 * which must be able to hold size bytes.
+	 * @return the number of bytes copied
+	 */
+	int32 decompressSample(int32 offset, int32 size, byte *buf);
+
+	/**
+	 * Decode the blocks following the given offset, so that the next calls
+	 * to decompressSample() only have to copy already decoded samples.
+	 * The blocks are decoded aside and only the finished ones are put into
+	 * the ring, so decompressSample() never waits for the disk because of it.
+	 */
+	void readAhead(int32 offset);
 };
 
 } // end of namespace Grim
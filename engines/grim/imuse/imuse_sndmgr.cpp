@@ -215,6 +215,11 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 void ImuseSndMgr::closeSound(SoundDesc *sound) {
 	assert(checkForProperHandle(sound));
 
+	if (sound->readAheadCount > 0) {
+		sound->closePending = true;
+		return;
+	}
+
 	if (sound->mcmpMgr) {
 		delete sound->mcmpMgr;
 		sound->mcmpMgr = nullptr;
@@ -338,7 +343,7 @@ int ImuseSndMgr::getJumpFade(SoundDesc *sound, int number) {
 	return sound->jump[number].fadeDelay;
 }
 
-int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size) {
+int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size) {
 	assert(checkForProperHandle(sound));
 	assert(buf && offset >= 0 && size >= 0);
 	assert(region >= 0 && region < sound->numRegions);
@@ -356,12 +361,34 @@ int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, i
 	if (sound->mcmpData) {
 		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, buf);
 	} else {
-		*buf = new byte[size];
 		sound->inStream->seek(region_offset + offset + sound->headerSize, SEEK_SET);
-		sound->inStream->read(*buf, size);
+		sound->inStream->read(buf, size);
 	}
 
 	return size;
 }
 
+void ImuseSndMgr::holdSound(SoundDesc *sound) {
+	assert(checkForProperHandle(sound));
+	sound->readAheadCount++;
+}
+
+void ImuseSndMgr::releaseSound(SoundDesc *sound) {
+	assert(checkForProperHandle(sound));
+	assert(sound->readAheadCount > 0);
+
+	sound->readAheadCount--;
+	if (sound->readAheadCount == 0 && sound->closePending)
+		closeSound(sound);
+}
+
+void ImuseSndMgr::readAhead(SoundDesc *sound, int region, int32 offset) {
+	assert(checkForProperHandle(sound));
+	assert(region >= 0 && region < sound->numRegions);
+
+	// Uncompressed sounds are read straight from the stream
+	if (sound->mcmpData)
+		sound->mcmpMgr->readAhead(sound->region[region].offset + offset);
+}
+
 } // end of namespace Grim
@@ -77,6 +77,8 @@ public:
 		bool mcmpData;
 		uint32 headerSize;
 		Common::SeekableReadStream *inStream;
+		int readAheadCount; // number of readAhead() calls in progress
+		bool closePending;  // closed while read ahead, freed by the last releaseSound()
 	};
 
 private:
@@ -111,7 +113,16 @@ public:
 	int getJumpHookId(SoundDesc *sound, int number);
 	int getJumpFade(SoundDesc *sound, int number);
 
-	int32 getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size);
+	int32 getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size);
+
+	/**
+	 * Keep the sound open until the matching releaseSound(), even if
+	 * closeSound() is called in the meantime. This allows readAhead()
+	 * to be called without holding the lock of the callers of closeSound().
+	 */
+	void holdSound(SoundDesc *sound);
+	void releaseSound(SoundDesc *sound);
+	void readAhead(SoundDesc *sound, int region, int32 offset);
 };
 
 } // end of namespace Grim
@@ -165,6 +165,7 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 	g_system->getMixer()->playStream(track->getType(), &track->handle, track->stream, -1,
 											track->getVol(), track->getPan(), DisposeAfterUse::YES,
 											false, (track->mixerFlags & kFlagReverseStereo) != 0);
+	addStreamBuffers(track);
 	track->used = true;
 
 	return true;
@@ -402,6 +403,7 @@ Track *Imuse::cloneToFadeOutTrack(Track *track, int fadeDelay) {
 	g_system->getMixer()->playStream(track->getType(), &fadeTrack->handle, fadeTrack->stream, -1, fadeTrack->getVol(),
 											fadeTrack->getPan(), DisposeAfterUse::YES, false,
 											(track->mixerFlags & kFlagReverseStereo) != 0);
+	addStreamBuffers(fadeTrack);
 	fadeTrack->used = true;
 
 	return fadeTrack;
@@ -22,7 +22,6 @@
 
 #include "common/file.h"
 #include "common/substream.h"
-#include "common/memstream.h"
 
 #include "engines/grim/grim.h"
 #include "engines/grim/lab.h"
@@ -38,12 +37,13 @@ Common::SeekableReadStream *LabEntry::createReadStream() const {
 	return _parent->createReadStreamForMember(_name);
 }
 
+// On 32-bit systems, only map the labs small enough not to exhaust the address space
+static const uint32 kMaxMappedLabSize = 64 * 1024 * 1024;
+
 Lab::Lab() {
-	_stream = nullptr;
 }
 
 Lab::~Lab() {
-	delete _stream;
 }
 
 bool Lab::open(const Common::String &filename, bool keepStream) {
@@ -62,11 +62,17 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 		else
 			parseMonkey4FileTable(file);
 	}
-	if (result && keepStream) {
-		file->seek(0, SEEK_SET);
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * file->size()));
-		file->read(data, file->size());
-		_stream = new Common::MemoryReadStream(data, file->size(), DisposeAfterUse::YES);
+	if (result && (sizeof(void *) >= 8 || (uint32)file->size() <= kMaxMappedLabSize)) {
+		Common::ArchiveMemberPtr member = SearchMan.getMember(filename);
+		if (member)
+			_mappedFile = Common::MappedFilePtr(member->createMappedFile());
+
+		// Make sure the mapping refers to the file the table was read from
+		if (_mappedFile && _mappedFile->size() != (uint32)file->size())
+			_mappedFile.reset();
+	}
+	if (result && keepStream && !_mappedFile) {
+		_mappedFile = Common::MappedFilePtr(Common::MappedFile::createFromStream(*file));
 	}
 	delete file;
 
@@ -180,15 +186,12 @@ Common::SeekableReadStream *Lab::createReadStreamForMember(const Common::String
 	fname.toLowercase();
 	LabEntryPtr i = _entries[fname];
 
-	if (!_stream) {
+	if (_mappedFile) {
+		return new Common::MappedFileReadStream(_mappedFile, i->_offset, i->_len);
+	} else {
 		Common::File *file = new Common::File();
 		file->open(_labFileName);
 		return new Common::SeekableSubReadStream(file, i->_offset, i->_offset + i->_len, DisposeAfterUse::YES);
-	} else {
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * i->_len));
-		_stream->seek(i->_offset, SEEK_SET);
-		_stream->read(data, i->_len);
-		return new Common::MemoryReadStream(data, i->_len, DisposeAfterUse::YES);
 	}
 }
 
@@ -24,6 +24,7 @@
 #define GRIM_LAB_H
 
 #include "common/archive.h"
+#include "common/mappedfile.h"
 
 namespace Common {
 	class File;
@@ -63,7 +64,7 @@ private:
 	typedef Common::SharedPtr<LabEntry> LabEntryPtr;
 	typedef Common::HashMap<Common::String, LabEntryPtr, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> LabMap;
 	LabMap _entries;
-	Common::SeekableReadStream *_stream;
+	Common::MappedFilePtr _mappedFile;
 };
 
 } // end of namespace Grim
@@ -267,7 +267,17 @@ bool SmushDecoder::loadStream(Common::SeekableReadStream *stream) {
 }
 
 const Graphics::Surface *SmushDecoder::decodeNextFrame() {
-	handleFrame();
+	if (_videoTrack->endOfTrack()) { // Looping is handled outside, by rewinding the video.
+		_audioTrack->stop(); // HACK: Avoids the movie playing past the last frame
+		//  pauseVideo(true);
+		return _videoTrack->decodeNextFrame();
+	}
+
+	// Show the next decoded frame, only decoding it now if it was not decoded ahead of time
+	if (!_videoTrack->hasQueuedFrames() && !decodeAhead()) {
+		return _videoTrack->decodeNextFrame();
+	}
+	_videoTrack->presentFrame();
 
 	// We might be interested in getting the last frame even after the video ends:
 	if (endOfVideo()) {
@@ -276,6 +286,15 @@ const Graphics::Surface *SmushDecoder::decodeNextFrame() {
 	return VideoDecoder::decodeNextFrame();
 }
 
+bool SmushDecoder::decodeAhead() {
+	if (!_videoTrack || isPaused() || _videoTrack->isQueueFull() || _videoTrack->endOfDecoding()) {
+		return false;
+	}
+
+	handleFrame();
+	return true;
+}
+
 void SmushDecoder::setLooping(bool l) {
 	_videoLooping = l;
 
@@ -288,16 +307,6 @@ void SmushDecoder::handleFrame() {
 	uint32 tag;
 	int32 size;
 
-	if (isPaused()) {
-		return;
-	}
-
-	if (_videoTrack->endOfTrack()) { // Looping is handled outside, by rewinding the video.
-		_audioTrack->stop(); // HACK: Avoids the movie playing past the last frame
-		//  pauseVideo(true);
-		return;
-	}
-
 	tag = _file->readUint32BE();
 	size = _file->readUint32BE();
 	if (tag == MKTAG('A', 'N', 'N', 'O')) {
@@ -414,6 +423,7 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 		keyframe = 0;
 	}
 
+	// The frames decoded ahead of time are dropped
 	_file->seek(_frames[keyframe].pos, SEEK_SET);
 	_videoTrack->setCurFrame(keyframe - 1);
 
@@ -466,8 +476,14 @@ SmushDecoder::SmushVideoTrack::SmushVideoTrack(int width, int height, int fps, i
 	_is16Bit = is16Bit;
 	_x = 0;
 	_y = 0;
+	_decodedX = 0;
+	_decodedY = 0;
 	setMsPerFrame(fps);
 	_curFrame = 0;
+	_decodedFrame = 0;
+	_queueStart = 0;
+	_queueCount = 0;
+	_shownSurface = &_surface;
 	for (int i = 0; i < 0x300; i++) {
 		_pal[i] = 0;
 		_deltaPal[i] = 0;
@@ -480,20 +496,54 @@ SmushDecoder::SmushVideoTrack::~SmushVideoTrack() {
 	delete _blocky8;
 	delete _blocky16;
 	_surface.free();
+	for (int i = 0; i < kFrameQueueSize; i++) {
+		_queue[i].surface.free();
+	}
 }
 
 void SmushDecoder::SmushVideoTrack::init() {
-	_curFrame = -1;
+	setCurFrame(-1);
 	_frameStart = -1;
 	if (_is16Bit) { // Retail only
 		_surface.create(_width, _height, _format);
 	}
 }
 
+void SmushDecoder::SmushVideoTrack::setCurFrame(int frame) {
+	_curFrame = frame;
+	_decodedFrame = frame;
+	clearQueue();
+	_shownSurface = &_surface;
+}
+
 void SmushDecoder::SmushVideoTrack::finishFrame() {
 	if (!_is16Bit) {
 		convertDemoFrame();
 	}
+	_decodedFrame++;
+
+	// The codecs decode the next frame over the current one, so it is copied to the queue
+	QueuedFrame &queued = _queue[(_queueStart + _queueCount) % kFrameQueueSize];
+	if (queued.surface.w != _surface.w || queued.surface.h != _surface.h) {
+		queued.surface.create(_surface.w, _surface.h, _format);
+	}
+	if (_surface.w > 0 && _surface.h > 0) {
+		queued.surface.copyRectToSurface(_surface, 0, 0, Common::Rect(_surface.w, _surface.h));
+	}
+	queued.x = _decodedX;
+	queued.y = _decodedY;
+	_queueCount++;
+}
+
+void SmushDecoder::SmushVideoTrack::presentFrame() {
+	assert(_queueCount > 0);
+
+	QueuedFrame &queued = _queue[_queueStart];
+	_shownSurface = &queued.surface;
+	_x = queued.x;
+	_y = queued.y;
+	_queueStart = (_queueStart + 1) % kFrameQueueSize;
+	_queueCount--;
 	_curFrame++;
 }
 
@@ -515,7 +565,7 @@ void SmushDecoder::SmushVideoTrack::convertDemoFrame() {
 }
 
 void SmushDecoder::SmushVideoTrack::handleBlocky16(Common::SeekableReadStream *stream, uint32 size) {
-	if (_curFrame < _frameStart) {
+	if (_decodedFrame < _frameStart) {
 		return;
 	}
 
@@ -528,7 +578,7 @@ void SmushDecoder::SmushVideoTrack::handleBlocky16(Common::SeekableReadStream *s
 }
 
 void SmushDecoder::SmushVideoTrack::handleFrameObject(Common::SeekableReadStream *stream, uint32 size) {
-	if (_curFrame < _frameStart) {
+	if (_decodedFrame < _frameStart) {
 		return;
 	}
 
@@ -537,8 +587,8 @@ void SmushDecoder::SmushVideoTrack::handleFrameObject(Common::SeekableReadStream
 	byte codec = stream->readByte();
 	assert(codec == 47 || codec == 48);
 	/* byte codecParam = */ stream->readByte();
-	_x = stream->readSint16LE();
-	_y = stream->readSint16LE();
+	_decodedX = stream->readSint16LE();
+	_decodedY = stream->readSint16LE();
 	uint16 width = stream->readUint16LE();
 	uint16 height = stream->readUint16LE();
 	if (width != _width || height != _height) {
@@ -585,7 +635,7 @@ void SmushDecoder::SmushVideoTrack::handleDeltaPalette(Common::SeekableReadStrea
 }
 
 Graphics::Surface *SmushDecoder::SmushVideoTrack::decodeNextFrame() {
-	return &_surface;
+	return _shownSurface;
 }
 
 void SmushDecoder::SmushVideoTrack::setMsPerFrame(int ms) {
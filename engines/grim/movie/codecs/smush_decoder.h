@@ -53,6 +53,14 @@ public:
 	bool seekIntern(const Audio::Timestamp &time) override;
 	bool loadStream(Common::SeekableReadStream *stream) override;
 
+	/**
+	 * Decode the next frame ahead of time, if the queue of decoded frames
+	 * is not full. The queued frames are shown by decodeNextFrame().
+	 *
+	 * @return true if a frame was decoded
+	 */
+	bool decodeAhead();
+
 protected:
 	bool readHeader();
 	void handleFrameDemo();
@@ -71,12 +79,18 @@ protected:
 		uint16 getHeight() const override { return _height; }
 		Graphics::PixelFormat getPixelFormat() const override { return _format; }
 		int getCurFrame() const override { return _curFrame; }
-		void setCurFrame(int frame) { _curFrame = frame; }
+		void setCurFrame(int frame);
 		int getFrameCount() const override {	return _nbframes; }
 		Common::Rational getFrameRate() const override { return _frameRate; }
 		void setMsPerFrame(int ms);
 
 		void finishFrame();
+		void presentFrame();
+		void clearQueue() { _queueStart = _queueCount = 0; }
+		bool hasQueuedFrames() const { return _queueCount > 0; }
+		// One slot holds the frame being shown, it is not overwritten
+		bool isQueueFull() const { return _queueCount >= kFrameQueueSize - 1; }
+		bool endOfDecoding() const { return _decodedFrame >= _nbframes - 1; }
 		bool isSeekable() const override { return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		void setFrameStart(int frame);
@@ -90,9 +104,23 @@ protected:
 		byte *getPal() { return _pal; }
 		int _x, _y;
 	private:
+		enum {
+			kFrameQueueSize = 4
+		};
+
+		struct QueuedFrame {
+			Graphics::Surface surface;
+			int x, y;
+		};
+
 		void convertDemoFrame();
 		bool _is16Bit;
-		int32 _curFrame;
+		int32 _curFrame;     ///< The frame being shown
+		int32 _decodedFrame; ///< The last decoded frame, ahead of the shown one
+		int _decodedX, _decodedY;
+		QueuedFrame _queue[kFrameQueueSize];
+		uint _queueStart, _queueCount;
+		Graphics::Surface *_shownSurface;
 		byte _pal[0x300];
 		int16 _deltaPal[0x300];
 		int _width, _height;
@@ -22,6 +22,7 @@
 
 #include "graphics/surface.h"
 
+#include "common/profiler.h"
 #include "common/system.h"
 #include "common/timer.h"
 
@@ -78,6 +79,7 @@ void MoviePlayer::stop() {
 void MoviePlayer::timerCallback(void *instance) {
 	MoviePlayer *movie = static_cast<MoviePlayer *>(instance);
 	Common::StackLock lock(movie->_frameMutex);
+	PROFILE_THREAD_ZONE("Video decode", kThreadTimer);
 	if (movie->prepareFrame())
 		movie->postHandleFrame();
 }
@@ -55,6 +55,20 @@ void SmushPlayer::init() {
 	MoviePlayer::init();
 }
 
+bool SmushPlayer::prepareFrame() {
+	if (MoviePlayer::prepareFrame())
+		return true;
+
+	// Use the timer calls between two frames to decode the next ones, so that
+	// the frames with a lot of changes do not delay the movie. The decoding waits
+	// for the engine to fetch the current frame, so the engine does not wait
+	// for the frame mutex.
+	if (!_videoPause && !_videoFinished && !_updateNeeded)
+		_smushDecoder->decodeAhead();
+
+	return false;
+}
+
 void SmushPlayer::handleFrame() {
 	// Force the last frame to stay in place for it's duration:
 	if (_videoDecoder->endOfVideo() && _videoDecoder->getTime() >= (uint32)_videoDecoder->getDuration().msecs()) {
@@ -37,6 +37,7 @@ public:
 
 private:
 	bool loadFile(const Common::String &filename) override;
+	bool prepareFrame() override;
 	void handleFrame() override;
 	void postHandleFrame() override;
 	void init() override;
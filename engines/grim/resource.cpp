@@ -56,6 +56,26 @@ namespace Grim {
 
 ResourceLoader *g_resourceloader = nullptr;
 
+/**
+ * A stream over a file of the cache. The file can't be evicted
+ * from the cache as long as the stream is alive.
+ */
+class CachedFileStream : public Common::MemoryReadStream {
+public:
+	CachedFileStream(ResourceLoader::ResourceCache *entry) :
+			Common::MemoryReadStream(entry->resPtr, entry->len),
+			_entry(entry) {
+		_entry->refCount++;
+	}
+
+	~CachedFileStream() {
+		_entry->refCount--;
+	}
+
+private:
+	ResourceLoader::ResourceCache *_entry;
+};
+
 class LabListComperator {
 	const Common::String _labName;
 public:
@@ -72,8 +92,15 @@ public:
 };
 
 ResourceLoader::ResourceLoader() {
-	_cacheDirty = false;
+	_cacheLeastRecent = nullptr;
+	_cacheMostRecent = nullptr;
 	_cacheMemorySize = 0;
+	_cacheMemoryBudget = ConfMan.getInt("resource_cache_size") * 1024 * 1024;
+	_cacheHits = 0;
+	_cacheMisses = 0;
+	_cacheEvictions = 0;
+	_resourceHits = 0;
+	_resourceMisses = 0;
 
 	Lab *l;
 	Common::ArchiveMemberList files, updFiles;
@@ -211,54 +238,41 @@ ResourceLoader::ResourceLoader() {
 	files.clear();
 }
 
-template<typename T>
-void clearList(Common::List<T> &list) {
-	while (!list.empty()) {
-		T p = list.front();
-		list.erase(list.begin());
-		delete p;
-	}
-}
-
 ResourceLoader::~ResourceLoader() {
-	for (Common::Array<ResourceCache>::iterator i = _cache.begin(); i != _cache.end(); ++i) {
-		ResourceCache &r = *i;
-		delete[] r.fname;
-		delete[] r.resPtr;
+	while (_cacheLeastRecent) {
+		removeFromCache(_cacheLeastRecent);
 	}
-	clearList(_models);
-	clearList(_colormaps);
-	clearList(_keyframeAnims);
-	clearList(_lipsyncs);
+	_models.deleteAll();
+	_colormaps.deleteAll();
+	_keyframeAnims.deleteAll();
+	_lipsyncs.deleteAll();
 	MD5Check::clear();
 }
 
-static int sortCallback(const void *entry1, const void *entry2) {
-	return scumm_stricmp(((const ResourceLoader::ResourceCache *)entry1)->fname, ((const ResourceLoader::ResourceCache *)entry2)->fname);
-}
-
 Common::SeekableReadStream *ResourceLoader::getFileFromCache(const Common::String &filename) const {
 	ResourceLoader::ResourceCache *entry = getEntryFromCache(filename);
 	if (!entry)
 		return nullptr;
 
-	return new Common::MemoryReadStream(entry->resPtr, entry->len);
+	return new CachedFileStream(entry);
 
 }
 
 ResourceLoader::ResourceCache *ResourceLoader::getEntryFromCache(const Common::String &filename) const {
-	if (_cache.empty())
+	CacheMap::const_iterator it = _cache.find(filename);
+	if (it == _cache.end()) {
+		_cacheMisses++;
 		return nullptr;
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
 	}
 
-	ResourceCache key;
-	key.fname = const_cast<char *>(filename.c_str());
+	_cacheHits++;
+
+	// Move the entry to the most recently used end of the list
+	ResourceCache *entry = it->_value;
+	unlinkCacheEntry(entry);
+	linkCacheEntry(entry);
 
-	return (ResourceLoader::ResourceCache *)bsearch(&key, _cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
+	return entry;
 }
 
 Common::SeekableReadStream *ResourceLoader::loadFile(const Common::String &filename) const {
@@ -286,9 +300,9 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 			uint32 size = s->size();
 			byte *buf = new byte[size];
 			s->read(buf, size);
-			putIntoCache(fname, buf, size);
+			ResourceCache *entry = putIntoCache(fname, buf, size);
 			delete s;
-			s = new Common::MemoryReadStream(buf, size);
+			s = new CachedFileStream(entry);
 		}
 	} else {
 		s = loadFile(fname);
@@ -297,15 +311,94 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 	return Common::wrapCompressedReadStream(s);
 }
 
-void ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
-	ResourceCache entry;
-	entry.resPtr = res;
-	entry.len = len;
-	entry.fname = new char[fname.size() + 1];
-	strcpy(entry.fname, fname.c_str());
+ResourceLoader::ResourceCache *ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
 	_cacheMemorySize += len;
-	_cache.push_back(entry);
-	_cacheDirty = true;
+	enforceCacheBudget();
+
+	ResourceCache *entry = new ResourceCache();
+	entry->fname = fname;
+	entry->resPtr = res;
+	entry->len = len;
+	entry->refCount = 0;
+	linkCacheEntry(entry);
+	_cache[fname] = entry;
+
+	return entry;
+}
+
+void ResourceLoader::removeFromCache(ResourceCache *entry) const {
+	unlinkCacheEntry(entry);
+	_cache.erase(entry->fname);
+	_cacheMemorySize -= entry->len;
+	delete[] entry->resPtr;
+	delete entry;
+}
+
+void ResourceLoader::unlinkCacheEntry(ResourceCache *entry) const {
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		_cacheLeastRecent = entry->next;
+
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		_cacheMostRecent = entry->prev;
+
+	entry->prev = entry->next = nullptr;
+}
+
+void ResourceLoader::linkCacheEntry(ResourceCache *entry) const {
+	entry->prev = _cacheMostRecent;
+	entry->next = nullptr;
+
+	if (_cacheMostRecent)
+		_cacheMostRecent->next = entry;
+	else
+		_cacheLeastRecent = entry;
+	_cacheMostRecent = entry;
+}
+
+void ResourceLoader::enforceCacheBudget() const {
+	ResourceCache *entry = _cacheLeastRecent;
+	while (entry && _cacheMemorySize > _cacheMemoryBudget) {
+		ResourceCache *next = entry->next;
+
+		// Files still being read from stay in the cache
+		if (entry->refCount == 0) {
+			debug(5, "Evicting %s from the resource cache", entry->fname.c_str());
+			removeFromCache(entry);
+			_cacheEvictions++;
+		}
+
+		entry = next;
+	}
+}
+
+void ResourceLoader::setCacheMemoryBudget(uint32 budget) {
+	_cacheMemoryBudget = budget;
+	enforceCacheBudget();
+}
+
+ResourceLoader::CacheStatistics ResourceLoader::getCacheStatistics() const {
+	CacheStatistics stats;
+	stats.entries = _cache.size();
+	stats.memorySize = _cacheMemorySize;
+	stats.memoryBudget = _cacheMemoryBudget;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.evictions = _cacheEvictions;
+	stats.resourceHits = _resourceHits;
+	stats.resourceMisses = _resourceMisses;
+	return stats;
+}
+
+void ResourceLoader::resetCacheStatistics() {
+	_cacheHits = 0;
+	_cacheMisses = 0;
+	_cacheEvictions = 0;
+	_resourceHits = 0;
+	_resourceMisses = 0;
 }
 
 CMap *ResourceLoader::loadColormap(const Common::String &filename) {
@@ -315,7 +408,7 @@ CMap *ResourceLoader::loadColormap(const Common::String &filename) {
 	}
 
 	CMap *result = new CMap(filename, stream);
-	_colormaps.push_back(result);
+	_colormaps.add(result);
 	delete stream;
 
 	return result;
@@ -379,7 +472,7 @@ KeyframeAnim *ResourceLoader::loadKeyframe(const Common::String &filename) {
 		error("Could not find keyframe file %s", filename.c_str());
 
 	KeyframeAnim *result = new KeyframeAnim(filename, stream);
-	_keyframeAnims.push_back(result);
+	_keyframeAnims.add(result);
 	delete stream;
 
 	return result;
@@ -397,7 +490,7 @@ LipSync *ResourceLoader::loadLipSync(const Common::String &filename) {
 
 	// Some lipsync files have no data
 	if (result->isValid())
-		_lipsyncs.push_back(result);
+		_lipsyncs.add(result);
 	else {
 		delete result;
 		result = nullptr;
@@ -440,7 +533,7 @@ Model *ResourceLoader::loadModel(const Common::String &filename, CMap *c, Model
 		error("Could not find model %s", filename.c_str());
 
 	Model *result = new Model(filename, stream, c, parent);
-	_models.push_back(result);
+	_models.add(result);
 	delete stream;
 
 	return result;
@@ -509,30 +602,16 @@ AnimationEmi *ResourceLoader::loadAnimationEmi(const Common::String &filename) {
 	}
 
 	AnimationEmi *result = new AnimationEmi(filename, stream);
-	_emiAnims.push_back(result);
+	_emiAnims.add(result);
 	delete stream;
 
 	return result;
 }
 
 void ResourceLoader::uncache(const char *filename) const {
-	Common::String fname = filename;
-	fname.toLowercase();
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
-	}
-
-	for (unsigned int i = 0; i < _cache.size(); i++) {
-		if (fname.compareTo(_cache[i].fname) == 0) {
-			delete[] _cache[i].fname;
-			_cacheMemorySize -= _cache[i].len;
-			delete[] _cache[i].resPtr;
-			_cache.remove_at(i);
-			_cacheDirty = true;
-		}
-	}
+	CacheMap::const_iterator it = _cache.find(filename);
+	if (it != _cache.end() && it->_value->refCount == 0)
+		removeFromCache(it->_value);
 }
 
 void ResourceLoader::uncacheModel(Model *m) {
@@ -558,65 +637,70 @@ void ResourceLoader::uncacheAnimationEmi(AnimationEmi *a) {
 ModelPtr ResourceLoader::getModel(const Common::String &fname, CMap *c) {
 	Common::String filename = fname;
 	filename.toLowercase();
-	for (Common::List<Model *>::const_iterator i = _models.begin(); i != _models.end(); ++i) {
-		Model *m = *i;
-		if (filename == m->getFilename() && *m->getCMap() == *c) {
-			return m;
+	const ResourceRegistry<Model>::ResourceList *models = _models.find(filename);
+	if (models) {
+		for (uint i = 0; i < models->size(); ++i) {
+			Model *m = (*models)[i];
+			if (*m->getCMap() == *c) {
+				_resourceHits++;
+				return m;
+			}
 		}
 	}
 
+	_resourceMisses++;
 	return loadModel(fname, c);
 }
 
 CMapPtr ResourceLoader::getColormap(const Common::String &fname) {
 	Common::String filename = fname;
 	filename.toLowercase();
-	for (Common::List<CMap *>::const_iterator i = _colormaps.begin(); i != _colormaps.end(); ++i) {
-		CMap *c = *i;
-		if (filename.equals(c->_fname)) {
-			return c;
-		}
+	const ResourceRegistry<CMap>::ResourceList *colormaps = _colormaps.find(filename);
+	if (colormaps) {
+		_resourceHits++;
+		return colormaps->front();
 	}
 
+	_resourceMisses++;
 	return loadColormap(fname);
 }
 
 KeyframeAnimPtr ResourceLoader::getKeyframe(const Common::String &fname) {
 	Common::String filename = fname;
 	filename.toLowercase();
-	for (Common::List<KeyframeAnim *>::const_iterator i = _keyframeAnims.begin(); i != _keyframeAnims.end(); ++i) {
-		KeyframeAnim *k = *i;
-		if (filename == k->getFilename()) {
-			return k;
-		}
+	const ResourceRegistry<KeyframeAnim>::ResourceList *keyframes = _keyframeAnims.find(filename);
+	if (keyframes) {
+		_resourceHits++;
+		return keyframes->front();
 	}
 
+	_resourceMisses++;
 	return loadKeyframe(fname);
 }
 
 LipSyncPtr ResourceLoader::getLipSync(const Common::String &fname) {
 	Common::String filename = fname;
 	filename.toLowercase();
-	for (Common::List<LipSync *>::const_iterator i = _lipsyncs.begin(); i != _lipsyncs.end(); ++i) {
-		LipSync *l = *i;
-		if (filename == l->getFilename()) {
-			return l;
-		}
+	const ResourceRegistry<LipSync>::ResourceList *lipsyncs = _lipsyncs.find(filename);
+	if (lipsyncs) {
+		_resourceHits++;
+		return lipsyncs->front();
 	}
 
+	_resourceMisses++;
 	return loadLipSync(fname);
 }
 
 AnimationEmiPtr ResourceLoader::getAnimationEmi(const Common::String &fname) {
 	Common::String filename = fname;
 	filename.toLowercase();
-	for (Common::List<AnimationEmi *>::const_iterator i = _emiAnims.begin(); i != _emiAnims.end(); ++i) {
-		AnimationEmi *a = *i;
-		if (filename == a->getFilename()) {
-			return a;
-		}
+	const ResourceRegistry<AnimationEmi>::ResourceList *anims = _emiAnims.find(filename);
+	if (anims) {
+		_resourceHits++;
+		return anims->front();
 	}
 
+	_resourceMisses++;
 	return loadAnimationEmi(fname);
 }
 
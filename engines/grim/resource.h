@@ -25,6 +25,8 @@
 
 #include "common/archive.h"
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 
 #include "engines/grim/object.h"
 
@@ -55,6 +57,57 @@ typedef ObjectPtr<Font> FontPtr;
 typedef ObjectPtr<LipSync> LipSyncPtr;
 typedef ObjectPtr<AnimationEmi> AnimationEmiPtr;
 
+/**
+ * The loaded resources of a type, indexed by their file name.
+ * Several resources may share the same file name.
+ */
+template<class T>
+class ResourceRegistry {
+public:
+	typedef Common::Array<T *> ResourceList;
+
+	void add(T *res) {
+		_resources[res->getFilename()].push_back(res);
+	}
+
+	void remove(T *res) {
+		typename ResourceMap::iterator it = _resources.find(res->getFilename());
+		if (it == _resources.end())
+			return;
+
+		ResourceList &list = it->_value;
+		for (uint i = 0; i < list.size(); ++i) {
+			if (list[i] == res) {
+				list.remove_at(i);
+				break;
+			}
+		}
+		if (list.empty())
+			_resources.erase(it);
+	}
+
+	const ResourceList *find(const Common::String &fname) const {
+		typename ResourceMap::const_iterator it = _resources.find(fname);
+		if (it == _resources.end())
+			return nullptr;
+		return &it->_value;
+	}
+
+	void deleteAll() {
+		// The resources unregister themselves when deleted
+		while (!_resources.empty()) {
+			ResourceList list = _resources.begin()->_value;
+			_resources.erase(_resources.begin());
+			for (uint i = 0; i < list.size(); ++i)
+				delete list[i];
+		}
+	}
+
+private:
+	typedef Common::HashMap<Common::String, ResourceList> ResourceMap;
+	ResourceMap _resources;
+};
+
 class ResourceLoader {
 public:
 	ResourceLoader();
@@ -85,30 +138,65 @@ public:
 	void uncacheAnimationEmi(AnimationEmi *a);
 
 	struct ResourceCache {
-		char *fname;
+		Common::String fname;
 		byte *resPtr;
 		uint32 len;
+		// Number of streams reading from resPtr, the entry can't be evicted while not 0
+		uint32 refCount;
+		// Least recently used entries come first
+		ResourceCache *prev;
+		ResourceCache *next;
+	};
+
+	struct CacheStatistics {
+		uint32 entries;
+		uint32 memorySize;
+		uint32 memoryBudget;
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 resourceHits;
+		uint32 resourceMisses;
 	};
 
 	static Common::String fixFilename(const Common::String &filename, bool append = true);
 
+	/** Set the maximum size in bytes of the file cache, evicting files if needed */
+	void setCacheMemoryBudget(uint32 budget);
+	CacheStatistics getCacheStatistics() const;
+	void resetCacheStatistics();
+
 private:
+	typedef Common::HashMap<Common::String, ResourceCache *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> CacheMap;
+
 	Common::SeekableReadStream *loadFile(const Common::String &filename) const;
 	Common::SeekableReadStream *getFileFromCache(const Common::String &filename) const;
 	ResourceLoader::ResourceCache *getEntryFromCache(const Common::String &filename) const;
-	void putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
+	ResourceCache *putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
 	void uncache(const char *fname) const;
-
-	mutable Common::Array<ResourceCache> _cache;
-	mutable bool _cacheDirty;
-	mutable int32 _cacheMemorySize;
+	void removeFromCache(ResourceCache *entry) const;
+	void unlinkCacheEntry(ResourceCache *entry) const;
+	void linkCacheEntry(ResourceCache *entry) const;
+	void enforceCacheBudget() const;
+
+	mutable CacheMap _cache;
+	mutable ResourceCache *_cacheLeastRecent;
+	mutable ResourceCache *_cacheMostRecent;
+	mutable uint32 _cacheMemorySize;
+	uint32 _cacheMemoryBudget;
+
+	mutable uint32 _cacheHits;
+	mutable uint32 _cacheMisses;
+	mutable uint32 _cacheEvictions;
+	uint32 _resourceHits;
+	uint32 _resourceMisses;
 
 	Common::List<EMIModel *> _emiModels;
-	Common::List<Model *> _models;
-	Common::List<CMap *> _colormaps;
-	Common::List<KeyframeAnim *> _keyframeAnims;
-	Common::List<LipSync *> _lipsyncs;
-	Common::List<AnimationEmi *> _emiAnims;
+	ResourceRegistry<Model> _models;
+	ResourceRegistry<CMap> _colormaps;
+	ResourceRegistry<KeyframeAnim> _keyframeAnims;
+	ResourceRegistry<LipSync> _lipsyncs;
+	ResourceRegistry<AnimationEmi> _emiAnims;
 };
 
 extern ResourceLoader *g_resourceloader;
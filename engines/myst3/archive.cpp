@@ -23,9 +23,78 @@
 #include "engines/myst3/archive.h"
 #include "common/debug.h"
 #include "common/memstream.h"
+#include "common/system.h"
 
 namespace Myst3 {
 
+ArchiveIndex::ArchiveIndex() :
+		_lookups(0),
+		_hits(0) {
+}
+
+bool ArchiveIndex::makeKey(const char *room, uint32 index, uint16 face, DirectorySubEntry::ResourceType type, Key &key) {
+	// Room names are at most four characters long, pack them in an integer
+	key.room = 0;
+	for (uint i = 0; room[i]; i++) {
+		if (i >= 4)
+			return false;
+
+		key.room |= (byte)room[i] << (i * 8);
+	}
+
+	key.index = index;
+	key.face = face;
+	key.type = type;
+	return true;
+}
+
+void ArchiveIndex::add(const char *room, uint32 index, const DirectorySubEntry *subEntry) {
+	Key key;
+	if (makeKey(room, index, subEntry->getFace(), subEntry->getType(), key))
+		_map[key].push_back(subEntry);
+}
+
+void ArchiveIndex::merge(const ArchiveIndex &other) {
+	for (IndexMap::const_iterator it = other._map.begin(); it != other._map.end(); it++) {
+		if (!_map.contains(it->_key))
+			_map[it->_key] = it->_value;
+	}
+}
+
+void ArchiveIndex::clear() {
+	_map.clear(true);
+}
+
+const DirectorySubEntryList *ArchiveIndex::find(const Common::String &room, uint32 index, uint16 face,
+                                                DirectorySubEntry::ResourceType type) const {
+	_lookups++;
+
+	Key key;
+	if (!makeKey(room.c_str(), index, face, type, key))
+		return 0;
+
+	IndexMap::const_iterator it = _map.find(key);
+	if (it == _map.end())
+		return 0;
+
+	_hits++;
+	return &it->_value;
+}
+
+uint32 ArchiveIndex::timeLookups(uint passes) const {
+	uint32 startTime = g_system->getMillis();
+
+	for (uint i = 0; i < passes; i++) {
+		for (IndexMap::const_iterator it = _map.begin(); it != _map.end(); it++) {
+			IndexMap::const_iterator found = _map.find(it->_key);
+			assert(found != _map.end());
+			(void)found;
+		}
+	}
+
+	return g_system->getMillis() - startTime;
+}
+
 void Archive::_decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream) {
 	static const uint32 addKey = 0x3C6EF35F;
 	static const uint32 multKey = 0x0019660D;
@@ -72,6 +141,26 @@ void Archive::_readDirectory() {
 	}
 }
 
+void Archive::_buildIndex() {
+	// Only the first directory entry for a given room and index is visible
+	Common::HashMap<Common::String, bool> visibleEntries;
+
+	for (uint i = 0; i < _directory.size(); i++) {
+		DirectoryEntry &entry = _directory[i];
+		const char *room = entry.getRoom();
+
+		Common::String entryKey = Common::String::format("%s-%d", room, entry.getIndex());
+		if (visibleEntries.contains(entryKey))
+			continue;
+		visibleEntries[entryKey] = true;
+
+		DirectorySubEntryList subEntries = entry.listItems();
+		for (uint j = 0; j < subEntries.size(); j++) {
+			_index.add(room, entry.getIndex(), subEntries[j]);
+		}
+	}
+}
+
 void Archive::dumpToFiles() {
 	for (uint i = 0; i < _directory.size(); i++) {
 		_directory[i].dumpToFiles(_file);
@@ -85,22 +174,18 @@ Common::MemoryReadStream *Archive::dumpToMemory(uint32 offset, uint32 size) {
 
 const DirectorySubEntry *Archive::getDescription(const Common::String &room, uint32 index, uint16 face,
                                                  DirectorySubEntry::ResourceType type) {
-	for (uint i = 0; i < _directory.size(); i++) {
-		if (_directory[i].getIndex() == index && _directory[i].getRoom() == room) {
-			return _directory[i].getItemDescription(face, type);
-		}
-	}
+	const DirectorySubEntryList *subEntries = _index.find(room, index, face, type);
+	if (subEntries)
+		return subEntries->front();
 
 	return 0;
 }
 
 DirectorySubEntryList Archive::listFilesMatching(const Common::String &room, uint32 index, uint16 face,
                                                  DirectorySubEntry::ResourceType type) {
-	for (uint i = 0; i < _directory.size(); i++) {
-		if (_directory[i].getIndex() == index && _directory[i].getRoom() == room) {
-			return _directory[i].listItemsMatching(face, type);
-		}
-	}
+	const DirectorySubEntryList *subEntries = _index.find(room, index, face, type);
+	if (subEntries)
+		return *subEntries;
 
 	return DirectorySubEntryList();
 }
@@ -115,6 +200,7 @@ bool Archive::open(const char *fileName, const char *room) {
 
 	if (_file.open(fileName)) {
 		_readDirectory();
+		_buildIndex();
 		return true;
 	}
 	
@@ -122,6 +208,7 @@ bool Archive::open(const char *fileName, const char *room) {
 }
 
 void Archive::close() {
+	_index.clear();
 	_directory.clear();
 	_file.close();
 }
@@ -27,18 +27,80 @@
 #include "common/stream.h"
 #include "common/array.h"
 #include "common/file.h"
+#include "common/hashmap.h"
 
 namespace Myst3 {
 
+/**
+ * Hash index of archive resources keyed on room, index, face and type.
+ *
+ * Several archives can be merged in the same index, in which case the
+ * resources of the archives merged first take precedence.
+ */
+class ArchiveIndex {
+public:
+	ArchiveIndex();
+
+	void add(const char *room, uint32 index, const DirectorySubEntry *subEntry);
+	void merge(const ArchiveIndex &other);
+	void clear();
+
+	const DirectorySubEntryList *find(const Common::String &room, uint32 index, uint16 face,
+	                                  DirectorySubEntry::ResourceType type) const;
+
+	uint size() const { return _map.size(); }
+	uint32 getLookupCount() const { return _lookups; }
+	uint32 getHitCount() const { return _hits; }
+	void resetStats() { _lookups = _hits = 0; }
+
+	/**
+	 * Looks up all the indexed resources a number of times and returns
+	 * the elapsed time in milliseconds. Used to measure the lookup latency.
+	 */
+	uint32 timeLookups(uint passes) const;
+
+private:
+	struct Key {
+		uint32 room;
+		uint32 index;
+		uint16 face;
+		uint16 type;
+
+		bool operator==(const Key &other) const {
+			return room == other.room && index == other.index && face == other.face && type == other.type;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			uint hash = key.room;
+			hash = hash * 31 + key.index;
+			hash = hash * 31 + key.face;
+			hash = hash * 31 + key.type;
+			return hash;
+		}
+	};
+
+	static bool makeKey(const char *room, uint32 index, uint16 face, DirectorySubEntry::ResourceType type, Key &key);
+
+	typedef Common::HashMap<Key, DirectorySubEntryList, KeyHash> IndexMap;
+	IndexMap _map;
+
+	mutable uint32 _lookups;
+	mutable uint32 _hits;
+};
+
 class Archive {
 private:
 	bool _multipleRoom;
 	char _roomName[5];
 	Common::File _file;
 	Common::Array<DirectoryEntry> _directory;
+	ArchiveIndex _index;
 
 	void _decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream);
 	void _readDirectory();
+	void _buildIndex();
 public:
 
 	const DirectorySubEntry *getDescription(const Common::String &room, uint32 index, uint16 face,
@@ -46,6 +108,9 @@ public:
 	DirectorySubEntryList listFilesMatching(const Common::String &room, uint32 index, uint16 face,
 	                                        DirectorySubEntry::ResourceType type);
 
+	const ArchiveIndex &getIndex() const { return _index; }
+	void resetIndexStats() { _index.resetStats(); }
+
 	Common::MemoryReadStream *dumpToMemory(uint32 offset, uint32 size);
 	void dumpToFiles();
 
@@ -42,6 +42,7 @@ Console::Console(Myst3Engine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("fillInventory",			WRAP_METHOD(Console, Cmd_FillInventory));
 	registerCmd("dumpArchive",			WRAP_METHOD(Console, Cmd_DumpArchive));
 	registerCmd("dumpMasks",			WRAP_METHOD(Console, Cmd_DumpMasks));
+	registerCmd("archiveStats",			WRAP_METHOD(Console, Cmd_ArchiveStats));
 }
 
 Console::~Console() {
@@ -342,6 +343,40 @@ bool Console::Cmd_DumpArchive(int argc, const char **argv) {
 	return true;
 }
 
+void Console::describeArchiveIndex(const char *name, const ArchiveIndex &index) {
+	static const uint timingPasses = 100;
+
+	uint32 lookups = index.getLookupCount();
+	uint32 hits = index.getHitCount();
+	debugPrintf("%s: %d resources, %d lookups, %d hits, %d misses\n", name, index.size(), lookups, hits, lookups - hits);
+
+	if (index.size() > 0) {
+		uint32 elapsed = index.timeLookups(timingPasses);
+		debugPrintf("    average lookup time: %.3f us\n", elapsed * 1000.0f / (index.size() * timingPasses));
+	}
+}
+
+bool Console::Cmd_ArchiveStats(int argc, const char **argv) {
+	if (argc != 1 && argc != 2) {
+		debugPrintf("Show the archive resource lookup statistics.\n");
+		debugPrintf("Usage :\n");
+		debugPrintf("archiveStats [reset]\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		_vm->_archivesCommonIndex.resetStats();
+		_vm->_archiveNode->resetIndexStats();
+		debugPrintf("Archive statistics reset\n");
+		return true;
+	}
+
+	describeArchiveIndex("Common archives", _vm->_archivesCommonIndex);
+	describeArchiveIndex("Node archive", _vm->_archiveNode->getIndex());
+
+	return true;
+}
+
 bool Console::Cmd_DumpMasks(int argc, const char **argv) {
 	if (argc != 1 && argc != 2) {
 		debugPrintf("Extract the masks of the faces of a cube node.\n");
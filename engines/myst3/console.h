@@ -44,6 +44,7 @@ private:
 
 	void describeScript(const Common::Array<Opcode> &script);
 	bool dumpFaceMask(uint16 index, int face, DirectorySubEntry::ResourceType type);
+	void describeArchiveIndex(const char *name, const ArchiveIndex &index);
 
 	bool Cmd_Infos(int argc, const char **argv);
 	bool Cmd_LookAt(int argc, const char **argv);
@@ -56,6 +57,7 @@ private:
 	bool Cmd_Extract(int argc, const char **argv);
 	bool Cmd_DumpArchive(int argc, const char **argv);
 	bool Cmd_DumpMasks(int argc, const char **argv);
+	bool Cmd_ArchiveStats(int argc, const char **argv);
 	bool Cmd_FillInventory(int argc, const char **argv);
 };
 
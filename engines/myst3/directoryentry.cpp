@@ -78,4 +78,14 @@ DirectorySubEntryList DirectoryEntry::listItemsMatching(uint16 face, DirectorySu
 	return list;
 }
 
+DirectorySubEntryList DirectoryEntry::listItems() {
+	DirectorySubEntryList list;
+
+	for (uint i = 0; i < _subentries.size(); i++) {
+		list.push_back(&_subentries[i]);
+	}
+
+	return list;
+}
+
 } // End of namespace Myst3
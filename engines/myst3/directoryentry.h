@@ -46,6 +46,7 @@ public:
 
 	DirectorySubEntry *getItemDescription(uint16 face, DirectorySubEntry::ResourceType type);
 	DirectorySubEntryList listItemsMatching(uint16 face, DirectorySubEntry::ResourceType type);
+	DirectorySubEntryList listItems();
 
 	uint32 getIndex() { return _index; }
 	const char *getRoom() { return _roomName; }
@@ -247,7 +247,7 @@ void WaterEffect::doStep(float position, bool isFrame) {
 	}
 }
 
-void WaterEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst) {
+void WaterEffect::applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst) {
 	if (!isRunning()) {
 		return;
 	}
@@ -260,7 +260,7 @@ void WaterEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surf
 	apply(src, dst, mask->surface, face == 1, _vm->_state->getWaterEffectAmpl());
 }
 
-void WaterEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, bool bottomFace, int32 waterEffectAmpl) {
+void WaterEffect::apply(const Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, bool bottomFace, int32 waterEffectAmpl) {
 	int8 *hDisplacement = nullptr;
 	int8 *vDisplacement = nullptr;
 
@@ -311,8 +311,8 @@ void WaterEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics
 					}
 				}
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x + xOffset, y + yOffset);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
+				uint32 srcValue1 = *(const uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
+				uint32 srcValue2 = *(const uint32 *)src->getBasePtr(x, y);
 
 				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
 			}
@@ -371,7 +371,7 @@ void LavaEffect::doStep(int32 position, float ampl) {
 	}
 }
 
-void LavaEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst) {
+void LavaEffect::applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst) {
 	if (!_vm->_state->getLavaEffectActive()) {
 		return;
 	}
@@ -407,7 +407,7 @@ void LavaEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surfa
 
 				// TODO: The original does "blending" as above, but strangely
 				// this looks more like the original rendering
-				*dstPtr = *(uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
+				*dstPtr = *(const uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
 			}
 
 			maskPtr++;
@@ -506,7 +506,7 @@ bool MagnetEffect::update() {
 	return true;
 }
 
-void MagnetEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst) {
+void MagnetEffect::applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst) {
 	FaceMask *mask = _facesMasks.getVal(face);
 
 	if (!mask)
@@ -515,7 +515,7 @@ void MagnetEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Sur
 	apply(src, dst, mask->surface, _position * 256.0);
 }
 
-void MagnetEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position) {
+void MagnetEffect::apply(const Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position) {
 	uint32 *dstPtr = (uint32 *)dst->getPixels();
 	byte *maskPtr = (byte *)mask->getPixels();
 
@@ -526,8 +526,8 @@ void MagnetEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphic
 			if (maskValue != 0) {
 				uint32 displacement = _verticalDisplacement[(maskValue + position) % 256];
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x, y + displacement);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
+				uint32 srcValue1 = *(const uint32 *)src->getBasePtr(x, y + displacement);
+				uint32 srcValue2 = *(const uint32 *)src->getBasePtr(x, y);
 
 				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
 			}
@@ -607,7 +607,7 @@ bool ShakeEffect::update() {
 	return true;
 }
 
-void ShakeEffect::applyForFace(uint face, Graphics::Surface* src, Graphics::Surface* dst) {
+void ShakeEffect::applyForFace(uint face, const Graphics::Surface* src, Graphics::Surface* dst) {
 }
 
 RotationEffect::RotationEffect(Myst3Engine *vm) :
@@ -643,7 +643,7 @@ bool RotationEffect::update() {
 	return true;
 }
 
-void RotationEffect::applyForFace(uint face, Graphics::Surface* src, Graphics::Surface* dst) {
+void RotationEffect::applyForFace(uint face, const Graphics::Surface* src, Graphics::Surface* dst) {
 }
 
 bool ShieldEffect::loadPattern() {
@@ -755,7 +755,7 @@ bool ShieldEffect::update() {
 	return true;
 }
 
-void ShieldEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst) {
+void ShieldEffect::applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst) {
 	if (!_vm->_state->getShieldEffectActive()) {
 		return;
 	}
@@ -779,7 +779,7 @@ void ShieldEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Sur
 					yOffset = maskValue;
 				}
 
-				*dstPtr = *(uint32 *)src->getBasePtr(x, y + yOffset);
+				*dstPtr = *(const uint32 *)src->getBasePtr(x, y + yOffset);
 			}
 
 			maskPtr++;
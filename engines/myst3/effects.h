@@ -51,7 +51,7 @@ public:
 	virtual ~Effect();
 
 	virtual bool update() = 0;
-	virtual void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst) = 0;
+	virtual void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst) = 0;
 
 	bool hasFace(uint face) { return _facesMasks.contains(face); }
 	Common::Rect getUpdateRectForFace(uint face);
@@ -76,13 +76,13 @@ public:
 	virtual ~WaterEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 protected:
 	WaterEffect(Myst3Engine *vm);
 
 	void doStep(float position, bool isFrame);
-	void apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask,
+	void apply(const Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask,
 			bool bottomFace, int32 waterEffectAmpl);
 
 	uint32 _lastUpdate;
@@ -102,7 +102,7 @@ public:
 	virtual ~LavaEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 protected:
 	LavaEffect(Myst3Engine *vm);
@@ -121,12 +121,12 @@ public:
 	virtual ~MagnetEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 protected:
 	MagnetEffect(Myst3Engine *vm);
 
-	void apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position);
+	void apply(const Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position);
 
 	int32 _lastSoundId;
 	Common::MemoryReadStream *_shakeStrength;
@@ -143,7 +143,7 @@ public:
 	virtual ~ShakeEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 	float getPitchOffset() { return _pitchOffset; }
 	float getHeadingOffset() { return _headingOffset; }
@@ -164,7 +164,7 @@ public:
 	virtual ~RotationEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 	float getHeadingOffset() { return _headingOffset; }
 
@@ -182,7 +182,7 @@ public:
 	virtual ~ShieldEffect();
 
 	bool update();
-	void applyForFace(uint face, Graphics::Surface *src, Graphics::Surface *dst);
+	void applyForFace(uint face, const Graphics::Surface *src, Graphics::Surface *dst);
 
 protected:
 	ShieldEffect(Myst3Engine *vm);
@@ -0,0 +1,181 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/myst3/facecache.h"
+#include "engines/myst3/database.h"
+#include "engines/myst3/directorysubentry.h"
+#include "engines/myst3/myst3.h"
+#include "engines/myst3/state.h"
+
+#include "common/debug.h"
+
+#include "graphics/surface.h"
+
+namespace Myst3 {
+
+FaceCache::FaceCache(Myst3Engine *vm) :
+		_vm(vm),
+		_cacheSize(0),
+		_useCounter(0),
+		_hits(0),
+		_misses(0),
+		_prefetches(0) {
+}
+
+FaceCache::~FaceCache() {
+	clear();
+}
+
+Common::SharedPtr<Graphics::Surface> FaceCache::getFaceBitmap(const DirectorySubEntry *jpegDesc) {
+	int index = findEntry(jpegDesc);
+
+	if (index >= 0) {
+		_hits++;
+	} else {
+		_misses++;
+		addEntry(jpegDesc, Myst3Engine::decodeJpeg(jpegDesc));
+		index = findEntry(jpegDesc);
+	}
+
+	Entry &entry = _entries[index];
+	entry.lastUse = ++_useCounter;
+
+	return entry.bitmap;
+}
+
+void FaceCache::prefetchNeighbours(uint16 nodeId) {
+	_pending.clear();
+
+	NodePtr nodeData = _vm->_db->getNodeData(nodeId);
+	if (!nodeData)
+		return;
+
+	for (uint i = 0; i < nodeData->hotspots.size(); i++) {
+		HotSpot &hotspot = nodeData->hotspots[i];
+		if (!hotspot.isEnabled(_vm->_state))
+			continue;
+
+		for (uint j = 0; j < hotspot.script.size(); j++) {
+			const Opcode &opcode = hotspot.script[j];
+
+			switch (opcode.op) {
+			case 136: // goToNodeTransition
+			case 137: // goToNodeTrans2
+			case 138: // goToNodeTrans1
+			case 140: // zipToNode
+				queueNode(_vm->_state->valueOrVarValue(opcode.args[0]));
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+void FaceCache::queueNode(uint16 nodeId) {
+	for (uint face = 1; face <= 6; face++) {
+		const DirectorySubEntry *jpegDesc = _vm->getFileDescription("", nodeId, face, DirectorySubEntry::kCubeFace);
+
+		// Not a cube node
+		if (!jpegDesc)
+			return;
+
+		if (findEntry(jpegDesc) >= 0)
+			continue;
+
+		bool queued = false;
+		for (uint i = 0; i < _pending.size(); i++) {
+			if (_pending[i] == jpegDesc) {
+				queued = true;
+				break;
+			}
+		}
+
+		if (!queued)
+			_pending.push_back(jpegDesc);
+	}
+}
+
+void FaceCache::update(uint frameTimeLeft) {
+	if (_pending.empty() || frameTimeLeft < kMinFrameTimeForDecode)
+		return;
+
+	const DirectorySubEntry *jpegDesc = _pending.remove_at(0);
+	if (findEntry(jpegDesc) >= 0)
+		return;
+
+	addEntry(jpegDesc, Myst3Engine::decodeJpeg(jpegDesc));
+	_prefetches++;
+
+	debugC(kDebugNode, "Prefetched a face, %d left in the queue, cache size %d bytes", _pending.size(), _cacheSize);
+}
+
+void FaceCache::clear() {
+	while (!_entries.empty()) {
+		removeEntry(_entries.size() - 1);
+	}
+
+	_pending.clear();
+}
+
+int FaceCache::findEntry(const DirectorySubEntry *desc) const {
+	for (uint i = 0; i < _entries.size(); i++) {
+		if (_entries[i].desc == desc)
+			return i;
+	}
+
+	return -1;
+}
+
+void FaceCache::addEntry(const DirectorySubEntry *desc, Graphics::Surface *bitmap) {
+	uint32 size = bitmap->pitch * bitmap->h;
+
+	// Evict the least recently used faces to make room for the new one
+	while (!_entries.empty() && _cacheSize + size > kMaxCacheSize) {
+		uint oldest = 0;
+		for (uint i = 1; i < _entries.size(); i++) {
+			if (_entries[i].lastUse < _entries[oldest].lastUse)
+				oldest = i;
+		}
+
+		removeEntry(oldest);
+	}
+
+	Entry entry;
+	entry.desc = desc;
+	entry.bitmap = Common::SharedPtr<Graphics::Surface>(bitmap, Graphics::SharedPtrSurfaceDeleter());
+	entry.lastUse = ++_useCounter;
+	_entries.push_back(entry);
+
+	_cacheSize += size;
+}
+
+void FaceCache::removeEntry(uint index) {
+	Entry &entry = _entries[index];
+
+	_cacheSize -= entry.bitmap->pitch * entry.bitmap->h;
+
+	// The faces still using the bitmap keep it alive
+	_entries.remove_at(index);
+}
+
+} // End of namespace Myst3
@@ -0,0 +1,107 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef FACECACHE_H_
+#define FACECACHE_H_
+
+#include "common/array.h"
+#include "common/ptr.h"
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Myst3 {
+
+class Myst3Engine;
+class DirectorySubEntry;
+
+/**
+ * LRU cache of decoded node face bitmaps.
+ *
+ * When a cube node is loaded, the faces of the nodes reachable through its
+ * hotspots are queued for prefetching. The queued faces are then decoded one
+ * at a time at the end of the frames having time to spare, so that moving to
+ * a neighbour node finds its faces already decoded.
+ */
+class FaceCache {
+public:
+	FaceCache(Myst3Engine *vm);
+	~FaceCache();
+
+	/**
+	 * Get a decoded face bitmap
+	 *
+	 * The bitmap is decoded immediately if it is not in the cache.
+	 * The returned surface is shared with the cache and must not be modified,
+	 * it stays valid after being evicted from the cache for as long as it is referenced.
+	 */
+	Common::SharedPtr<Graphics::Surface> getFaceBitmap(const DirectorySubEntry *jpegDesc);
+
+	/**
+	 * Queue the faces of the nodes reachable from a node for prefetching
+	 *
+	 * Only the nodes of the current room are queued, the cache is flushed
+	 * anyway when going to another room changes the node archive.
+	 */
+	void prefetchNeighbours(uint16 nodeId);
+
+	/** Decode a queued face, if there is enough time left in the current frame */
+	void update(uint frameTimeLeft);
+
+	/** Forget all the faces, needs to be called before closing the archives */
+	void clear();
+
+	uint32 getHitCount() const { return _hits; }
+	uint32 getMissCount() const { return _misses; }
+	uint32 getPrefetchCount() const { return _prefetches; }
+
+private:
+	static const uint kMaxCacheSize = 40 * 1024 * 1024;
+	static const uint kMinFrameTimeForDecode = 8;
+
+	struct Entry {
+		const DirectorySubEntry *desc;
+		Common::SharedPtr<Graphics::Surface> bitmap;
+		uint32 lastUse;
+	};
+
+	Myst3Engine *_vm;
+
+	Common::Array<Entry> _entries;
+	Common::Array<const DirectorySubEntry *> _pending;
+	uint32 _cacheSize;
+	uint32 _useCounter;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _prefetches;
+
+	int findEntry(const DirectorySubEntry *desc) const;
+	void addEntry(const DirectorySubEntry *desc, Graphics::Surface *bitmap);
+	void removeEntry(uint index);
+	void queueNode(uint16 nodeId);
+};
+
+} // End of namespace Myst3
+
+#endif // FACECACHE_H_
@@ -273,4 +273,14 @@ void FrameLimiter::delayBeforeSwap() {
 	}
 }
 
+uint FrameLimiter::getTimeLeft() const {
+	uint frameDuration = _system->getMillis() - _startFrameTime;
+
+	if (frameDuration < _speedLimitMs) {
+		return _speedLimitMs - frameDuration;
+	}
+
+	return 0;
+}
+
 } // End of namespace Myst3
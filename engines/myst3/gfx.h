@@ -137,6 +137,9 @@ public:
 
 	void startFrame();
 	void delayBeforeSwap();
+
+	/** Get the time in milliseconds left before the end of the current frame */
+	uint getTimeLeft() const;
 private:
 	OSystem *_system;
 
@@ -72,6 +72,12 @@ void TinyGLRenderer::init() {
 	_fb = new TinyGL::FrameBuffer(kOriginalWidth, kOriginalHeight, screenBuffer);
 	TinyGL::glInit(_fb, 512);
 
+	// Split the frame in tiles rendered by the worker threads of the backend, if it has any
+	if (_system->getWorkerPool()) {
+		tglSetWorkerPool(_system->getWorkerPool());
+		tglEnableTiledRendering(true);
+	}
+
 	tglMatrixMode(TGL_PROJECTION);
 	tglLoadIdentity();
 
@@ -10,6 +10,7 @@ MODULE_OBJS := \
 	directoryentry.o \
 	directorysubentry.o \
 	effects.o \
+	facecache.o \
 	gfx.o \
 	gfx_opengl.o \
 	gfx_tinygl.o \
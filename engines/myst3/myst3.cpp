@@ -25,6 +25,7 @@
 #include "common/error.h"
 #include "common/config-manager.h"
 #include "common/file.h"
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -37,6 +38,7 @@
 #include "engines/myst3/console.h"
 #include "engines/myst3/database.h"
 #include "engines/myst3/effects.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/myst3.h"
 #include "engines/myst3/nodecube.h"
 #include "engines/myst3/nodeframe.h"
@@ -74,7 +76,7 @@ Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 		_db(0), _console(0), _scriptEngine(0),
 		_state(0), _node(0), _scene(0), _archiveNode(0),
 		_cursor(0), _inventory(0), _gfx(0), _menu(0),
-		_rnd(0), _sound(0), _ambient(0),
+		_rnd(0), _sound(0), _ambient(0), _faceCache(0),
 		_inputSpacePressed(false), _inputEnterPressed(false),
 		_inputEscapePressed(false), _inputTildePressed(false),
 		_inputEscapePressedNotConsumed(false),
@@ -120,6 +122,8 @@ Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 Myst3Engine::~Myst3Engine() {
 	DebugMan.clearAllDebugChannels();
 
+	// The cached faces reference the archives
+	delete _faceCache;
 	closeArchives();
 
 	delete _menu;
@@ -173,6 +177,7 @@ Common::Error Myst3Engine::run() {
 		_menu = new PagingMenu(this);
 	}
 	_archiveNode = new Archive();
+	_faceCache = new FaceCache(this);
 
 	_system->showMouse(false);
 
@@ -217,6 +222,7 @@ Common::Error Myst3Engine::run() {
 
 	unloadNode();
 
+	_faceCache->clear();
 	_archiveNode->close();
 	_gfx->freeFont();
 
@@ -232,6 +238,9 @@ bool Myst3Engine::addArchive(const Common::String &file, bool mandatory) {
 
 	if (opened) {
 		_archivesCommon.push_back(archive);
+
+		// The archives opened first have precedence
+		_archivesCommonIndex.merge(archive->getIndex());
 	} else {
 		delete archive;
 		if (mandatory)
@@ -335,6 +344,7 @@ void Myst3Engine::closeArchives() {
 		delete _archivesCommon[i];
 
 	_archivesCommon.clear();
+	_archivesCommonIndex.clear();
 }
 
 bool Myst3Engine::checkDatafiles() {
@@ -600,6 +610,8 @@ void Myst3Engine::interactWithHoveredElement(bool lookOnly) {
 }
 
 void Myst3Engine::drawFrame(bool noSwap) {
+	PROFILE_ZONE("Draw");
+
 	_sound->update();
 	_gfx->clear();
 
@@ -634,7 +646,10 @@ void Myst3Engine::drawFrame(bool noSwap) {
 	}
 
 	for (int i = _movies.size() - 1; i >= 0 ; i--) {
-		_movies[i]->update();
+		{
+			PROFILE_ZONE("Movie decode");
+			_movies[i]->update();
+		}
 		_movies[i]->draw();
 	}
 
@@ -688,13 +703,39 @@ void Myst3Engine::drawFrame(bool noSwap) {
 	if (cursorVisible)
 		_cursor->draw();
 
-	_gfx->flipBuffer();
+	if (Common::Profiler::isEnabled())
+		drawProfilerOverlay();
+
+	{
+		PROFILE_ZONE("Present");
+		_gfx->flipBuffer();
+	}
 
 	if (!noSwap) {
+		// Use the spare frame time to decode the faces of the neighbour nodes
+		_faceCache->update(_frameLimiter->getTimeLeft());
+
 		_frameLimiter->delayBeforeSwap();
 		_system->updateScreen();
 		_state->updateFrameCounters();
 		_frameLimiter->startFrame();
+
+		if (Common::Profiler::isEnabled())
+			ProfileMan.endFrame();
+	}
+}
+
+void Myst3Engine::drawProfilerOverlay() {
+	// The font only has uppercase letters, digits and a few symbols,
+	// the times are shown in microseconds.
+	Common::String frame = Common::String::format("FRAME %d", ProfileMan.getLastFrameTime());
+	_gfx->draw2DText(frame, Common::Point(10, 10));
+
+	const Common::Array<Common::Profiler::ZoneTotal> &zones = ProfileMan.getLastFrameZones();
+	for (uint i = 0; i < zones.size() && i < 6; i++) {
+		Common::String line = Common::String::format("%s %d", zones[i].name, zones[i].time);
+		line.toUppercase();
+		_gfx->draw2DText(line, Common::Point(10, 42 + i * 32));
 	}
 }
 
@@ -778,6 +819,7 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 		_db->setCurrentRoom(roomID);
 		Common::String nodeFile = Common::String::format("%snodes.m3a", newRoomName.c_str());
 
+		_faceCache->clear();
 		_archiveNode->close();
 		if (!_archiveNode->open(nodeFile.c_str(), newRoomName.c_str())) {
 			error("Unable to open archive %s", nodeFile.c_str());
@@ -879,6 +921,9 @@ void Myst3Engine::loadNodeCubeFaces(uint16 nodeID) {
 	updateCursor();
 
 	_node = new NodeCube(this, nodeID);
+
+	// Get the faces of the nodes the player is likely to go to next ready
+	_faceCache->prefetchNeighbours(nodeID);
 }
 
 void Myst3Engine::loadNodeFrame(uint16 nodeID) {
@@ -900,6 +945,8 @@ void Myst3Engine::loadNodeMenu(uint16 nodeID) {
 }
 
 void Myst3Engine::runScriptsFromNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
+	PROFILE_ZONE("Script execution");
+
 	if (roomID == 0)
 		roomID = _state->getLocationRoom();
 
@@ -1232,20 +1279,16 @@ const DirectorySubEntry *Myst3Engine::getFileDescription(const Common::String &r
 		archiveRoom = _db->getRoomName(_state->getLocationRoom());
 	}
 
-	const DirectorySubEntry *desc = 0;
-
 	// Search common archives
-	uint i = 0;
-	while (!desc && i < _archivesCommon.size()) {
-		desc = _archivesCommon[i]->getDescription(archiveRoom, index, face, type);
-		i++;
-	}
+	const DirectorySubEntryList *subEntries = _archivesCommonIndex.find(archiveRoom, index, face, type);
+	if (subEntries)
+		return subEntries->front();
 
 	// Search currently loaded node archive
-	if (!desc && _archiveNode)
-		desc = _archiveNode->getDescription(archiveRoom, index, face, type);
+	if (_archiveNode)
+		return _archiveNode->getDescription(archiveRoom, index, face, type);
 
-	return desc;
+	return 0;
 }
 
 DirectorySubEntryList Myst3Engine::listFilesMatching(const Common::String &room, uint32 index, uint16 face,
@@ -1255,12 +1298,9 @@ DirectorySubEntryList Myst3Engine::listFilesMatching(const Common::String &room,
 		archiveRoom = _db->getRoomName(_state->getLocationRoom());
 	}
 
-	for (uint i = 0; i < _archivesCommon.size(); i++) {
-		DirectorySubEntryList list = _archivesCommon[i]->listFilesMatching(archiveRoom, index, face, type);
-		if (!list.empty()) {
-			return list;
-		}
-	}
+	const DirectorySubEntryList *subEntries = _archivesCommonIndex.find(archiveRoom, index, face, type);
+	if (subEntries)
+		return *subEntries;
 
 	return _archiveNode->listFilesMatching(archiveRoom, index, face, type);
 }
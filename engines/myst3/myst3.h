@@ -80,6 +80,7 @@ class ShakeEffect;
 class RotationEffect;
 class Transition;
 class FrameLimiter;
+class FaceCache;
 struct NodeData;
 struct Myst3GameDescription;
 
@@ -104,6 +105,7 @@ public:
 	Database *_db;
 	Sound *_sound;
 	Ambient *_ambient;
+	FaceCache *_faceCache;
 	
 	Common::RandomSource *_rnd;
 
@@ -174,6 +176,7 @@ public:
 
 	void processInput(bool lookOnly);
 	void drawFrame(bool noSwap = false);
+	void drawProfilerOverlay();
 
 	bool inputValidatePressed();
 	bool inputEscapePressed();
@@ -191,6 +194,7 @@ private:
 	Node *_node;
 
 	Common::Array<Archive *> _archivesCommon;
+	ArchiveIndex _archivesCommonIndex;
 	Archive *_archiveNode;
 
 	Script *_scriptEngine;
@@ -21,6 +21,7 @@
  */
 
 #include "engines/myst3/effects.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/node.h"
 #include "engines/myst3/myst3.h"
 #include "engines/myst3/state.h"
@@ -32,8 +33,8 @@
 namespace Myst3 {
 
 void Face::setTextureFromJPEG(const DirectorySubEntry *jpegDesc) {
-	_bitmap = Myst3Engine::decodeJpeg(jpegDesc);
-	_texture = _vm->_gfx->createTexture(_bitmap);
+	_bitmap = _vm->_faceCache->getFaceBitmap(jpegDesc);
+	_texture = _vm->_gfx->createTexture(_bitmap.get());
 
 	// Set the whole texture as dirty
 	addTextureDirtyRect(Common::Rect(_bitmap->w, _bitmap->h));
@@ -43,10 +44,19 @@ Face::Face(Myst3Engine *vm) :
 		_vm(vm),
 		_textureDirty(true),
 		_texture(0),
-		_bitmap(0),
 		_finalBitmap(0) {
 }
 
+Graphics::Surface *Face::getWritableBitmap() {
+	if (!_bitmap.unique()) {
+		Graphics::Surface *copy = new Graphics::Surface();
+		copy->copyFrom(*_bitmap);
+		_bitmap = Common::SharedPtr<Graphics::Surface>(copy, Graphics::SharedPtrSurfaceDeleter());
+	}
+
+	return _bitmap.get();
+}
+
 void Face::addTextureDirtyRect(const Common::Rect &rect) {
 	if (!_textureDirty) {
 		_textureDirtyRect = rect;
@@ -62,17 +72,13 @@ void Face::uploadTexture() {
 		if (_finalBitmap)
 			_texture->updatePartial(_finalBitmap, _textureDirtyRect);
 		else
-			_texture->updatePartial(_bitmap, _textureDirtyRect);
+			_texture->updatePartial(_bitmap.get(), _textureDirtyRect);
 
 		_textureDirty = false;
 	}
 }
 
 Face::~Face() {
-	_bitmap->free();
-	delete _bitmap;
-	_bitmap = 0;
-
 	if (_finalBitmap) {
 		_finalBitmap->free();
 		delete _finalBitmap;
@@ -253,18 +259,18 @@ void Node::update() {
 		if (!face->_finalBitmap) {
 			face->_finalBitmap = new Graphics::Surface();
 		}
-		face->_finalBitmap->copyFrom(*face->_bitmap);
+		face->_finalBitmap->copyFrom(*face->getBitmap());
 
 		if (effectsForFace == 1) {
-			_effects[0]->applyForFace(faceId, face->_bitmap, face->_finalBitmap);
+			_effects[0]->applyForFace(faceId, face->getBitmap(), face->_finalBitmap);
 
 			face->addTextureDirtyRect(_effects[0]->getUpdateRectForFace(faceId));
 		} else if (effectsForFace == 2) {
 			// TODO: Keep the same temp surface to avoid heap fragmentation ?
 			Graphics::Surface *tmp = new Graphics::Surface();
-			tmp->copyFrom(*face->_bitmap);
+			tmp->copyFrom(*face->getBitmap());
 
-			_effects[0]->applyForFace(faceId, face->_bitmap, tmp);
+			_effects[0]->applyForFace(faceId, face->getBitmap(), tmp);
 			_effects[1]->applyForFace(faceId, tmp, face->_finalBitmap);
 
 			tmp->free();
@@ -383,9 +389,10 @@ void SpotItemFace::initNotDrawn(uint16 width, uint16 height) {
 	_notDrawnBitmap = new Graphics::Surface();
 	_notDrawnBitmap->create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));
 
+	const Graphics::Surface *faceBitmap = _face->getBitmap();
 	for (uint i = 0; i < height; i++) {
 		memcpy(_notDrawnBitmap->getBasePtr(0, i),
-				_face->_bitmap->getBasePtr(_posX, _posY + i), width * 4);
+				faceBitmap->getBasePtr(_posX, _posY + i), width * 4);
 	}
 }
 
@@ -398,8 +405,9 @@ Common::Rect SpotItemFace::getFaceRect() const {
 }
 
 void SpotItemFace::draw() {
+	Graphics::Surface *faceBitmap = _face->getWritableBitmap();
 	for (uint i = 0; i < _bitmap->h; i++) {
-		memcpy(_face->_bitmap->getBasePtr(_posX, _posY + i),
+		memcpy(faceBitmap->getBasePtr(_posX, _posY + i),
 				_bitmap->getBasePtr(0, i),
 				_bitmap->w * 4);
 	}
@@ -409,8 +417,9 @@ void SpotItemFace::draw() {
 }
 
 void SpotItemFace::undraw() {
+	Graphics::Surface *faceBitmap = _face->getWritableBitmap();
 	for (uint i = 0; i < _notDrawnBitmap->h; i++) {
-		memcpy(_face->_bitmap->getBasePtr(_posX, _posY + i),
+		memcpy(faceBitmap->getBasePtr(_posX, _posY + i),
 				_notDrawnBitmap->getBasePtr(0, i),
 				_notDrawnBitmap->w * 4);
 	}
@@ -422,10 +431,11 @@ void SpotItemFace::undraw() {
 void SpotItemFace::fadeDraw() {
 	uint16 fadeValue = CLIP<uint16>(_fadeValue, 0, 100);
 
+	Graphics::Surface *faceBitmap = _face->getWritableBitmap();
 	for (int i = 0; i < _bitmap->h; i++) {
 		byte *ptrND = (byte *)_notDrawnBitmap->getBasePtr(0, i);
 		byte *ptrD = (byte *)_bitmap->getBasePtr(0, i);
-		byte *ptrDest = (byte *)_face->_bitmap->getBasePtr(_posX, _posY + i);
+		byte *ptrDest = (byte *)faceBitmap->getBasePtr(_posX, _posY + i);
 
 		for (int j = 0; j < _bitmap->w; j++) {
 			byte rND = *ptrND++;
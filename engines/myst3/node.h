@@ -27,6 +27,7 @@
 #include "engines/myst3/directorysubentry.h"
 
 #include "common/array.h"
+#include "common/ptr.h"
 #include "common/rect.h"
 
 #include "graphics/surface.h"
@@ -40,7 +41,6 @@ class Effect;
 
 class Face {
 public:
-	Graphics::Surface *_bitmap;
 	Graphics::Surface *_finalBitmap;
 	Texture *_texture;
 
@@ -49,12 +49,25 @@ public:
 
 	void setTextureFromJPEG(const DirectorySubEntry *jpegDesc);
 
+	/** Get the face bitmap, spot items included */
+	const Graphics::Surface *getBitmap() const { return _bitmap.get(); }
+
+	/**
+	 * Get the face bitmap to draw on it
+	 *
+	 * The bitmap is shared with the face cache until it is first modified,
+	 * it is then replaced by a copy owned by the face.
+	 */
+	Graphics::Surface *getWritableBitmap();
+
 	void addTextureDirtyRect(const Common::Rect &rect);
 	bool isTextureDirty() { return _textureDirty; }
 
 	void uploadTexture();
 
 private:
+	Common::SharedPtr<Graphics::Surface> _bitmap;
+
 	bool _textureDirty;
 	Common::Rect _textureDirtyRect;
 
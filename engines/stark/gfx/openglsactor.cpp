@@ -29,6 +29,8 @@
 #include "engines/stark/gfx/opengls.h"
 #include "engines/stark/gfx/texture.h"
 
+#include "common/algorithm.h"
+
 #include "graphics/opengl/shader.h"
 
 namespace Stark {
@@ -36,8 +38,25 @@ namespace Gfx {
 
 OpenGLSActorRenderer::OpenGLSActorRenderer(OpenGLSDriver *gfx) :
 		VisualActor(),
-		_gfx(gfx) {
+		_gfx(gfx),
+		_vertexVBO(0),
+		_indexEBO(0),
+		_batchTextureSet(nullptr) {
 	_shader = _gfx->createActorShaderInstance();
+
+	_modelViewMatrixUniform = _shader->getUniform("modelViewMatrix");
+	_projectionMatrixUniform = _shader->getUniform("projectionMatrix");
+	_normalMatrixUniform = _shader->getUniform("normalMatrix");
+	_texturedUniform = _shader->getUniform("textured");
+	_colorUniform = _shader->getUniform("color");
+	_ambientColorUniform = _shader->getUniform("ambientColor");
+
+	for (uint i = 0; i < kMaxLights; i++) {
+		_lightUniforms[i].position = _shader->getUniform(Common::String::format("lights[%d].position", i).c_str());
+		_lightUniforms[i].direction = _shader->getUniform(Common::String::format("lights[%d].direction", i).c_str());
+		_lightUniforms[i].color = _shader->getUniform(Common::String::format("lights[%d].color", i).c_str());
+		_lightUniforms[i].params = _shader->getUniform(Common::String::format("lights[%d].params", i).c_str());
+	}
 }
 
 OpenGLSActorRenderer::~OpenGLSActorRenderer() {
@@ -54,6 +73,10 @@ void OpenGLSActorRenderer::render(const Math::Vector3d position, float direction
 		_modelIsDirty = false;
 	}
 
+	if (_batchTextureSet != _textureSet) {
+		resolveBatchTextures();
+	}
+
 	_animHandler->animate(_time);
 
 	_gfx->set3DMode();
@@ -73,78 +96,122 @@ void OpenGLSActorRenderer::render(const Math::Vector3d position, float direction
 	//normalMatrix.transpose(); // OpenGL expects matrices transposed when compared to ResidualVM's
 	//normalMatrix.transpose(); // No need to transpose twice in a row
 
+	_shader->enableVertexAttribute("position1", _vertexVBO, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 0);
+	_shader->enableVertexAttribute("position2", _vertexVBO, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 12);
+	_shader->enableVertexAttribute("bone1", _vertexVBO, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 24);
+	_shader->enableVertexAttribute("bone2", _vertexVBO, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 28);
+	_shader->enableVertexAttribute("boneWeight", _vertexVBO, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 32);
+	_shader->enableVertexAttribute("normal", _vertexVBO, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 36);
+	_shader->enableVertexAttribute("texcoord", _vertexVBO, 2, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 48);
 	_shader->use(true);
-	_shader->setUniform("modelViewMatrix", modelViewMatrix);
-	_shader->setUniform("projectionMatrix", projectionMatrix);
-	_shader->setUniform("normalMatrix", normalMatrix.getRotation());
+
+	_shader->setUniform(_modelViewMatrixUniform, modelViewMatrix);
+	_shader->setUniform(_projectionMatrixUniform, projectionMatrix);
+	_shader->setUniform(_normalMatrixUniform, normalMatrix.getRotation());
 	setBoneRotationArrayUniform("boneRotation");
 	setBonePositionArrayUniform("bonePosition");
-	setLightArrayUniform("lights", lights);
+	setLightArrayUniform(lights);
 
-	Common::Array<MeshNode *> meshes = _model->getMeshes();
-	Common::Array<MaterialNode *> mats = _model->getMaterials();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexEBO);
 
-	for (Common::Array<MeshNode *>::const_iterator mesh = meshes.begin(); mesh != meshes.end(); ++mesh) {
-		for (Common::Array<FaceNode *>::const_iterator face = (*mesh)->_faces.begin(); face != (*mesh)->_faces.end(); ++face) {
-			// For each face draw its vertices from the VBO, indexed by the EBO
-			const MaterialNode *material = mats[(*face)->_matIdx];
-			const Gfx::Texture *tex = _textureSet->getTexture(material->_texName);
-			if (tex) {
-				tex->bind();
+	const Common::Array<MaterialNode *> &materials = _model->getMaterials();
+
+	for (uint i = 0; i < _batches.size(); i++) {
+		// The batches are sorted by texture, only bind it when it changes
+		const DrawBatch &batch = _batches[i];
+		if (i == 0 || batch.texture != _batches[i - 1].texture) {
+			if (batch.texture) {
+				batch.texture->bind();
 			} else {
 				glBindTexture(GL_TEXTURE_2D, 0);
 			}
+		}
 
-			GLuint vbo = _faceVBO[*face];
-			GLuint ebo = _faceEBO[*face];
-
-			_shader->enableVertexAttribute("position1", vbo, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 0);
-			_shader->enableVertexAttribute("position2", vbo, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 12);
-			_shader->enableVertexAttribute("bone1", vbo, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 24);
-			_shader->enableVertexAttribute("bone2", vbo, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 28);
-			_shader->enableVertexAttribute("boneWeight", vbo, 1, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 32);
-			_shader->enableVertexAttribute("normal", vbo, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 36);
-			_shader->enableVertexAttribute("texcoord", vbo, 2, GL_FLOAT, GL_FALSE, 14 * sizeof(float), 48);
-			_shader->use(true);
-			_shader->setUniform("textured", tex != nullptr);
-			_shader->setUniform("color", Math::Vector3d(material->_r, material->_g, material->_b));
-
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-			glDrawElements(GL_TRIANGLES, 3 * (*face)->_tris.size(), GL_UNSIGNED_INT, 0);
+		const MaterialNode *material = materials[batch.materialIdx];
+		_shader->setUniform(_texturedUniform, batch.texture != nullptr);
+		_shader->setUniform(_colorUniform, Math::Vector3d(material->_r, material->_g, material->_b));
 
-			glUseProgram(0);
-		}
+		glDrawElements(GL_TRIANGLES, batch.indexCount, GL_UNSIGNED_INT, (const GLvoid *)(batch.firstIndex * sizeof(uint32)));
 	}
+
+	glUseProgram(0);
 }
 
 void OpenGLSActorRenderer::clearVertices() {
-	for (FaceBufferMap::iterator it = _faceVBO.begin(); it != _faceVBO.end(); ++it) {
-		OpenGL::Shader::freeBuffer(it->_value);
+	if (_vertexVBO) {
+		OpenGL::Shader::freeBuffer(_vertexVBO);
+		_vertexVBO = 0;
 	}
 
-	for (FaceBufferMap::iterator it = _faceEBO.begin(); it != _faceEBO.end(); ++it) {
-		OpenGL::Shader::freeBuffer(it->_value);
+	if (_indexEBO) {
+		OpenGL::Shader::freeBuffer(_indexEBO);
+		_indexEBO = 0;
 	}
 
-	_faceVBO.clear();
-	_faceEBO.clear();
+	_batches.clear();
+	_batchTextureSet = nullptr;
 }
 
 void OpenGLSActorRenderer::uploadVertices() {
-	Common::Array<MeshNode *> meshes = _model->getMeshes();
+	const Common::Array<MeshNode *> &meshes = _model->getMeshes();
+	const Common::Array<MaterialNode *> &materials = _model->getMaterials();
+
+	// Group the faces by material, so that each material is drawn with a single call
+	Common::Array<Common::Array<const FaceNode *> > materialFaces;
+	materialFaces.resize(materials.size());
+
+	uint32 vertexCount = 0;
+	uint32 indexCount = 0;
 	for (Common::Array<MeshNode *>::const_iterator mesh = meshes.begin(); mesh != meshes.end(); ++mesh) {
 		for (Common::Array<FaceNode *>::const_iterator face = (*mesh)->_faces.begin(); face != (*mesh)->_faces.end(); ++face) {
-			_faceVBO[*face] = createFaceVBO(*face);
-			_faceEBO[*face] = createFaceEBO(*face);
+			materialFaces[(*face)->_matIdx].push_back(*face);
+			vertexCount += (*face)->_verts.size();
+			indexCount += 3 * (*face)->_tris.size();
 		}
 	}
-}
 
-uint32 OpenGLSActorRenderer::createFaceVBO(const FaceNode *face) {
-	float *vertices = new float[14 * face->_verts.size()];
+	// Build a vertex array and a vertex indices array for all the faces
+	float *vertices = new float[14 * vertexCount];
+	uint32 *indices = new uint32[indexCount];
 	float *vertPtr = vertices;
+	uint32 *idxPtr = indices;
+	uint32 firstVertex = 0;
+
+	for (uint32 i = 0; i < materialFaces.size(); i++) {
+		if (materialFaces[i].empty()) {
+			continue;
+		}
+
+		DrawBatch batch;
+		batch.materialIdx = i;
+		batch.firstIndex = idxPtr - indices;
+		batch.texture = nullptr;
 
-	// Build a vertex array
+		for (uint j = 0; j < materialFaces[i].size(); j++) {
+			const FaceNode *face = materialFaces[i][j];
+			vertPtr = writeFaceVertices(face, vertPtr);
+
+			for (Common::Array<TriNode *>::const_iterator tri = face->_tris.begin(); tri != face->_tris.end(); ++tri) {
+				*idxPtr++ = firstVertex + (*tri)->_vert1;
+				*idxPtr++ = firstVertex + (*tri)->_vert2;
+				*idxPtr++ = firstVertex + (*tri)->_vert3;
+			}
+
+			firstVertex += face->_verts.size();
+		}
+
+		batch.indexCount = (idxPtr - indices) - batch.firstIndex;
+		_batches.push_back(batch);
+	}
+
+	_vertexVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, sizeof(float) * 14 * vertexCount, vertices);
+	_indexEBO = OpenGL::Shader::createBuffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32) * indexCount, indices);
+
+	delete[] vertices;
+	delete[] indices;
+}
+
+float *OpenGLSActorRenderer::writeFaceVertices(const FaceNode *face, float *vertPtr) {
 	for (Common::Array<VertNode *>::const_iterator tri = face->_verts.begin(); tri != face->_verts.end(); ++tri) {
 		*vertPtr++ = (*tri)->_pos1.x();
 		*vertPtr++ = (*tri)->_pos1.y();
@@ -167,32 +234,26 @@ uint32 OpenGLSActorRenderer::createFaceVBO(const FaceNode *face) {
 		*vertPtr++ = (*tri)->_texT;
 	}
 
-	uint32 vbo = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, sizeof(float) * 14 * face->_verts.size(), vertices);
-	delete[] vertices;
-
-	return vbo;
+	return vertPtr;
 }
 
-uint32 OpenGLSActorRenderer::createFaceEBO(const FaceNode *face) {
-	uint32 *indices = new uint32[3 * face->_tris.size()];
-	uint32 *idxPtr = indices;
+struct ActorBatchTextureLess {
+	bool operator()(const OpenGLSActorRenderer::DrawBatch &a, const OpenGLSActorRenderer::DrawBatch &b) const {
+		return a.texture < b.texture;
+	}
+};
 
-	// Build a vertex indices array
-	for (Common::Array<TriNode *>::const_iterator tri = face->_tris.begin(); tri != face->_tris.end(); ++tri) {
-		for (int vert = 0; vert < 3; ++vert) {
-			if (vert == 0)
-				*idxPtr++ = (*tri)->_vert1;
-			else if (vert == 1)
-				*idxPtr++ = (*tri)->_vert2;
-			else
-				*idxPtr++ = (*tri)->_vert3;
-		}
+void OpenGLSActorRenderer::resolveBatchTextures() {
+	const Common::Array<MaterialNode *> &materials = _model->getMaterials();
+
+	for (uint i = 0; i < _batches.size(); i++) {
+		_batches[i].texture = _textureSet->getTexture(materials[_batches[i].materialIdx]->_texName);
 	}
 
-	uint32 ebo = OpenGL::Shader::createBuffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32) * 3 * face->_tris.size(), indices);
-	delete[] indices;
+	// Draw the batches using the same texture one after the other
+	Common::sort(_batches.begin(), _batches.end(), ActorBatchTextureLess());
 
-	return ebo;
+	_batchTextureSet = _textureSet;
 }
 
 void OpenGLSActorRenderer::setBonePositionArrayUniform(const char *uniform) {
@@ -238,15 +299,13 @@ void OpenGLSActorRenderer::setBoneRotationArrayUniform(const char *uniform) {
 	delete[] rotations;
 }
 
-void OpenGLSActorRenderer::setLightArrayUniform(const char *uniform, const LightEntryArray &lights) {
-	static const uint maxLights = 10;
-
+void OpenGLSActorRenderer::setLightArrayUniform(const LightEntryArray &lights) {
 	assert(lights.size() >= 1);
-	assert(lights.size() <= maxLights);
+	assert(lights.size() <= kMaxLights);
 
 	const LightEntry *ambient = lights[0];
 	assert(ambient->type == LightEntry::kAmbient); // The first light must be the ambient light
-	_shader->setUniform("ambientColor", ambient->color);
+	_shader->setUniform(_ambientColorUniform, ambient->color);
 
 	Math::Matrix4 viewMatrix = StarkScene->getViewMatrix();
 	Math::Matrix3 viewMatrixRot = viewMatrix.getRotation();
@@ -269,9 +328,9 @@ void OpenGLSActorRenderer::setLightArrayUniform(const char *uniform, const Light
 		Math::Vector3d eyeDirection = viewMatrixRot * worldDirection;
 		eyeDirection.normalize();
 
-		_shader->setUniform(Common::String::format("lights[%d].position", i).c_str(), eyePosition);
-		_shader->setUniform(Common::String::format("lights[%d].direction", i).c_str(), eyeDirection);
-		_shader->setUniform(Common::String::format("lights[%d].color", i).c_str(), l->color);
+		_shader->setUniform(_lightUniforms[i].position, eyePosition);
+		_shader->setUniform(_lightUniforms[i].direction, eyeDirection);
+		_shader->setUniform(_lightUniforms[i].color, l->color);
 
 		Math::Vector4d params;
 		params.x() = l->falloffNear;
@@ -279,12 +338,12 @@ void OpenGLSActorRenderer::setLightArrayUniform(const char *uniform, const Light
 		params.z() = l->innerConeAngle.getCosine();
 		params.w() = l->outerConeAngle.getCosine();
 
-		_shader->setUniform(Common::String::format("lights[%d].params", i).c_str(), params);
+		_shader->setUniform(_lightUniforms[i].params, params);
 	}
 
-	for (uint i = lights.size() - 1; i < maxLights; i++) {
+	for (uint i = lights.size() - 1; i < kMaxLights; i++) {
 		// Make sure unused lights are disabled
-		_shader->setUniform(Common::String::format("lights[%d].position", i).c_str(), Math::Vector4d());
+		_shader->setUniform(_lightUniforms[i].position, Math::Vector4d());
 	}
 }
 
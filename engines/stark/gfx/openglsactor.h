@@ -23,20 +23,19 @@
 #ifndef STARK_GFX_OPENGL_S_ACTOR_H
 #define STARK_GFX_OPENGL_S_ACTOR_H
 
-#include "common/hashmap.h"
+#include "common/array.h"
 
-#include "engines/stark/hash-ptr.h"
 #include "engines/stark/gfx/renderentry.h"
 #include "engines/stark/visual/actor.h"
 
-namespace OpenGL {
-	class Shader;
-}
+#include "graphics/opengl/shader.h"
 
 namespace Stark {
 namespace Gfx {
 
 class OpenGLSDriver;
+class Texture;
+class TextureSet;
 
 class OpenGLSActorRenderer : public VisualActor {
 public:
@@ -45,22 +44,50 @@ public:
 
 	void render(const Math::Vector3d position, float direction, const LightEntryArray &lights) override;
 
+	/** The faces of the model using the same material, drawn with a single call */
+	struct DrawBatch {
+		uint32 materialIdx;
+		uint32 firstIndex;
+		uint32 indexCount;
+		const Texture *texture;
+	};
+
 protected:
-	typedef Common::HashMap<FaceNode *, uint32> FaceBufferMap;
+	static const uint kMaxLights = 10;
+
+	struct LightUniforms {
+		OpenGL::UniformHandle position;
+		OpenGL::UniformHandle direction;
+		OpenGL::UniformHandle color;
+		OpenGL::UniformHandle params;
+	};
 
 	OpenGLSDriver *_gfx;
 	OpenGL::Shader *_shader;
 
-	FaceBufferMap _faceVBO;
-	FaceBufferMap _faceEBO;
+	// The uniforms set for each batch are resolved once
+	OpenGL::UniformHandle _modelViewMatrixUniform;
+	OpenGL::UniformHandle _projectionMatrixUniform;
+	OpenGL::UniformHandle _normalMatrixUniform;
+	OpenGL::UniformHandle _texturedUniform;
+	OpenGL::UniformHandle _colorUniform;
+	OpenGL::UniformHandle _ambientColorUniform;
+	LightUniforms _lightUniforms[kMaxLights];
+
+	// All the faces of the model are stored in a single vertex buffer and index buffer,
+	// with the faces using the same material next to each other
+	uint32 _vertexVBO;
+	uint32 _indexEBO;
+	Common::Array<DrawBatch> _batches;
+	const TextureSet *_batchTextureSet; ///< The texture set the batch textures were resolved from
 
 	void clearVertices();
 	void uploadVertices();
-	uint32 createFaceVBO(const FaceNode *face);
-	uint32 createFaceEBO(const FaceNode *face);
+	float *writeFaceVertices(const FaceNode *face, float *vertPtr);
+	void resolveBatchTextures();
 	void setBonePositionArrayUniform(const char *uniform);
 	void setBoneRotationArrayUniform(const char *uniform);
-	void setLightArrayUniform(const char *uniform, const LightEntryArray &lights);
+	void setLightArrayUniform(const LightEntryArray &lights);
 };
 
 } // End of namespace Gfx
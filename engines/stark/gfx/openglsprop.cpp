@@ -27,6 +27,8 @@
 #include "engines/stark/gfx/driver.h"
 #include "engines/stark/gfx/texture.h"
 
+#include "common/algorithm.h"
+
 #include "graphics/opengl/shader.h"
 
 namespace Stark {
@@ -35,9 +37,14 @@ namespace Gfx {
 OpenGLSPropRenderer::OpenGLSPropRenderer(Driver *gfx) :
 		VisualProp(),
 		_gfx(gfx),
-		_faceVBO(-1) {
+		_faceVBO(-1),
+		_faceEBO(0) {
 	static const char* attributes[] = { "position", "normal", "texcoord", nullptr };
 	_shader = OpenGL::Shader::fromFiles("stark_prop", attributes);
+
+	_mvpUniform = _shader->getUniform("mvp");
+	_texturedUniform = _shader->getUniform("textured");
+	_colorUniform = _shader->getUniform("color");
 }
 
 OpenGLSPropRenderer::~OpenGLSPropRenderer() {
@@ -62,67 +69,88 @@ void OpenGLSPropRenderer::render(const Math::Vector3d position, float direction)
 	Math::Matrix4 mvp = projection * view * model;
 	mvp.transpose();
 
+	_shader->enableVertexAttribute("position", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 0);
+	_shader->enableVertexAttribute("normal", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 12);
+	_shader->enableVertexAttribute("texcoord", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 24);
 	_shader->use(true);
-	_shader->setUniform("mvp", mvp);
+	_shader->setUniform(_mvpUniform, mvp);
 
-	const Common::Array<Formats::BiffMesh::Face> &faces = _model->getFaces();
-	const Common::Array<Formats::BiffMesh::Material> &materials = _model->getMaterials();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _faceEBO);
 
-	for (Common::Array<Formats::BiffMesh::Face>::const_iterator face = faces.begin(); face != faces.end(); ++face) {
-		const Formats::BiffMesh::Material &material = materials[face->materialId];
+	const Common::Array<Formats::BiffMesh::Material> &materials = _model->getMaterials();
 
-		// For each face draw its vertices from the VBO, indexed by the EBO
-		const Gfx::Texture *tex = _texture->getTexture(material.texture);
-		if (tex) {
-			tex->bind();
-		} else {
-			glBindTexture(GL_TEXTURE_2D, 0);
+	for (uint i = 0; i < _batches.size(); i++) {
+		// The batches are sorted by texture, only bind it when it changes
+		const DrawBatch &batch = _batches[i];
+		if (i == 0 || batch.texture != _batches[i - 1].texture) {
+			if (batch.texture) {
+				batch.texture->bind();
+			} else {
+				glBindTexture(GL_TEXTURE_2D, 0);
+			}
 		}
 
-		GLuint ebo = _faceEBO[face];
-
-		_shader->enableVertexAttribute("position", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 0);
-		_shader->enableVertexAttribute("normal", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 12);
-		_shader->enableVertexAttribute("texcoord", _faceVBO, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), 24);
-		_shader->use(true);
-		_shader->setUniform("textured", tex != nullptr);
-		_shader->setUniform("color", Math::Vector3d(material.r, material.g, material.b));
+		const Formats::BiffMesh::Material &material = materials[batch.materialId];
+		_shader->setUniform(_texturedUniform, batch.texture != nullptr);
+		_shader->setUniform(_colorUniform, Math::Vector3d(material.r, material.g, material.b));
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glDrawElements(GL_TRIANGLES, face->vertexIndices.size(), GL_UNSIGNED_INT, 0);
-
-		glUseProgram(0);
+		glDrawElements(GL_TRIANGLES, batch.indexCount, GL_UNSIGNED_INT, (const GLvoid *)(batch.firstIndex * sizeof(uint32)));
 	}
+
+	glUseProgram(0);
 }
 
 void OpenGLSPropRenderer::clearVertices() {
 	OpenGL::Shader::freeBuffer(_faceVBO);
 	_faceVBO = -1;
 
-	for (FaceBufferMap::iterator it = _faceEBO.begin(); it != _faceEBO.end(); ++it) {
-		OpenGL::Shader::freeBuffer(it->_value);
+	if (_faceEBO) {
+		OpenGL::Shader::freeBuffer(_faceEBO);
+		_faceEBO = 0;
 	}
 
-	_faceEBO.clear();
+	_batches.clear();
 }
 
-void OpenGLSPropRenderer::uploadVertices() {
-	_faceVBO = createFaceVBO();
-
-	const Common::Array<Formats::BiffMesh::Face> &faces = _model->getFaces();
-	for (Common::Array<Formats::BiffMesh::Face>::const_iterator face = faces.begin(); face != faces.end(); ++face) {
-		_faceEBO[face] = createFaceEBO(face);
+struct PropBatchTextureLess {
+	bool operator()(const OpenGLSPropRenderer::DrawBatch &a, const OpenGLSPropRenderer::DrawBatch &b) const {
+		return a.texture < b.texture;
 	}
-}
+};
 
-uint32 OpenGLSPropRenderer::createFaceVBO() {
+void OpenGLSPropRenderer::uploadVertices() {
 	const Common::Array<Formats::BiffMesh::Vertex> &vertices = _model->getVertices();
+	const Common::Array<Formats::BiffMesh::Face> &faces = _model->getFaces();
+	const Common::Array<Formats::BiffMesh::Material> &materials = _model->getMaterials();
 
-	return OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, sizeof(float) * 9 * vertices.size(), &vertices.front());
-}
+	_faceVBO = OpenGL::Shader::createBuffer(GL_ARRAY_BUFFER, sizeof(float) * 9 * vertices.size(), &vertices.front());
+
+	// Build a single index buffer with the faces using the same material next to each other
+	Common::Array<uint32> indices;
+	for (uint32 i = 0; i < materials.size(); i++) {
+		DrawBatch batch;
+		batch.materialId = i;
+		batch.firstIndex = indices.size();
+		batch.texture = _texture->getTexture(materials[i].texture);
+
+		for (Common::Array<Formats::BiffMesh::Face>::const_iterator face = faces.begin(); face != faces.end(); ++face) {
+			if (face->materialId == i) {
+				indices.push_back(face->vertexIndices);
+			}
+		}
+
+		batch.indexCount = indices.size() - batch.firstIndex;
+		if (batch.indexCount > 0) {
+			_batches.push_back(batch);
+		}
+	}
+
+	if (!indices.empty()) {
+		_faceEBO = OpenGL::Shader::createBuffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32) * indices.size(), &indices.front());
+	}
 
-uint32 OpenGLSPropRenderer::createFaceEBO(const Formats::BiffMesh::Face *face) {
-	return OpenGL::Shader::createBuffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32) * face->vertexIndices.size(), &face->vertexIndices.front());
+	// Draw the batches using the same texture one after the other
+	Common::sort(_batches.begin(), _batches.end(), PropBatchTextureLess());
 }
 
 } // End of namespace Gfx
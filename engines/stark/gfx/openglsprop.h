@@ -23,21 +23,19 @@
 #ifndef STARK_GFX_OPENGL_S_RENDERED_H
 #define STARK_GFX_OPENGL_S_RENDERED_H
 
-#include "common/hashmap.h"
+#include "common/array.h"
 
-#include "engines/stark/hash-ptr.h"
 #include "engines/stark/formats/biffmesh.h"
 #include "engines/stark/visual/prop.h"
 
-namespace OpenGL {
-	class Shader;
-}
+#include "graphics/opengl/shader.h"
 
 namespace Stark {
 
 namespace Gfx {
 
 class Driver;
+class Texture;
 
 class OpenGLSPropRenderer : public VisualProp {
 public:
@@ -46,19 +44,28 @@ public:
 
 	void render(const Math::Vector3d position, float direction) override;
 
-protected:
-	typedef Common::HashMap<const Formats::BiffMesh::Face *, uint32> FaceBufferMap;
+	/** The faces of the mesh using the same material, drawn with a single call */
+	struct DrawBatch {
+		uint32 materialId;
+		uint32 firstIndex;
+		uint32 indexCount;
+		const Texture *texture;
+	};
 
+protected:
 	Driver *_gfx;
 	OpenGL::Shader *_shader;
 
+	OpenGL::UniformHandle _mvpUniform;
+	OpenGL::UniformHandle _texturedUniform;
+	OpenGL::UniformHandle _colorUniform;
+
 	int32 _faceVBO;
-	FaceBufferMap _faceEBO;
+	uint32 _faceEBO;
+	Common::Array<DrawBatch> _batches;
 
 	void clearVertices();
 	void uploadVertices();
-	uint32 createFaceVBO();
-	uint32 createFaceEBO(const Formats::BiffMesh::Face *face);
 };
 
 } // End of namespace Gfx
@@ -67,23 +67,31 @@ void AnimHandler::setModel(Model *model) {
 	_model = model;
 }
 
-void AnimHandler::setNode(uint32 time, BoneNode *bone, const BoneNode *parent) {
-	const Common::Array<BoneNode *> &bones = _model->getBones();
+void AnimHandler::sampleBones(uint32 time) {
+	_anim->getCoordForBones(time, _animCursors, _bonePositions, _boneRotations);
 
-	if (_blendTimeRemaining <= 0) {
-		_anim->getCoordForBone(time, bone->_idx, bone->_animPos, bone->_animRot);
-	} else {
+	if (_blendTimeRemaining > 0) {
 		// Blend the coordinates of the previous and the current animation
-		Math::Vector3d previousAnimPos, animPos;
-		Math::Quaternion previousAnimRot, animRot;
-		_blendAnim->getCoordForBone(_blendAnimTime, bone->_idx, previousAnimPos, previousAnimRot);
-		_anim->getCoordForBone(time, bone->_idx, animPos, animRot);
+		_blendAnim->getCoordForBones(_blendAnimTime, _blendAnimCursors, _blendBonePositions, _blendBoneRotations);
 
 		float blendingRatio = 1.0 - _blendTimeRemaining / (float)_blendDuration;
 
-		bone->_animPos = previousAnimPos + (animPos - previousAnimPos) * blendingRatio;
-		bone->_animRot = previousAnimRot.slerpQuat(animRot, blendingRatio);
+		uint32 boneCount = MIN(_anim->getBoneCount(), _blendAnim->getBoneCount());
+		for (uint32 i = 0; i < boneCount; i++) {
+			_bonePositions[i] = _blendBonePositions[i] + (_bonePositions[i] - _blendBonePositions[i]) * blendingRatio;
+		}
+
+		for (uint32 i = 0; i < boneCount; i++) {
+			_boneRotations[i] = _blendBoneRotations[i].slerpQuat(_boneRotations[i], blendingRatio);
+		}
 	}
+}
+
+void AnimHandler::setNode(BoneNode *bone, const BoneNode *parent) {
+	const Common::Array<BoneNode *> &bones = _model->getBones();
+
+	bone->_animPos = _bonePositions[bone->_idx];
+	bone->_animRot = _boneRotations[bone->_idx];
 
 	if (parent) {
 		parent->_animRot.transform(bone->_animPos);
@@ -93,7 +101,7 @@ void AnimHandler::setNode(uint32 time, BoneNode *bone, const BoneNode *parent) {
 	}
 
 	for (uint i = 0; i < bone->_children.size(); ++i) {
-		setNode(time, bones[bone->_children[i]], bone);
+		setNode(bones[bone->_children[i]], bone);
 	}
 }
 
@@ -116,7 +124,8 @@ void AnimHandler::animate(uint32 time) {
 
 	const Common::Array<BoneNode *> &bones = _model->getBones();
 	if (deltaTime >= 0) {
-		setNode(time, bones[0], nullptr);
+		sampleBones(time);
+		setNode(bones[0], nullptr);
 		_animTime = time;
 	}
 }
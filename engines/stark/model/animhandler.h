@@ -23,13 +23,17 @@
 #ifndef STARK_MODEL_ANIM_HANDLER_H
 #define STARK_MODEL_ANIM_HANDLER_H
 
-#include "common/scummsys.h"
+#include "engines/stark/model/skeleton_anim.h"
+
+#include "common/array.h"
+
+#include "math/quat.h"
+#include "math/vector3d.h"
 
 namespace Stark {
 
 class Model;
 class BoneNode;
-class SkeletonAnim;
 
 /**
  * Animate a skeletal model's bones according to an animation
@@ -58,12 +62,14 @@ private:
 	void updateBlending(int32 deltaTime);
 	void stopBlending();
 
-	void setNode(uint32 time, BoneNode *bone, const BoneNode *parent);
+	void sampleBones(uint32 time);
+	void setNode(BoneNode *bone, const BoneNode *parent);
 
 	static const uint32 _blendDuration = 300; // ms
 
 	SkeletonAnim *_anim;
 	int32 _animTime;
+	SkeletonAnim::BoneCursors _animCursors;
 
 	SkeletonAnim *_previousAnim;
 	int32 _previousAnimTime;
@@ -71,6 +77,13 @@ private:
 	SkeletonAnim *_blendAnim;
 	int32 _blendAnimTime;
 	int32 _blendTimeRemaining;
+	SkeletonAnim::BoneCursors _blendAnimCursors;
+
+	// The bone coordinates relative to their parent, indexed by bone
+	Common::Array<Math::Vector3d> _bonePositions;
+	Common::Array<Math::Quaternion> _boneRotations;
+	Common::Array<Math::Vector3d> _blendBonePositions;
+	Common::Array<Math::Quaternion> _blendBoneRotations;
 
 	Model *_model;
 };
@@ -52,55 +52,136 @@ void SkeletonAnim::createFromStream(ArchiveReadStream *stream) {
 
 	uint32 num = stream->readUint32LE();
 	_boneAnims.resize(num);
+	for (uint32 i = 0; i < num; ++i) {
+		_boneAnims[i]._firstKey = 0;
+		_boneAnims[i]._keyCount = 0;
+	}
+
 	for (uint32 i = 0; i < num; ++i) {
 		uint32 bone = stream->readUint32LE();
 		uint32 numKeys = stream->readUint32LE();
 
 		BoneAnim &boneAnim = _boneAnims[bone];
-		boneAnim._keys.resize(numKeys);
+		boneAnim._firstKey = _keyTimes.size();
+		boneAnim._keyCount = numKeys;
 		for (uint32 j = 0; j < numKeys; ++j) {
-			AnimKey &key = boneAnim._keys[j];
-			key._time = stream->readUint32LE();
-			key._rot = stream->readQuaternion();
-			key._pos = stream->readVector3();
+			_keyTimes.push_back(stream->readUint32LE());
+			_keyRotations.push_back(stream->readQuaternion());
+			_keyPositions.push_back(stream->readVector3());
 		}
 	}
 }
 
-void SkeletonAnim::getCoordForBone(uint32 time, int boneIdx, Math::Vector3d &pos, Math::Quaternion &rot) const {
-	const Common::Array<AnimKey> &keys = _boneAnims[boneIdx]._keys;
+uint32 SkeletonAnim::findKey(const BoneAnim &boneAnim, uint32 time, uint32 &nextKey) const {
+	const uint32 *times = &_keyTimes[boneAnim._firstKey];
+	uint32 count = boneAnim._keyCount;
 
-	if (keys.size() == 1) {
-		// There is only one key for this bone, don't bother searching which one to use
-		pos = keys[0]._pos;
-		rot = keys[0]._rot;
+	// Try the key found for the previous frame, and the following one
+	for (uint32 key = nextKey; key < count && key <= nextKey + 1; key++) {
+		if (times[key] >= time && (key == 0 || times[key - 1] < time)) {
+			nextKey = key;
+			return key;
+		}
+	}
 
-		return;
+	// Otherwise search for the first key at or after the time
+	uint32 first = 0;
+	uint32 last = count;
+	while (first < last) {
+		uint32 middle = first + (last - first) / 2;
+		if (times[middle] < time) {
+			first = middle + 1;
+		} else {
+			last = middle;
+		}
 	}
 
-	for (Common::Array<AnimKey>::const_iterator it = keys.begin(); it < keys.end(); ++it) {
-		if (it->_time == time) {
-			const AnimKey *key = it;
-			pos = key->_pos;
-			rot = key->_rot;
+	nextKey = first;
+	return first;
+}
+
+void SkeletonAnim::getCoordForBones(uint32 time, BoneCursors &cursors,
+                                    Common::Array<Math::Vector3d> &positions, Common::Array<Math::Quaternion> &rotations) const {
+	uint32 boneCount = _boneAnims.size();
+	if (cursors._nextKeys.size() != boneCount) {
+		cursors._nextKeys.resize(boneCount);
+		cursors._keysA.resize(boneCount);
+		cursors._keysB.resize(boneCount);
+		cursors._ratios.resize(boneCount);
+		for (uint32 i = 0; i < boneCount; i++) {
+			cursors._nextKeys[i] = 0;
+		}
+	}
 
-			return;
-		} else if (it->_time > time) {
-			// Between two key frames, interpolate
-			const AnimKey *a = it;
-			--it;
-			const AnimKey *b = it;
+	if (positions.size() < boneCount) {
+		positions.resize(boneCount);
+	}
 
-			float t = (float)(time - b->_time) / (float)(a->_time - b->_time);
+	if (rotations.size() < boneCount) {
+		rotations.resize(boneCount);
+	}
 
-			pos = b->_pos + (a->_pos - b->_pos) * t;
-			rot = b->_rot.slerpQuat(a->_rot, t);
+	// Find the keys to interpolate for each bone
+	for (uint32 i = 0; i < boneCount; i++) {
+		const BoneAnim &boneAnim = _boneAnims[i];
 
-			return;
+		if (boneAnim._keyCount == 1) {
+			// There is only one key for this bone, don't bother searching which one to use
+			cursors._keysA[i] = boneAnim._firstKey;
+			cursors._keysB[i] = boneAnim._firstKey;
+			cursors._ratios[i] = 0.0f;
+			continue;
+		}
+
+		uint32 key = boneAnim._keyCount ? findKey(boneAnim, time, cursors._nextKeys[i]) : 0;
+		if (key == boneAnim._keyCount) {
+			warning("Unable to animate bone '%d' at %d ms", i, time);
+			cursors._keysA[i] = kNoKey;
+			continue;
+		}
+
+		uint32 keyB = boneAnim._firstKey + key;
+		if (_keyTimes[keyB] == time || key == 0) {
+			cursors._keysA[i] = keyB;
+			cursors._keysB[i] = keyB;
+			cursors._ratios[i] = 0.0f;
+		} else {
+			// Between two key frames, interpolate
+			uint32 keyA = keyB - 1;
+			cursors._keysA[i] = keyA;
+			cursors._keysB[i] = keyB;
+			cursors._ratios[i] = (float)(time - _keyTimes[keyA]) / (float)(_keyTimes[keyB] - _keyTimes[keyA]);
 		}
 	}
 
-	warning("Unable to animate bone '%d' at %d ms", boneIdx, time);
+	// Interpolate the positions, then the rotations
+	for (uint32 i = 0; i < boneCount; i++) {
+		uint32 keyA = cursors._keysA[i];
+		uint32 keyB = cursors._keysB[i];
+		if (keyA == kNoKey) {
+			continue;
+		}
+
+		if (keyA == keyB) {
+			positions[i] = _keyPositions[keyA];
+		} else {
+			positions[i] = _keyPositions[keyA] + (_keyPositions[keyB] - _keyPositions[keyA]) * cursors._ratios[i];
+		}
+	}
+
+	for (uint32 i = 0; i < boneCount; i++) {
+		uint32 keyA = cursors._keysA[i];
+		uint32 keyB = cursors._keysB[i];
+		if (keyA == kNoKey) {
+			continue;
+		}
+
+		if (keyA == keyB) {
+			rotations[i] = _keyRotations[keyA];
+		} else {
+			rotations[i] = _keyRotations[keyA].slerpQuat(_keyRotations[keyB], cursors._ratios[i]);
+		}
+	}
 }
 
 } // End of namespace Stark
@@ -33,17 +33,45 @@ class ArchiveReadStream;
 
 /**
  * Data structure responsible for skeletal animation of an actor object.
+ *
+ * The keys of all the bones are stored as a structure of arrays, so the bones
+ * can be interpolated in batches.
  */
 class SkeletonAnim {
 public:
+	/**
+	 * The playback state of the animation for one of its users
+	 *
+	 * The position of the keys used for each bone is remembered, so finding
+	 * the keys for the next frame is constant time when the animation is
+	 * played forward. Any time can still be sampled, at the cost of a binary search.
+	 */
+	struct BoneCursors {
+		Common::Array<uint32> _nextKeys; ///< Per bone index of the first key at or after the last sampled time
+
+		// Per bone interpolation parameters for the time being sampled
+		Common::Array<uint32> _keysA;
+		Common::Array<uint32> _keysB;
+		Common::Array<float> _ratios;
+	};
+
 	SkeletonAnim();
 
 	void createFromStream(ArchiveReadStream *stream);
 
+	/** Get the number of animated bones */
+	uint32 getBoneCount() const { return _boneAnims.size(); }
+
 	/**
-	 * Get the interpolated bone coordinate for a given bone at a given animation timestamp
+	 * Get the interpolated bone coordinates for all the bones at a given animation timestamp
+	 *
+	 * @param time      The animation timestamp
+	 * @param cursors   The playback state of the caller
+	 * @param positions The bone positions, indexed by bone. Resized to the bone count if needed.
+	 * @param rotations The bone rotations, indexed by bone. Resized to the bone count if needed.
 	 */
-	void getCoordForBone(uint32 time, int boneIdx, Math::Vector3d &pos, Math::Quaternion &rot) const;
+	void getCoordForBones(uint32 time, BoneCursors &cursors,
+	                      Common::Array<Math::Vector3d> &positions, Common::Array<Math::Quaternion> &rotations) const;
 
 	/**
 	 * Get total animation length (in ms)
@@ -51,19 +79,23 @@ public:
 	uint32 getLength() const { return _time; }
 
 private:
-	struct AnimKey {
-		uint32 _time;
-		Math::Quaternion _rot;
-		Math::Vector3d _pos;
-	};
-
 	struct BoneAnim {
-		Common::Array<AnimKey> _keys;
+		uint32 _firstKey;
+		uint32 _keyCount;
 	};
 
+	static const uint32 kNoKey = 0xFFFFFFFF;
+
+	uint32 findKey(const BoneAnim &boneAnim, uint32 time, uint32 &nextKey) const;
+
 	uint32 _id, _ver, _u1, _u2, _time;
 
 	Common::Array<BoneAnim> _boneAnims;
+
+	// The keys of all the bones, grouped by bone
+	Common::Array<uint32> _keyTimes;
+	Common::Array<Math::Quaternion> _keyRotations;
+	Common::Array<Math::Vector3d> _keyPositions;
 };
 
 } // End of namespace Stark
@@ -22,79 +22,210 @@
 
 #include "engines/stark/movement/shortestpath.h"
 
-#include "engines/stark/hash-ptr.h"
 #include "engines/stark/resources/floor.h"
 
 namespace Stark {
 
+ShortestPath::ShortestPath() :
+		_searchId(0) {
+}
+
+void ShortestPath::setNodeCount(uint count) {
+	NodeState state;
+	state.searchId = 0;
+	state.costSoFar = 0;
+	state.heapPosition = -1;
+	state.cameFrom = nullptr;
+
+	_states.clear();
+	_states.resize(count);
+	for (uint i = 0; i < count; i++) {
+		_states[i] = state;
+	}
+
+	_frontier.clear();
+	_searchId = 0;
+
+	clearCache();
+}
+
+void ShortestPath::clearCache() {
+	_cache.clear();
+}
+
 ShortestPath::NodeList ShortestPath::search(const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
-	NodeList frontier;
-	NodePrecedenceMap cameFrom;
-	NodeCostMap costSoFar;
+	for (Common::List<CachedPath>::iterator it = _cache.begin(); it != _cache.end(); it++) {
+		if (it->start == start && it->goal == goal) {
+			NodeList path = it->path;
+
+			// Move the path to the front of the list, so the least recently used one is evicted first
+			if (it != _cache.begin()) {
+				_cache.push_front(*it);
+				_cache.erase(it);
+			}
+
+			return path;
+		}
+	}
+
+	CachedPath cached;
+	cached.start = start;
+	cached.goal = goal;
+	cached.path = computePath(start, goal);
+
+	if (_cache.size() >= kCacheSize) {
+		_cache.pop_back();
+	}
+	_cache.push_front(cached);
+
+	return cached.path;
+}
+
+ShortestPath::NodeState &ShortestPath::getState(const Resources::FloorEdge *edge) {
+	NodeState &state = _states[edge->getIndex()];
+	if (state.searchId != _searchId) {
+		state.searchId = _searchId;
+		state.costSoFar = 0;
+		state.heapPosition = -1;
+		state.cameFrom = nullptr;
+	}
 
-	frontier.push_back(start);
-	cameFrom[start] = nullptr;
-	costSoFar[start] = 0;
+	return state;
+}
 
-	while (!frontier.empty()) {
-		const Resources::FloorEdge *current = popEdgeWithLowestCost(frontier, costSoFar);
+ShortestPath::NodeList ShortestPath::computePath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
+	// Using a new search id invalidates the state of all the nodes at once
+	_searchId++;
+	if (_searchId == 0) {
+		for (uint i = 0; i < _states.size(); i++) {
+			_states[i].searchId = 0;
+		}
+		_searchId = 1;
+	}
+
+	_frontier.clear();
+
+	NodeState &startState = getState(start);
+	startState.cameFrom = start;
+	pushOrUpdateFrontier(start, start->costTo(goal));
+
+	while (!_frontier.empty()) {
+		const Resources::FloorEdge *current = popFrontier();
 
 		if (current == goal)
 			break;
 
-		Common::Array<Resources::FloorEdge *> neighbours = current->getNeighbours();
+		float currentCost = getState(current).costSoFar;
+
+		const Common::Array<Resources::FloorEdge *> &neighbours = current->getNeighbours();
 		for (uint i = 0; i < neighbours.size(); i++) {
 			const Resources::FloorEdge *next = neighbours[i];
 			if (!next->isEnabled())
 				continue;
 
-			float newCost = costSoFar[current] + current->costTo(next);
-			if (!costSoFar.contains(next) || newCost < costSoFar[next]) {
-				frontier.push_back(next);
-				cameFrom[next] = current;
-				costSoFar[next] = newCost;
+			NodeState &nextState = getState(next);
+			float newCost = currentCost + current->costTo(next);
+			if (!nextState.cameFrom || newCost < nextState.costSoFar) {
+				nextState.cameFrom = current;
+				nextState.costSoFar = newCost;
+				pushOrUpdateFrontier(next, newCost + next->costTo(goal));
 			}
 		}
 	}
 
-	return rebuildPath(start, goal, cameFrom);
+	return rebuildPath(start, goal);
 }
 
-ShortestPath::NodeList ShortestPath::rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal,
-                                                 const NodePrecedenceMap &cameFrom) const {
+ShortestPath::NodeList ShortestPath::rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
+	if (!getState(goal).cameFrom) {
+		// No path has been found from start to goal
+		return NodeList();
+	}
+
 	NodeList path;
 
 	const Resources::FloorEdge *current = goal;
 	path.push_front(goal);
 
-	while (current && current != start) {
-		current = cameFrom[current];
+	while (current != start) {
+		current = getState(current).cameFrom;
 		path.push_front(current);
 	}
 
-	if (current != start) {
-		// No path has been found from start to goal
-		return NodeList();
-	}
-
 	path.push_front(start);
 	return path;
 }
 
-const Resources::FloorEdge *ShortestPath::popEdgeWithLowestCost(NodeList &frontier, const NodeCostMap &costSoFar) const {
-	// Poor man's priority queue using a list ...
-	NodeList::iterator lowestCostItem = frontier.begin();
-	for (NodeList::iterator it = frontier.begin(); it != frontier.end(); it++) {
-		if (costSoFar[*it] < costSoFar[*lowestCostItem]) {
-			lowestCostItem = it;
-		}
+void ShortestPath::pushOrUpdateFrontier(const Resources::FloorEdge *edge, float estimatedCost) {
+	FrontierNode node;
+	node.edge = edge;
+	node.estimatedCost = estimatedCost;
+
+	int32 position = getState(edge).heapPosition;
+	if (position < 0) {
+		_frontier.push_back(node);
+		position = _frontier.size() - 1;
 	}
 
-	const Resources::FloorEdge *result = *lowestCostItem;
+	// The estimated cost of a node can only decrease
+	placeInHeap(node, position);
+	siftUp(position);
+}
 
-	frontier.erase(lowestCostItem);
+const Resources::FloorEdge *ShortestPath::popFrontier() {
+	const Resources::FloorEdge *result = _frontier[0].edge;
+	getState(result).heapPosition = -1;
+
+	FrontierNode last = _frontier.back();
+	_frontier.pop_back();
+
+	if (!_frontier.empty()) {
+		placeInHeap(last, 0);
+		siftDown(0);
+	}
 
 	return result;
 }
 
+void ShortestPath::siftUp(uint position) {
+	FrontierNode node = _frontier[position];
+
+	while (position > 0) {
+		uint parent = (position - 1) / 2;
+		if (_frontier[parent].estimatedCost <= node.estimatedCost)
+			break;
+
+		placeInHeap(_frontier[parent], position);
+		position = parent;
+	}
+
+	placeInHeap(node, position);
+}
+
+void ShortestPath::siftDown(uint position) {
+	FrontierNode node = _frontier[position];
+
+	while (true) {
+		uint child = position * 2 + 1;
+		if (child >= _frontier.size())
+			break;
+
+		if (child + 1 < _frontier.size() && _frontier[child + 1].estimatedCost < _frontier[child].estimatedCost)
+			child++;
+
+		if (node.estimatedCost <= _frontier[child].estimatedCost)
+			break;
+
+		placeInHeap(_frontier[child], position);
+		position = child;
+	}
+
+	placeInHeap(node, position);
+}
+
+void ShortestPath::placeInHeap(const FrontierNode &node, uint position) {
+	_frontier[position] = node;
+	getState(node.edge).heapPosition = position;
+}
+
 } // End of namespace Stark
@@ -23,8 +23,8 @@
 #ifndef STARK_MOVEMENT_SHORTEST_PATH_H
 #define STARK_MOVEMENT_SHORTEST_PATH_H
 
+#include "common/array.h"
 #include "common/list.h"
-#include "common/hashmap.h"
 
 namespace Stark {
 
@@ -35,23 +35,67 @@ class FloorEdge;
 /**
  * Find the shortest path between two nodes in a graph
  *
- * This is an implementation of Dijsktra's search algorithm
+ * This is an implementation of the A* search algorithm, using the straight
+ * line distance to the goal as the heuristic. The nodes are the floor edges,
+ * identified by their index in the floor.
+ *
+ * The search data is kept between the searches to avoid allocations,
+ * and the most recently found paths are cached.
  */
 class ShortestPath {
 public:
 	typedef Common::List<const Resources::FloorEdge *> NodeList;
 
+	ShortestPath();
+
+	/** Set the number of nodes in the graph, and clear the cached paths */
+	void setNodeCount(uint count);
+
 	/** Computes the shortest path between the start and the goal graph nodes */
 	NodeList search(const Resources::FloorEdge *start, const Resources::FloorEdge *goal);
 
+	/** Forget the cached paths, must be called when the graph nodes are enabled or disabled */
+	void clearCache();
+
 private:
-	typedef Common::HashMap<const Resources::FloorEdge *, const Resources::FloorEdge *> NodePrecedenceMap;
-	typedef Common::HashMap<const Resources::FloorEdge *, float> NodeCostMap;
+	static const uint kCacheSize = 8;
+
+	struct CachedPath {
+		const Resources::FloorEdge *start;
+		const Resources::FloorEdge *goal;
+		NodeList path;
+	};
+
+	/** The search state of a node, only valid when its search id matches the current one */
+	struct NodeState {
+		uint32 searchId;
+		float costSoFar;
+		int32 heapPosition; ///< -1 when the node is not in the frontier
+		const Resources::FloorEdge *cameFrom;
+	};
+
+	/** A node in the frontier, sorted by estimated total cost */
+	struct FrontierNode {
+		const Resources::FloorEdge *edge;
+		float estimatedCost;
+	};
+
+	NodeState &getState(const Resources::FloorEdge *edge);
+
+	void pushOrUpdateFrontier(const Resources::FloorEdge *edge, float estimatedCost);
+	const Resources::FloorEdge *popFrontier();
+	void siftUp(uint position);
+	void siftDown(uint position);
+	void placeInHeap(const FrontierNode &node, uint position);
+
+	NodeList computePath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal);
+	NodeList rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal);
 
-	const Resources::FloorEdge *popEdgeWithLowestCost(NodeList &frontier, const NodeCostMap &costSoFar) const;
+	Common::Array<NodeState> _states;
+	Common::Array<FrontierNode> _frontier; ///< Binary heap
+	uint32 _searchId;
 
-	NodeList rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal,
-	                                    const NodePrecedenceMap &cameFrom) const;
+	Common::List<CachedPath> _cache; ///< Most recently used first
 };
 
 } // End of namespace Stark
@@ -88,8 +88,7 @@ void Walk::updatePath() const {
 		return;
 	}
 
-	ShortestPath pathSearch;
-	ShortestPath::NodeList edgePath = pathSearch.search(startFloorEdge, destinationFloorEdge);
+	ShortestPath::NodeList edgePath = floor->findShortestPath(startFloorEdge, destinationFloorEdge);
 
 
 	for (ShortestPath::NodeList::const_iterator it = edgePath.begin(); it != edgePath.end(); it++) {
@@ -48,9 +48,13 @@ Math::Vector3d Floor::getVertex(uint32 index) const {
 }
 
 int32 Floor::findFaceContainingPoint(const Math::Vector3d &point) const {
-	for (uint32 i = 0; i < _faces.size(); i++) {
-		if (_faces[i]->isPointInside(point)) {
-			return i;
+	// The cells list their faces by increasing index, the first match is
+	// the same as when testing all the faces in order
+	uint faceCount;
+	const uint32 *faces = _faceGrid.findItemsAtPoint(point, faceCount);
+	for (uint i = 0; i < faceCount; i++) {
+		if (_faces[faces[i]]->isPointInside(point)) {
+			return faces[i];
 		}
 	}
 
@@ -62,26 +66,57 @@ void Floor::computePointHeightInFace(Math::Vector3d &point, uint32 faceIndex) co
 }
 
 int32 Floor::findFaceHitByRay(const Math::Ray &ray, Math::Vector3d &intersection) const {
-	for (uint32 i = 0; i < _faces.size(); i++) {
-		// TODO: Check the ray's intersection with an AABB first if this ends up being slow
-		if (_faces[i]->intersectRay(ray, intersection)) {
-			return i;
+	_gridItems.clear();
+	_faceGrid.findItemsAlongRay(ray, _gridItems);
+
+	// Keep the face with the lowest index, as when testing all the faces in order
+	int32 hitFace = -1;
+	Math::Vector3d faceIntersection;
+	for (uint i = 0; i < _gridItems.size(); i++) {
+		int32 faceIndex = _gridItems[i];
+		if (hitFace >= 0 && faceIndex > hitFace) {
+			continue;
+		}
+
+		if (_faces[faceIndex]->intersectRay(ray, faceIntersection)) {
+			hitFace = faceIndex;
+			intersection = faceIntersection;
 		}
 	}
 
-	return -1;
+	return hitFace;
 }
 
 int32 Floor::findFaceClosestToRay(const Math::Ray &ray, Math::Vector3d &center) const {
 	float minDistance = FLT_MAX;
 	int32 minFace = -1;
-	for (uint32 i = 0; i < _faces.size(); i++) {
-		if (_faces[i]->hasVertices()) {
-			float distance = _faces[i]->distanceToRay(ray);
-			if (distance < minDistance) {
-				minFace = i;
-				minDistance = distance;
-			}
+
+	// Start with the faces along the ray, they are likely to be the closest ones
+	_gridItems.clear();
+	_faceGrid.findItemsAlongRay(ray, _gridItems);
+	for (uint i = 0; i < _gridItems.size(); i++) {
+		updateClosestFace(ray, _gridItems[i], minFace, minDistance);
+	}
+
+	// Then skip the cells too far away from the ray to contain a closer face center
+	float directionLength = ray.getDirection().getMagnitude();
+	for (uint cell = 0; cell < _faceGrid.getCellCount(); cell++) {
+		const Math::AABB &bounds = _faceGrid.getCellBounds(cell);
+		if (!bounds.isValid()) {
+			continue;
+		}
+
+		Math::Vector3d cellCenter = (bounds.getMin() + bounds.getMax()) / 2.0;
+		float cellRadius = (bounds.getMax() - bounds.getMin()).getMagnitude() / 2.0;
+		float cellDistance = Math::Vector3d::crossProduct(ray.getDirection(), cellCenter - ray.getOrigin()).getMagnitude();
+		if (minFace >= 0 && cellDistance - cellRadius * directionLength > minDistance) {
+			continue;
+		}
+
+		uint faceCount;
+		const uint32 *faces = _faceGrid.getCellItems(cell, faceCount);
+		for (uint i = 0; i < faceCount; i++) {
+			updateClosestFace(ray, faces[i], minFace, minDistance);
 		}
 	}
 
@@ -92,6 +127,19 @@ int32 Floor::findFaceClosestToRay(const Math::Ray &ray, Math::Vector3d &center)
 	return minFace;
 }
 
+void Floor::updateClosestFace(const Math::Ray &ray, int32 faceIndex, int32 &minFace, float &minDistance) const {
+	if (!_faces[faceIndex]->hasVertices()) {
+		return;
+	}
+
+	// On equal distances, keep the face with the lowest index, as when testing all the faces in order
+	float distance = _faces[faceIndex]->distanceToRay(ray);
+	if (distance < minDistance || (distance == minDistance && minFace >= 0 && faceIndex < minFace)) {
+		minFace = faceIndex;
+		minDistance = distance;
+	}
+}
+
 float Floor::getDistanceFromCamera(uint32 faceIndex) const {
 	FloorFace *face = _faces[faceIndex];
 	return face->getDistanceFromCamera();
@@ -111,9 +159,16 @@ bool Floor::isSegmentInside(const Math::Line3d &segment) const {
 		return false;
 	}
 
-	for (uint i = 0; i < _edges.size(); i++) {
-		const FloorEdge &edge = _edges[i];
-		if (edge.isFloorBorder() && edge.intersectsSegment(this, segment)) {
+	Math::Vector3d begin = segment.begin();
+	Math::Vector3d end = segment.end();
+
+	_gridItems.clear();
+	_borderEdgeGrid.findItemsInRect(MIN(begin.x(), end.x()), MIN(begin.y(), end.y()),
+	                                MAX(begin.x(), end.x()), MAX(begin.y(), end.y()), _gridItems);
+
+	for (uint i = 0; i < _gridItems.size(); i++) {
+		const FloorEdge &edge = _edges[_gridItems[i]];
+		if (edge.intersectsSegment(this, segment)) {
 			return false;
 		}
 	}
@@ -137,12 +192,17 @@ void Floor::onAllLoaded() {
 	_faces = listChildren<FloorFace>();
 
 	buildEdgeList();
+	buildGrids();
 }
 
 void Floor::saveLoad(ResourceSerializer *serializer) {
 	for (uint i = 0; i < _edges.size(); i++) {
 		_edges[i].saveLoad(serializer);
 	}
+
+	if (serializer->isLoading()) {
+		_shortestPath.clearCache();
+	}
 }
 
 void Floor::buildEdgeList() {
@@ -176,6 +236,32 @@ void Floor::buildEdgeList() {
 		_edges[i].buildNeighbours(this);
 		_edges[i].computeMiddle(this);
 	}
+
+	_shortestPath.setNodeCount(_edges.size());
+}
+
+void Floor::buildGrids() {
+	Common::Array<Math::AABB> faceBoxes;
+	faceBoxes.resize(_faces.size());
+	for (uint i = 0; i < _faces.size(); i++) {
+		for (uint j = 0; j < 3; j++) {
+			faceBoxes[i].expand(getVertex(_faces[i]->getVertexIndex(j)));
+		}
+	}
+
+	_faceGrid.build(faceBoxes);
+
+	// Only the border edges are needed to check if a segment leaves the floor,
+	// the other edges are left out with an invalid box
+	Common::Array<Math::AABB> edgeBoxes;
+	edgeBoxes.resize(_edges.size());
+	for (uint i = 0; i < _edges.size(); i++) {
+		if (_edges[i].isFloorBorder()) {
+			edgeBoxes[i] = _edges[i].getBoundingBox(this);
+		}
+	}
+
+	_borderEdgeGrid.build(edgeBoxes);
 }
 
 void Floor::addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2) {
@@ -192,7 +278,7 @@ void Floor::addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2) {
 		}
 	}
 
-	_edges.push_back(FloorEdge(startIndex, endIndex, faceIndex));
+	_edges.push_back(FloorEdge(_edges.size(), startIndex, endIndex, faceIndex));
 }
 
 void Floor::enableFloorField(FloorField *floorfield, bool enable) {
@@ -201,6 +287,13 @@ void Floor::enableFloorField(FloorField *floorfield, bool enable) {
 			_faces[i]->enable(enable);
 		}
 	}
+
+	// The cached paths may go through the changed edges
+	_shortestPath.clearCache();
+}
+
+ShortestPath::NodeList Floor::findShortestPath(const FloorEdge *start, const FloorEdge *goal) {
+	return _shortestPath.search(start, goal);
 }
 
 void Floor::printData() {
@@ -212,7 +305,8 @@ void Floor::printData() {
 	}
 }
 
-FloorEdge::FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1) :
+FloorEdge::FloorEdge(uint32 index, uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1) :
+        _index(index),
         _vertexIndex1(vertexIndex1),
         _vertexIndex2(vertexIndex2),
         _faceIndex1(faceIndex1),
@@ -220,6 +314,10 @@ FloorEdge::FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1
         _enabled(true) {
 }
 
+uint32 FloorEdge::getIndex() const {
+	return _index;
+}
+
 bool FloorEdge::hasVertices(uint16 vertexIndex1, uint16 vertexIndex2) const {
 	return _vertexIndex1 == vertexIndex1 && _vertexIndex2 == vertexIndex2;
 }
@@ -228,7 +326,7 @@ void FloorEdge::setOtherFace(uint32 faceIndex) {
 	_faceIndex2 = faceIndex;
 }
 
-Common::Array<FloorEdge *> FloorEdge::getNeighbours() const {
+const Common::Array<FloorEdge *> &FloorEdge::getNeighbours() const {
 	return _neighbours;
 }
 
@@ -279,6 +377,13 @@ bool FloorEdge::isFloorBorder() const {
 	return _faceIndex2 == -1;
 }
 
+Math::AABB FloorEdge::getBoundingBox(const Floor *floor) const {
+	Math::AABB boundingBox;
+	boundingBox.expand(floor->getVertex(_vertexIndex1));
+	boundingBox.expand(floor->getVertex(_vertexIndex2));
+	return boundingBox;
+}
+
 bool FloorEdge::intersectsSegment(const Floor *floor, const Math::Line3d &segment) const {
 	Math::Vector3d vertex1 = floor->getVertex(_vertexIndex1);
 	Math::Vector3d vertex2 = floor->getVertex(_vertexIndex2);
@@ -26,10 +26,13 @@
 #include "common/array.h"
 #include "common/str.h"
 
+#include "math/aabb.h"
 #include "math/line3d.h"
 #include "math/ray.h"
+#include "math/uniformgrid.h"
 #include "math/vector3d.h"
 
+#include "engines/stark/movement/shortestpath.h"
 #include "engines/stark/resources/object.h"
 
 namespace Stark {
@@ -51,7 +54,10 @@ class FloorField;
  */
 class FloorEdge {
 public:
-	FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1);
+	FloorEdge(uint32 index, uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1);
+
+	/** Get the index of the edge in the floor */
+	uint32 getIndex() const;
 
 	/** Build a list of neighbour edges in the graph */
 	void buildNeighbours(const Floor *floor);
@@ -66,7 +72,7 @@ public:
 	bool hasVertices(uint16 vertexIndex1, uint16 vertexIndex2) const;
 
 	/** List the edge neighbour edges in the floor */
-	Common::Array<FloorEdge *> getNeighbours() const;
+	const Common::Array<FloorEdge *> &getNeighbours() const;
 
 	/**
 	 * Computes the cost for going to a neighbour edge
@@ -86,6 +92,9 @@ public:
 	/** Is this edge on the floor border? */
 	bool isFloorBorder() const;
 
+	/** Get the bounding box of the edge */
+	Math::AABB getBoundingBox(const Floor *floor) const;
+
 	/** Does the segment intersect the edge in the 2D plane? */
 	bool intersectsSegment(const Floor *floor, const Math::Line3d &segment) const;
 
@@ -104,6 +113,7 @@ public:
 private:
 	void addNeighboursFromFace(const FloorFace *face);
 
+	uint32 _index;
 	uint16 _vertexIndex1;
 	uint16 _vertexIndex2;
 	Math::Vector3d _middle;
@@ -176,17 +186,29 @@ public:
 	/** Allow or disallow characters to walk on some faces of the floor */
 	void enableFloorField(FloorField *floorfield, bool enable);
 
+	/** Find the shortest path between two edges, using only the enabled edges */
+	ShortestPath::NodeList findShortestPath(const FloorEdge *start, const FloorEdge *goal);
+
 protected:
 	void readData(Formats::XRCReadStream *stream) override;
 	void printData() override;
 
 	void buildEdgeList();
 	void addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2);
+	void buildGrids();
+	void updateClosestFace(const Math::Ray &ray, int32 faceIndex, int32 &minFace, float &minDistance) const;
 
 	uint32 _facesCount;
 	Common::Array<Math::Vector3d> _vertices;
 	Common::Array<FloorFace *> _faces;
 	Common::Array<FloorEdge> _edges;
+
+	ShortestPath _shortestPath;
+
+	// Spatial indices used to only test the faces and border edges close to the queries
+	Math::UniformGrid _faceGrid;
+	Math::UniformGrid _borderEdgeGrid;
+	mutable Common::Array<uint32> _gridItems;
 };
 
 } // End of namespace Resources
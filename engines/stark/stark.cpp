@@ -42,6 +42,7 @@
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
 #include "common/events.h"
+#include "common/profiler.h"
 #include "common/random.h"
 #include "common/savefile.h"
 #include "common/system.h"
@@ -235,6 +236,8 @@ void StarkEngine::updateDisplayScene() {
 
 	// Only update the world resources when on the game screen
 	if (_userInterface->isInGameScreen()) {
+		PROFILE_ZONE("Resource update");
+
 		// Update the game resources
 		_global->getLevel()->onGameLoop();
 		_global->getCurrent()->getLevel()->onGameLoop();
@@ -243,13 +246,25 @@ void StarkEngine::updateDisplayScene() {
 
 	// Render the current scene
 	// Update the UI state before displaying the scene
-	_userInterface->update();
+	{
+		PROFILE_ZONE("UI update");
+		_userInterface->update();
+	}
 
 	// Tell the UI to render, and update implicitly, if this leads to new mouse-over events.
-	_userInterface->render();
+	{
+		PROFILE_ZONE("Draw");
+		_userInterface->render();
+	}
 
 	// Swap buffers
-	_gfx->flipBuffer();
+	{
+		PROFILE_ZONE("Present");
+		_gfx->flipBuffer();
+	}
+
+	if (Common::Profiler::isEnabled())
+		ProfileMan.endFrame();
 }
 
 bool StarkEngine::hasFeature(EngineFeature f) const {
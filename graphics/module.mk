@@ -26,6 +26,7 @@ MODULE_OBJS := \
 	wincursor.o \
 	yuv_to_rgb.o \
 	yuva_to_rgba.o \
+	yuv_to_rgb_simd.o \
 	pixelbuffer.o \
 	opengl/context.o \
 	opengl/framebuffer.o \
@@ -55,6 +56,7 @@ MODULE_OBJS := \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o \
@@ -51,6 +51,7 @@ void Context::reset() {
 	unpackSubImageSupported = false;
 	framebufferObjectMultisampleSupported = false;
 	multisampleMaxSamples = -1;
+	maxVertexUniformVectors = 0;
 }
 
 void Context::initialize(ContextType contextType) {
@@ -128,6 +129,18 @@ void Context::initialize(ContextType contextType) {
 		}
 	}
 
+	if (shadersSupported) {
+		if (type == kContextGLES2) {
+			glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, (GLint *)&maxVertexUniformVectors);
+		} else {
+			// GL_MAX_VERTEX_UNIFORM_VECTORS is only available since OpenGL 4.1
+			GLint maxVertexUniformComponents;
+			glGetIntegerv(GL_MAX_VERTEX_UNIFORM_COMPONENTS, &maxVertexUniformComponents);
+			maxVertexUniformVectors = maxVertexUniformComponents / 4;
+		}
+		debug(5, "OpenGL maximum vertex uniform vectors: %d", maxVertexUniformVectors);
+	}
+
 	// Log context type.
 	switch (type) {
 		case kContextGL:
@@ -86,6 +86,12 @@ public:
 	/** Whether specifying a pitch when uploading to textures is available or not */
 	bool unpackSubImageSupported;
 
+	/**
+	 * The number of vec4 uniforms available to the vertex shaders if shaders
+	 * are supported. Contains 0 otherwise.
+	 */
+	int maxVertexUniformVectors;
+
 	int getGLSLVersion() const;
 };
 
@@ -71,18 +71,19 @@ static GLuint createDirectShader(const char *shaderSource, GLenum shaderType, co
 	return shader;
 }
 
-static GLuint createCompatShader(const char *shaderSource, GLenum shaderType, const Common::String &name) {
+static GLuint createCompatShader(const char *shaderSource, GLenum shaderType, const Common::String &name, const char *defines) {
 	const GLchar *versionSource = OpenGLContext.type == kContextGLES2 ? "#version 100\n" : "#version 120\n";
 	const GLchar *compatSource =
 			shaderType == GL_VERTEX_SHADER ? OpenGL::BuiltinShaders::compatVertex : OpenGL::BuiltinShaders::compatFragment;
 	const GLchar *shaderSources[] = {
 		versionSource,
+		defines ? defines : "",
 		compatSource,
 		shaderSource
 	};
 
 	GLuint shader = glCreateShader(shaderType);
-	glShaderSource(shader, 3, shaderSources, NULL);
+	glShaderSource(shader, 4, shaderSources, NULL);
 	glCompileShader(shader);
 
 	GLint status;
@@ -96,11 +97,11 @@ static GLuint createCompatShader(const char *shaderSource, GLenum shaderType, co
 	return shader;
 }
 
-static GLuint loadShaderFromFile(const char *base, const char *extension, GLenum shaderType) {
+static GLuint loadShaderFromFile(const char *base, const char *extension, GLenum shaderType, const char *defines) {
 	const Common::String filename = Common::String(base) + "." + extension;
 	const GLchar *shaderSource = readFile(filename);
 
-	GLuint shader = createCompatShader(shaderSource, shaderType, filename);
+	GLuint shader = createCompatShader(shaderSource, shaderType, filename, defines);
 
 	delete[] shaderSource;
 
@@ -141,7 +142,70 @@ Shader::Shader(const Common::String &name, GLuint vertexShader, GLuint fragmentS
 	glDeleteShader(fragmentShader);
 
 	_shaderNo = Common::SharedPtr<GLuint>(new GLuint(shaderProgram), SharedPtrProgramDeleter());
-	_uniforms = Common::SharedPtr<UniformsMap>(new UniformsMap());
+	_uniforms = Common::SharedPtr<UniformTable>(new UniformTable());
+
+	resolveActiveUniforms();
+}
+
+void Shader::resolveActiveUniforms() {
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(*_shaderNo, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(*_shaderNo, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	Common::Array<GLchar> name;
+	name.resize(maxLength + 1);
+
+	for (GLint i = 0; i < count; i++) {
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(*_shaderNo, i, maxLength + 1, nullptr, &size, &type, &name[0]);
+
+		Common::String uniformName = &name[0];
+		if (!uniformName.hasSuffix("[0]")) {
+			addUniform(uniformName, glGetUniformLocation(*_shaderNo, uniformName.c_str()));
+			continue;
+		}
+
+		// Arrays are listed once, add each of their elements, and the array
+		// name for setting all the elements at once
+		Common::String arrayName = Common::String(uniformName.c_str(), uniformName.size() - 3);
+		for (GLint j = 0; j < size; j++) {
+			Common::String elementName = Common::String::format("%s[%d]", arrayName.c_str(), j);
+			GLint location = glGetUniformLocation(*_shaderNo, elementName.c_str());
+			addUniform(elementName, location);
+
+			if (j == 0) {
+				addUniform(arrayName, location);
+			}
+		}
+	}
+}
+
+int32 Shader::addUniform(const Common::String &name, GLint location) const {
+	UniformsMap::iterator it = _uniforms->_indices.find(name);
+	if (it != _uniforms->_indices.end()) {
+		return it->_value;
+	}
+
+	Uniform uniform;
+	uniform._location = location;
+	uniform._valueSize = 0;
+
+	int32 index = _uniforms->_uniforms.size();
+	_uniforms->_uniforms.push_back(uniform);
+	_uniforms->_indices.setVal(name, index);
+	return index;
+}
+
+UniformHandle Shader::getUniform(const char *uniform) const {
+	UniformsMap::iterator it = _uniforms->_indices.find(uniform);
+	if (it != _uniforms->_indices.end()) {
+		return UniformHandle(it->_value);
+	}
+
+	// The uniform is not used by the program, or is a member of a structure array
+	return UniformHandle(addUniform(uniform, glGetUniformLocation(*_shaderNo, uniform)));
 }
 
 Shader *Shader::fromStrings(const Common::String &name, const char *vertex, const char *fragment, const char **attributes) {
@@ -151,9 +215,9 @@ Shader *Shader::fromStrings(const Common::String &name, const char *vertex, cons
 }
 
 
-Shader *Shader::fromFiles(const char *vertex, const char *fragment, const char **attributes) {
-	GLuint vertexShader = loadShaderFromFile(vertex, "vertex", GL_VERTEX_SHADER);
-	GLuint fragmentShader = loadShaderFromFile(fragment, "fragment", GL_FRAGMENT_SHADER);
+Shader *Shader::fromFiles(const char *vertex, const char *fragment, const char **attributes, const char *defines) {
+	GLuint vertexShader = loadShaderFromFile(vertex, "vertex", GL_VERTEX_SHADER, defines);
+	GLuint fragmentShader = loadShaderFromFile(fragment, "fragment", GL_FRAGMENT_SHADER, defines);
 
 	Common::String name = Common::String::format("%s/%s", vertex, fragment);
 	return new Shader(name, vertexShader, fragmentShader, attributes);
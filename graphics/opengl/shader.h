@@ -59,8 +59,45 @@ struct VertexAttrib {
 	float _const[4];
 };
 
+/**
+ * A uniform variable of a shader program, resolved once
+ *
+ * Setting a uniform through its handle avoids looking its name up.
+ * A handle can be used with the shader it was obtained from, and its clones.
+ */
+class UniformHandle {
+public:
+	UniformHandle() : _index(-1) {}
+
+	bool isValid() const { return _index >= 0; }
+
+private:
+	friend class Shader;
+	explicit UniformHandle(int32 index) : _index(index) {}
+
+	int32 _index;
+};
+
 class Shader {
-	typedef Common::HashMap<Common::String, GLint> UniformsMap;
+	/**
+	 * The state of a uniform variable
+	 *
+	 * The last value set is remembered to skip the GL calls setting the same
+	 * value again. The values set by the callers directly using the location
+	 * are not tracked.
+	 */
+	struct Uniform {
+		GLint _location;
+		uint32 _valueSize; ///< In 32-bit words, 0 until a value is set
+		uint32 _value[16];
+	};
+
+	typedef Common::HashMap<Common::String, int32> UniformsMap;
+
+	struct UniformTable {
+		UniformsMap _indices;
+		Common::Array<Uniform> _uniforms;
+	};
 
 public:
 	~Shader();
@@ -70,59 +107,87 @@ public:
 
 	void use(bool forceReload = false);
 
-	void setUniform(const char *uniform, const Math::Matrix4 &m) {
-		GLint pos = getUniformLocation(uniform);
+	/** Resolve a uniform by name, the handle is valid even when the uniform is not used by the program */
+	UniformHandle getUniform(const char *uniform) const;
+
+	void setUniform(UniformHandle uniform, const Math::Matrix4 &m) {
+		GLint pos = updateUniformValue(uniform, m.getData(), 16);
 		if (pos != -1)
 			glUniformMatrix4fv(pos, 1, GL_FALSE, m.getData());
 	}
 
-	void setUniform(const char* uniform, const Math::Matrix3 &m) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform(UniformHandle uniform, const Math::Matrix3 &m) {
+		GLint pos = updateUniformValue(uniform, m.getData(), 9);
 		if (pos != -1)
 			glUniformMatrix3fv(pos, 1, GL_FALSE, m.getData());
 	}
 
-	void setUniform(const char *uniform, const Math::Vector4d &v) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform(UniformHandle uniform, const Math::Vector4d &v) {
+		GLint pos = updateUniformValue(uniform, v.getData(), 4);
 		if (pos != -1)
 			glUniform4fv(pos, 1, v.getData());
 	}
 
-	void setUniform(const char *uniform, const Math::Vector3d &v) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform(UniformHandle uniform, const Math::Vector3d &v) {
+		GLint pos = updateUniformValue(uniform, v.getData(), 3);
 		if (pos != -1)
 			glUniform3fv(pos, 1, v.getData());
 	}
 
-	void setUniform(const char *uniform, const Math::Vector2d &v) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform(UniformHandle uniform, const Math::Vector2d &v) {
+		GLint pos = updateUniformValue(uniform, v.getData(), 2);
 		if (pos != -1)
 			glUniform2fv(pos, 1, v.getData());
 	}
 
-	void setUniform(const char *uniform, unsigned int x) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform(UniformHandle uniform, unsigned int x) {
+		GLint value = x;
+		GLint pos = updateUniformValue(uniform, &value, 1);
 		if (pos != -1)
-			glUniform1i(pos, x);
+			glUniform1i(pos, value);
 	}
 
 	// Different name to avoid overload ambiguity
-	void setUniform1f(const char *uniform, float f) {
-		GLint pos = getUniformLocation(uniform);
+	void setUniform1f(UniformHandle uniform, float f) {
+		GLint pos = updateUniformValue(uniform, &f, 1);
 		if (pos != -1)
 			glUniform1f(pos, f);
 	}
 
+	void setUniform(const char *uniform, const Math::Matrix4 &m) {
+		setUniform(getUniform(uniform), m);
+	}
+
+	void setUniform(const char* uniform, const Math::Matrix3 &m) {
+		setUniform(getUniform(uniform), m);
+	}
+
+	void setUniform(const char *uniform, const Math::Vector4d &v) {
+		setUniform(getUniform(uniform), v);
+	}
+
+	void setUniform(const char *uniform, const Math::Vector3d &v) {
+		setUniform(getUniform(uniform), v);
+	}
+
+	void setUniform(const char *uniform, const Math::Vector2d &v) {
+		setUniform(getUniform(uniform), v);
+	}
+
+	void setUniform(const char *uniform, unsigned int x) {
+		setUniform(getUniform(uniform), x);
+	}
+
+	void setUniform1f(const char *uniform, float f) {
+		setUniform1f(getUniform(uniform), f);
+	}
 
 	GLint getUniformLocation(const char *uniform) const {
-		UniformsMap::iterator kv = _uniforms->find(uniform);
-		if (kv == _uniforms->end()) {
-			GLint ret = glGetUniformLocation(*_shaderNo, uniform);
-			_uniforms->setVal(uniform, ret);
-			return ret;
-		} else {
-			return kv->_value;
-		}
+		return getUniformLocation(getUniform(uniform));
+	}
+
+	GLint getUniformLocation(UniformHandle uniform) const {
+		return uniform.isValid() ? _uniforms->_uniforms[uniform._index]._location : -1;
 	}
 
 	void enableVertexAttribute(const char *attrib, GLuint vbo, GLint size, GLenum type, GLboolean normalized, GLsizei stride, uint32 offset);
@@ -137,9 +202,14 @@ public:
 	static GLuint createBuffer(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage = GL_STATIC_DRAW);
 	static void freeBuffer(GLuint vbo);
 
-	static Shader* fromFiles(const char *vertex, const char *fragment, const char **attributes);
-	static Shader* fromFiles(const char *shared, const char **attributes) {
-		return fromFiles(shared, shared, attributes);
+	/**
+	 * Load a shader program from the shader files
+	 *
+	 * @param defines	preprocessor lines added before the sources of both shaders, e.g. "#define NAME 1\n"
+	 */
+	static Shader* fromFiles(const char *vertex, const char *fragment, const char **attributes, const char *defines = nullptr);
+	static Shader* fromFiles(const char *shared, const char **attributes, const char *defines = nullptr) {
+		return fromFiles(shared, shared, attributes, defines);
 	}
 
 	static Shader* fromStrings(const Common::String &name, const char *vertex, const char *fragment, const char **attributes);
@@ -149,6 +219,31 @@ public:
 private:
 	Shader(const Common::String &name, GLuint vertexShader, GLuint fragmentShader, const char **attributes);
 
+	void resolveActiveUniforms();
+	int32 addUniform(const Common::String &name, GLint location) const;
+
+	/**
+	 * Remember the new value of a uniform
+	 *
+	 * @return the location of the uniform to set, or -1 when it does not
+	 *         need to be set because it is not used or already has the value
+	 */
+	GLint updateUniformValue(UniformHandle uniform, const void *value, uint32 size) {
+		assert(uniform._index >= 0 && (uint32)uniform._index < _uniforms->_uniforms.size());
+		assert(size <= 16);
+
+		Uniform &u = _uniforms->_uniforms[uniform._index];
+		if (u._location == -1)
+			return -1;
+
+		if (u._valueSize == size && memcmp(u._value, value, size * sizeof(uint32)) == 0)
+			return -1;
+
+		memcpy(u._value, value, size * sizeof(uint32));
+		u._valueSize = size;
+		return u._location;
+	}
+
 	// Since this class is cloned using the implicit copy constructor,
 	// a reference counting pointer is used to ensure deletion of the OpenGL
 	// program upon destruction of the last clone.
@@ -157,7 +252,7 @@ private:
 	Common::String _name;
 
 	Common::Array<VertexAttrib> _attributes;
-	Common::SharedPtr<UniformsMap> _uniforms;
+	Common::SharedPtr<UniformTable> _uniforms;
 
 	static Shader *_previousShader;
 };
@@ -60,3 +60,13 @@
 // The Android SDK and SDL1 don't declare GL_MAX_SAMPLES
 #define GL_MAX_SAMPLES 0x8D57
 #endif
+
+#if !defined(GL_MAX_VERTEX_UNIFORM_COMPONENTS)
+// The GLES2 headers and old GL headers don't declare GL_MAX_VERTEX_UNIFORM_COMPONENTS
+#define GL_MAX_VERTEX_UNIFORM_COMPONENTS 0x8B4A
+#endif
+
+#if !defined(GL_MAX_VERTEX_UNIFORM_VECTORS)
+// The desktop GL headers before OpenGL 4.1 don't declare GL_MAX_VERTEX_UNIFORM_VECTORS
+#define GL_MAX_VERTEX_UNIFORM_VECTORS 0x8DFB
+#endif
@@ -695,3 +695,13 @@ void tglEnableDirtyRects(bool enable) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_enableDirtyRectangles = enable;
 }
+
+void tglEnableTiledRendering(bool enable) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	c->_enableTiledRendering = enable;
+}
+
+void tglSetWorkerPool(Common::WorkerPool *pool) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	c->_tileRenderer.setWorkerPool(pool);
+}
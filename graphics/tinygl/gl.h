@@ -33,6 +33,10 @@
 
 #define TGL_VERSION_1_1 1
 
+namespace Common {
+class WorkerPool;
+}
+
 enum {
 	// Boolean values
 	TGL_FALSE                       = 0,
@@ -846,6 +850,12 @@ void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 
 void tglEnableDirtyRects(bool enable);
 
+// Replays the draw calls once per screen tile when dirty rectangles are disabled
+void tglEnableTiledRendering(bool enable);
+
+// Worker threads replaying the screen tiles or the dirty rectangles, nullptr for none
+void tglSetWorkerPool(Common::WorkerPool *pool);
+
 void tglDebug(int mode);
 
 namespace TinyGL {
@@ -237,6 +237,10 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[0].initialize(kDrawCallMemory);
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = false;
+	c->_enableTiledRendering = false;
+	c->_dirtyRegion.resize(c->fb->xsize, c->fb->ysize);
+	c->_dirtyRectStats.reset();
+	c->_frameAllocationStats.reset();
 
 	Graphics::Internal::tglBlitSetScissorRect(0, 0, c->fb->xsize, c->fb->ysize);
 }
@@ -54,6 +54,9 @@ static int op_table_size[] = {
 };
 
 GLContext *gl_get_context() {
+	// While the rectangles are replayed in parallel, every worker thread has its own context.
+	if (gl_ctx && gl_ctx->_tileRenderer.isRenderingInParallel())
+		return gl_ctx->_tileRenderer.getWorkerContext();
 	return gl_ctx;
 }
 
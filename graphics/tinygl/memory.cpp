@@ -34,16 +34,27 @@ namespace TinyGL {
 
 // modify these functions so that they suit your needs
 
+static int heapAllocations = 0;
+static int heapFrees = 0;
+
 void gl_free(void *p) {
+	heapFrees++;
 	free(p);
 }
 
 void *gl_malloc(int size) {
+	heapAllocations++;
 	return malloc(size);
 }
 
 void *gl_zalloc(int size) {
+	heapAllocations++;
 	return calloc(1, size);
 }
 
+void gl_get_heap_call_counts(int &allocations, int &frees) {
+	allocations = heapAllocations;
+	frees = heapFrees;
+}
+
 } // end of namespace TinyGL
@@ -33,6 +33,7 @@
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -96,6 +97,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	this->_zbufferAllocated = true;
 
 	if (!frame_buffer) {
 		byte *pixelBuffer = (byte *)gl_malloc(this->ysize * this->linesize);
@@ -115,12 +117,35 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+
+	enableSpanKernels(true);
+}
+
+void FrameBuffer::enableSpanKernels(bool enable) {
+	// The vectorized span kernels only handle 32 bits pixels with 8 bits color components.
+	_spanKernels = enable && spanKernelsAvailable() && cmode.bytesPerPixel == 4 &&
+	               cmode.rLoss == 0 && cmode.gLoss == 0 && cmode.bLoss == 0;
 }
 
 FrameBuffer::~FrameBuffer() {
 	if (frame_buffer_allocated)
 		pbuf.free();
-	gl_free(_zbuf);
+	if (_zbufferAllocated)
+		gl_free(_zbuf);
+}
+
+FrameBuffer *FrameBuffer::createView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->frame_buffer_allocated = 0;
+	view->_zbufferAllocated = false;
+	return view;
+}
+
+void FrameBuffer::updateView(const FrameBuffer &other) {
+	assert(!frame_buffer_allocated && !_zbufferAllocated);
+	*this = other;
+	frame_buffer_allocated = 0;
+	_zbufferAllocated = false;
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
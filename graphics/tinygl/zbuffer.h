@@ -57,6 +57,9 @@ namespace TinyGL {
 
 #define RGB_TO_PIXEL(r, g, b) cmode.ARGBToColor(255, r >> 8, g >> 8, b >> 8) // Default to 255 alpha aka solid colour.
 
+// Texture coordinates are perspective corrected every NB_INTERP pixels
+static const int NB_INTERP = 8;
+
 static const int DRAW_DEPTH_ONLY = 0;
 static const int DRAW_FLAT = 1;
 static const int DRAW_SMOOTH = 2;
@@ -93,6 +96,19 @@ struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelBuffer &frame_buffer);
 	~FrameBuffer();
 
+	/**
+	 * Creates a view of this frame buffer: the view draws into the same pixel
+	 * and depth buffers, but has its own copy of the rendering state and never
+	 * frees the buffers. Views are used to rasterize different parts of the
+	 * frame buffer from several threads.
+	 */
+	FrameBuffer *createView() const;
+
+	/**
+	 * Copies the buffers and the rendering state of a frame buffer into a view of it.
+	 */
+	void updateView(const FrameBuffer &other);
+
 	Buffer *genOffscreenBuffer();
 	void delOffscreenBuffer(Buffer *buffer);
 	void clear(int clear_z, int z, int clear_color, int r, int g, int b);
@@ -401,6 +417,13 @@ struct FrameBuffer {
 		this->_depthWrite = enable;
 	}
 
+	/**
+	 * Enable or disable the vectorized span kernels, they are only used when
+	 * they were compiled in and the pixel format allows it. They are enabled
+	 * by default, disabling them makes every span go through the scalar loops.
+	 */
+	void enableSpanKernels(bool enable);
+
 	bool isAlphaBlendingEnabled() const {
 		return _sourceBlendingFactor == TGL_SRC_ALPHA && _destinationBlendingFactor == TGL_ONE_MINUS_SRC_ALPHA;
 	}
@@ -456,6 +479,7 @@ struct FrameBuffer {
 
 	Common::Rect _clipRectangle;
 	bool _enableScissor;
+	bool _spanKernels;
 	int xsize, ysize;
 	int linesize; // line size, in bytes
 	Graphics::PixelFormat cmode;
@@ -504,6 +528,7 @@ private:
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
 	unsigned int *_zbuf;
+	bool _zbufferAllocated;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
@@ -29,11 +29,94 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/profiler.h"
+#include "common/workerpool.h"
 
 namespace TinyGL {
 
+namespace {
+
+// 64 bits FNV-1a over 32 bits words, used to fingerprint draw calls.
+class DrawCallHasher {
+public:
+	DrawCallHasher() : _hash(((uint64)0xcbf29ce4 << 32) | 0x84222325) { }
+
+	void add(uint32 value) {
+		_hash = (_hash ^ value) * (((uint64)1 << 40) | 0x1b3);
+	}
+
+	void add(int value) {
+		add((uint32)value);
+	}
+
+	void add(bool value) {
+		add((uint32)value);
+	}
+
+	void add(float value) {
+		// Make 0.0 and -0.0 hash the same since they compare equal
+		if (value == 0.0f) {
+			value = 0.0f;
+		}
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		add(bits);
+	}
+
+	void add(const float *values, int count) {
+		for (int i = 0; i < count; i++) {
+			add(values[i]);
+		}
+	}
+
+	void add(const void *pointer) {
+		uint64 value = (uint64)(size_t)pointer;
+		add((uint32)value);
+		add((uint32)(value >> 32));
+	}
+
+	void add(const Common::Rect &rect) {
+		add((int)rect.left);
+		add((int)rect.top);
+		add((int)rect.right);
+		add((int)rect.bottom);
+	}
+
+	uint64 getHash() const { return _hash; }
+private:
+	uint64 _hash;
+};
+
+struct DrawCallHashEntryLess {
+	bool operator()(const DrawCallHashEntry &a, const DrawCallHashEntry &b) const {
+		return a.hash < b.hash || (a.hash == b.hash && a.position < b.position);
+	}
+};
+
+// Finds the first previous frame draw call with the given hash which is
+// not before the given position.
+const DrawCallHashEntry *findDrawCall(const Common::Array<DrawCallHashEntry> &index, uint64 hash, uint position) {
+	uint first = 0, last = index.size();
+	while (first < last) {
+		uint middle = first + (last - first) / 2;
+		const DrawCallHashEntry &entry = index[middle];
+		if (entry.hash < hash || (entry.hash == hash && entry.position < position)) {
+			first = middle + 1;
+		} else {
+			last = middle;
+		}
+	}
+	if (first < index.size() && index[first].hash == hash) {
+		return &index[first];
+	}
+	return nullptr;
+}
+
+} // end of anonymous namespace
+
 void tglIssueDrawCall(Graphics::DrawCall *drawCall) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_drawCallsQueue.push_back(drawCall);
@@ -61,19 +144,278 @@ void tglDrawRectangle(Common::Rect rect, int r, int g, int b) {
 	}
 }
 
-struct DirtyRectangle {
-	Common::Rect rectangle;
-	int r, g, b;
+DirtyRegionGrid::DirtyRegionGrid() : _width(0), _height(0), _tilesX(0), _tilesY(0), _dirtyTileCount(0) {
+}
+
+void DirtyRegionGrid::resize(int width, int height) {
+	_width = width;
+	_height = height;
+	_tilesX = (width + kTileSize - 1) / kTileSize;
+	_tilesY = (height + kTileSize - 1) / kTileSize;
+	_tiles.resize(_tilesX * _tilesY);
+	_tileSums.resize((_tilesX + 1) * (_tilesY + 1));
+	_previousSpans.reserve(_tilesX);
+	_currentSpans.reserve(_tilesX);
+	clear();
+}
 
-	DirtyRectangle() { }
-	DirtyRectangle(Common::Rect rect, int red, int green, int blue) {
-		this->rectangle = rect;
-		this->r = red;
-		this->g = green;
-		this->b = blue;
+void DirtyRegionGrid::clear() {
+	if (!_tiles.empty()) {
+		memset(&_tiles[0], 0, _tiles.size());
 	}
-};
+	if (!_tileSums.empty()) {
+		memset(&_tileSums[0], 0, _tileSums.size() * sizeof(int));
+	}
+	_dirtyTileCount = 0;
+	_regions.clear();
+}
+
+bool DirtyRegionGrid::getTileRange(const Common::Rect &rect, int &x0, int &y0, int &x1, int &y1) const {
+	int left = MAX<int>(rect.left, 0);
+	int top = MAX<int>(rect.top, 0);
+	int right = MIN<int>(rect.right, _width);
+	int bottom = MIN<int>(rect.bottom, _height);
+	if (left >= right || top >= bottom)
+		return false;
 
+	// Tile ranges are half open: [x0, x1) and [y0, y1)
+	x0 = left / kTileSize;
+	y0 = top / kTileSize;
+	x1 = (right + kTileSize - 1) / kTileSize;
+	y1 = (bottom + kTileSize - 1) / kTileSize;
+	return true;
+}
+
+void DirtyRegionGrid::markDirty(const Common::Rect &rect) {
+	int x0, y0, x1, y1;
+	if (!getTileRange(rect, x0, y0, x1, y1))
+		return;
+
+	for (int y = y0; y < y1; y++) {
+		memset(&_tiles[y * _tilesX + x0], 1, x1 - x0);
+	}
+}
+
+void DirtyRegionGrid::coalesce() {
+	_regions.clear();
+	_previousSpans.clear();
+	_dirtyTileCount = 0;
+
+	for (int y = 0; y < _tilesY; y++) {
+		const byte *row = &_tiles[y * _tilesX];
+		const int *sumsAbove = &_tileSums[y * (_tilesX + 1)];
+		int *sums = &_tileSums[(y + 1) * (_tilesX + 1)];
+		int rowSum = 0;
+		uint previous = 0;
+
+		_currentSpans.clear();
+		for (int x = 0; x < _tilesX;) {
+			if (!row[x]) {
+				sums[x + 1] = sumsAbove[x + 1] + rowSum;
+				x++;
+				continue;
+			}
+
+			int start = x;
+			while (x < _tilesX && row[x]) {
+				rowSum++;
+				sums[x + 1] = sumsAbove[x + 1] + rowSum;
+				x++;
+			}
+
+			// Spans of the previous row are sorted, so they can be walked along with this row.
+			while (previous < _previousSpans.size() && _regions[_previousSpans[previous]].left < start) {
+				previous++;
+			}
+
+			if (previous < _previousSpans.size() &&
+					_regions[_previousSpans[previous]].left == start &&
+					_regions[_previousSpans[previous]].right == x) {
+				_regions[_previousSpans[previous]].bottom = y + 1;
+				_currentSpans.push_back(_previousSpans[previous]);
+			} else {
+				_currentSpans.push_back(_regions.size());
+				_regions.push_back(Common::Rect(start, y, x, y + 1));
+			}
+		}
+		_dirtyTileCount += rowSum;
+		SWAP(_previousSpans, _currentSpans);
+	}
+
+	// Convert from tile to pixel coordinates.
+	for (uint i = 0; i < _regions.size(); i++) {
+		Common::Rect &region = _regions[i];
+		region.left *= kTileSize;
+		region.top *= kTileSize;
+		region.right = MIN<int>(region.right * kTileSize, _width);
+		region.bottom = MIN<int>(region.bottom * kTileSize, _height);
+	}
+}
+
+bool DirtyRegionGrid::isDirty(const Common::Rect &rect) const {
+	int x0, y0, x1, y1;
+	if (!getTileRange(rect, x0, y0, x1, y1))
+		return false;
+
+	int stride = _tilesX + 1;
+	int sum = _tileSums[y1 * stride + x1] - _tileSums[y0 * stride + x1] - _tileSums[y1 * stride + x0] + _tileSums[y0 * stride + x0];
+	return sum > 0;
+}
+
+TileRenderer::TileRenderer() : _workerPool(nullptr), _renderingInParallel(false), _screenTilesWidth(0), _screenTilesHeight(0),
+		_rectangles(nullptr), _executedDrawCalls(0), _rasterizedPixels(0) {
+}
+
+TileRenderer::~TileRenderer() {
+	// The first worker uses the main context.
+	for (uint i = 1; i < _workerContexts.size(); i++) {
+		GLContext *worker = _workerContexts[i];
+		if (worker) {
+			gl_free(worker->vertex);
+			delete worker->fb;
+			delete worker;
+		}
+	}
+}
+
+const Common::Array<Common::Rect> &TileRenderer::getScreenTiles(int width, int height) {
+	if (width != _screenTilesWidth || height != _screenTilesHeight) {
+		_screenTiles.clear();
+		for (int y = 0; y < height; y += kTileSize) {
+			for (int x = 0; x < width; x += kTileSize) {
+				_screenTiles.push_back(Common::Rect(x, y, MIN<int>(x + kTileSize, width), MIN<int>(y + kTileSize, height)));
+			}
+		}
+		_screenTilesWidth = width;
+		_screenTilesHeight = height;
+	}
+	return _screenTiles;
+}
+
+void TileRenderer::bin(const Graphics::DrawCallQueue &queue, const Common::Array<Common::Rect> &rectangles, const DirtyRegionGrid *dirtyRegion) {
+	_binEntries.resize(0);
+	_binOffsets.resize(rectangles.size() + 1);
+	memset(&_binOffsets[0], 0, _binOffsets.size() * sizeof(uint));
+	_rasterizedPixels = 0;
+
+	for (Graphics::DrawCall *it = queue.front(); it; it = it->getNext()) {
+		Common::Rect drawCallRegion = it->getDirtyRegion();
+		if (dirtyRegion && !dirtyRegion->isDirty(drawCallRegion)) {
+			continue;
+		}
+		for (uint i = 0; i < rectangles.size(); i++) {
+			const Common::Rect &rectangle = rectangles[i];
+			if (rectangle.intersects(drawCallRegion) || drawCallRegion.contains(rectangle)) {
+				BinEntry entry;
+				entry.rectangle = i;
+				entry.drawCall = it;
+				_binEntries.push_back(entry);
+				_binOffsets[i + 1]++;
+
+				Common::Rect rasterized = rectangle.findIntersectingRect(drawCallRegion);
+				_rasterizedPixels += rasterized.width() * rasterized.height();
+			}
+		}
+	}
+
+	// Counting sort of the entries by rectangle, which keeps the draw calls
+	// of every rectangle in the queue order.
+	for (uint i = 0; i < rectangles.size(); i++) {
+		_binOffsets[i + 1] += _binOffsets[i];
+	}
+	_binDrawCalls.resize(_binEntries.size());
+	for (uint i = 0; i < _binEntries.size(); i++) {
+		const BinEntry &entry = _binEntries[i];
+		_binDrawCalls[_binOffsets[entry.rectangle]++] = entry.drawCall;
+	}
+	// Every offset got moved to the end of its rectangle, which is the start of the next one.
+	for (uint i = rectangles.size(); i > 0; i--) {
+		_binOffsets[i] = _binOffsets[i - 1];
+	}
+	_binOffsets[0] = 0;
+
+	_rectangles = &rectangles;
+	_executedDrawCalls = _binEntries.size();
+}
+
+void TileRenderer::renderRectangle(uint index) const {
+	const Common::Rect &rectangle = (*_rectangles)[index];
+	for (uint i = _binOffsets[index]; i < _binOffsets[index + 1]; i++) {
+		_binDrawCalls[i]->execute(rectangle, true);
+	}
+}
+
+void TileRenderer::renderRectangleJob(void *renderer, uint index) {
+	((const TileRenderer *)renderer)->renderRectangle(index);
+}
+
+GLContext *TileRenderer::getWorkerContext() const {
+	return _workerContexts[_workerPool->getCurrentWorker()];
+}
+
+void TileRenderer::updateWorkerContexts(GLContext *c) {
+	uint workerCount = _workerPool->getWorkerCount();
+	if (_workerContexts.size() < workerCount) {
+		_workerContexts.resize(workerCount);
+	}
+
+	// The thread calling run() renders with the main context.
+	_workerContexts[0] = c;
+	for (uint i = 1; i < workerCount; i++) {
+		GLContext *worker = _workerContexts[i];
+		if (!worker) {
+			worker = new GLContext();
+			worker->fb = c->fb->createView();
+			_workerContexts[i] = worker;
+		} else {
+			worker->fb->updateView(*c->fb);
+		}
+
+		// Every worker modifies its own copy of the vertices while replaying.
+		if (worker->vertex_max < c->vertex_max) {
+			gl_free(worker->vertex);
+			worker->vertex_max = c->vertex_max;
+			worker->vertex = (GLVertex *)gl_malloc(worker->vertex_max * sizeof(GLVertex));
+		}
+
+		// The state the draw calls don't restore themselves.
+		worker->_textureSize = c->_textureSize;
+		worker->render_mode = c->render_mode;
+		worker->viewport = c->viewport;
+		worker->vertex_n = c->vertex_n;
+		worker->current_cull_face = c->current_cull_face;
+		worker->_scissorRect = c->_scissorRect;
+	}
+}
+
+void TileRenderer::render(GLContext *c, const Graphics::DrawCallQueue &queue, const Common::Array<Common::Rect> &rectangles,
+                          const DirtyRegionGrid *dirtyRegion) {
+	bin(queue, rectangles, dirtyRegion);
+
+	// Selection adds hits from every rectangle to a single buffer, so it always stays serial.
+	if (_workerPool && _workerPool->getWorkerCount() > 1 && rectangles.size() > 1 && c->render_mode == TGL_RENDER) {
+		updateWorkerContexts(c);
+		_renderingInParallel = true;
+		_workerPool->run(renderRectangleJob, this, rectangles.size());
+		_renderingInParallel = false;
+	} else {
+		for (uint i = 0; i < rectangles.size(); i++) {
+			renderRectangle(i);
+		}
+	}
+
+	_rectangles = nullptr;
+}
+
+const DirtyRectStatistics &tglGetDirtyRectStatistics() {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	return c->_dirtyRectStats;
+}
+
+const FrameAllocationStatistics &tglGetFrameAllocationStatistics() {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	return c->_frameAllocationStats;
+}
 
 void tglDisposeResources(TinyGL::GLContext *c) {
 	// Dispose textures and resources.
@@ -97,125 +439,133 @@ void tglDisposeResources(TinyGL::GLContext *c) {
 	Graphics::Internal::tglCleanupImages();
 }
 
-void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
-		delete *it;
+static void tglDeleteDrawCalls(Graphics::DrawCallQueue &queue) {
+	Graphics::DrawCall *it = queue.front();
+	while (it) {
+		Graphics::DrawCall *next = it->getNext();
+		delete it;
+		it = next;
 	}
-	c->_previousFrameDrawCallsQueue.clear();
-	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		delete *it;
-	}
-	c->_drawCallsQueue.clear();
+	queue.clear();
 }
 
-void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
+void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
+	tglDeleteDrawCalls(c->_previousFrameDrawCallsQueue);
+	tglDeleteDrawCalls(c->_drawCallsQueue);
+}
 
-	Common::List<DirtyRectangle> rectangles;
+static void tglUpdateFrameAllocationStatistics(TinyGL::GLContext *c) {
+	static int lastHeapAllocations = 0, lastHeapFrees = 0;
 
-	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
-	DrawCallIterator endPrevFrame = c->_previousFrameDrawCallsQueue.end();
+	int heapAllocations, heapFrees;
+	TinyGL::gl_get_heap_call_counts(heapAllocations, heapFrees);
 
-	// Compare draw calls.
-	if (c->_drawCallsQueue.size() > 0) {
-		for (DrawCallIterator itPrevFrame = c->_previousFrameDrawCallsQueue.begin();
-			itPrevFrame != endPrevFrame;
-			++itPrevFrame, ++itFrame) {
-				const Graphics::DrawCall &currentCall = **itFrame;
-				const Graphics::DrawCall &previousCall = **itPrevFrame;
-
-				if (previousCall != currentCall) {
-					while (itPrevFrame != endPrevFrame) {
-						Graphics::DrawCall *dirtyDrawCall = *itPrevFrame;
-						rectangles.push_back(DirtyRectangle(dirtyDrawCall->getDirtyRegion(), 255, 255, 255));
-						++itPrevFrame;
-					}
-					break;
-				}
-		}
-	}
+	FrameAllocationStatistics &stats = c->_frameAllocationStats;
+	const LinearAllocator &allocator = c->_drawCallAllocator[c->_currentAllocatorIndex];
+	stats.heapAllocations = heapAllocations - lastHeapAllocations;
+	stats.heapFrees = heapFrees - lastHeapFrees;
+	stats.frameAllocations = allocator.getAllocationCount();
+	stats.frameBytes = allocator.getUsedSize();
+	lastHeapAllocations = heapAllocations;
+	lastHeapFrees = heapFrees;
 
-	for ( ; itFrame != c->_drawCallsQueue.end(); ++itFrame) {
-		const Graphics::DrawCall &currentCall = **itFrame;
-		rectangles.push_back(DirtyRectangle(currentCall.getDirtyRegion(), 255, 0, 0));
-	}
+	debug(6, "TinyGL frame memory: %d heap allocations, %d heap frees, %d frame allocations (%d bytes)",
+	      stats.heapAllocations, stats.heapFrees, stats.frameAllocations, stats.frameBytes);
+}
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
+void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
+	DirtyRegionGrid &dirtyRegion = c->_dirtyRegion;
+	DirtyRectStatistics &stats = c->_dirtyRectStats;
+
+	if (dirtyRegion.getWidth() != c->fb->xsize || dirtyRegion.getHeight() != c->fb->ysize) {
+		dirtyRegion.resize(c->fb->xsize, c->fb->ysize);
+	} else {
+		dirtyRegion.clear();
 	}
+	stats.reset();
+	stats.drawCalls = c->_drawCallsQueue.size();
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
+	// Compare draw calls.
+	// Every draw call of the current frame is matched by hash with the first
+	// identical draw call of the previous frame following the last match, so
+	// the matched draw calls keep their relative order. Everything left
+	// unmatched in either frame is dirty, which means that adding, removing
+	// or changing a draw call only dirties the regions it covers.
+	if (!c->_drawCallsQueue.empty()) {
+		Common::Array<DrawCallHashEntry> &index = c->_previousFrameDrawCallsIndex;
+		index.resize(c->_previousFrameDrawCallsQueue.size());
+		uint position = 0;
+		for (Graphics::DrawCall *it = c->_previousFrameDrawCallsQueue.front(); it; it = it->getNext(), position++) {
+			index[position].hash = it->getHash();
+			index[position].position = position;
+			index[position].drawCall = it;
+		}
+		Common::sort(index.begin(), index.end(), DrawCallHashEntryLess());
+
+		Graphics::DrawCall *itPrevFrame = c->_previousFrameDrawCallsQueue.front();
+		uint prevFramePosition = 0;
+		for (Graphics::DrawCall *itFrame = c->_drawCallsQueue.front(); itFrame; itFrame = itFrame->getNext()) {
+			const DrawCallHashEntry *match = findDrawCall(index, itFrame->getHash(), prevFramePosition);
+			if (match && *match->drawCall == *itFrame) {
+				// The draw calls skipped in the previous frame are gone.
+				while (prevFramePosition < match->position) {
+					dirtyRegion.markDirty(itPrevFrame->getDirtyRegion());
+					stats.dirtyRectangles++;
+					itPrevFrame = itPrevFrame->getNext();
+					prevFramePosition++;
 				}
+				itPrevFrame = itPrevFrame->getNext();
+				prevFramePosition++;
+				stats.matchedDrawCalls++;
+			} else {
+				dirtyRegion.markDirty(itFrame->getDirtyRegion());
+				stats.dirtyRectangles++;
 			}
 		}
-	} while(restartMerge);
-
-	Common::Rect renderRect(0, 0, c->fb->xsize - 1, c->fb->ysize - 1);
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
+		for ( ; itPrevFrame; itPrevFrame = itPrevFrame->getNext()) {
+			dirtyRegion.markDirty(itPrevFrame->getDirtyRegion());
+			stats.dirtyRectangles++;
 		}
-		(*it1).rectangle.clip(renderRect);
 	}
 
-	// Execute draw calls.
-	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-			Common::Rect dirtyRegion = (*itRect).rectangle;
-			if (dirtyRegion.intersects(drawCallRegion) || drawCallRegion.contains(dirtyRegion)) {
-				(*it)->execute(dirtyRegion, true);
-			}
-		}
+	// Merge the dirty tiles into non overlapping rectangles.
+	dirtyRegion.coalesce();
+
+	const Common::Array<Common::Rect> &rectangles = dirtyRegion.getRegions();
+	stats.mergedRectangles = rectangles.size();
+	stats.dirtyTiles = dirtyRegion.getDirtyTileCount();
+	for (uint i = 0; i < rectangles.size(); i++) {
+		stats.dirtyPixels += rectangles[i].width() * rectangles[i].height();
 	}
 
+	// Execute draw calls.
+	TileRenderer &renderer = c->_tileRenderer;
+	renderer.render(c, c->_drawCallsQueue, rectangles, &dirtyRegion);
+	stats.executedDrawCalls = renderer.getExecutedDrawCalls();
+	stats.rasterizedPixels = renderer.getRasterizedPixels();
+
+	debug(6, "TinyGL dirty rects: %d draw calls (%d unchanged), %d rects merged into %d (%d tiles), %d executions, %d/%d pixels rasterized",
+	      stats.drawCalls, stats.matchedDrawCalls, stats.dirtyRectangles, stats.mergedRectangles, stats.dirtyTiles,
+	      stats.executedDrawCalls, stats.rasterizedPixels, stats.dirtyPixels);
+
 	// Dispose not necessary draw calls.
-	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
-		delete *it;
-	}
+	tglDeleteDrawCalls(c->_previousFrameDrawCallsQueue);
 
 	c->_previousFrameDrawCallsQueue = c->_drawCallsQueue;
 	c->_drawCallsQueue.clear();
 
 #if TGL_DIRTY_RECT_SHOW
 	// Draw debug rectangles.
-	// Note: white rectangles are rectangle that contained other rectangles
-	// blue rectangles are rectangle merged from other rectangles
-	// red rectangles are original dirty rects
+	// Note: every rectangle is a merged span of dirty tiles
 
 	bool blendingEnabled = c->fb->isBlendingEnabled();
 	bool alphaTestEnabled = c->fb->isAlphaTestEnabled();
 	c->fb->enableBlending(false);
 	c->fb->enableAlphaTest(false);
 
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
+	for (uint i = 0; i < rectangles.size(); i++) {
+		tglDrawRectangle(rectangles[i], 0, 0, 255);
 	}
 
 	c->fb->enableBlending(blendingEnabled);
@@ -223,34 +573,48 @@ void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 #endif
 
 	tglDisposeResources(c);
+	tglUpdateFrameAllocationStatistics(c);
 
-	c->_currentAllocatorIndex++;
-	if (c->_currentAllocatorIndex == 2) {
-		c->_currentAllocatorIndex = 0;
-		c->_drawCallAllocator[0].reset();
-		c->_drawCallAllocator[1].reset();
-	}
+	// The draw calls of this frame are kept alive for the comparison with the
+	// next one, so the next frame allocates from the other allocator. The
+	// draw calls that lived there were disposed above.
+	c->_currentAllocatorIndex ^= 1;
+	c->_drawCallAllocator[c->_currentAllocatorIndex].reset();
 }
 
 void tglPresentBufferSimple(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-
-	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
-		delete *it;
+	for (Graphics::DrawCall *it = c->_drawCallsQueue.front(); it; it = it->getNext()) {
+		it->execute(true);
 	}
 
-	c->_drawCallsQueue.clear();
+	tglDeleteDrawCalls(c->_drawCallsQueue);
 
 	tglDisposeResources(c);
+	tglUpdateFrameAllocationStatistics(c);
+
+	c->_drawCallAllocator[c->_currentAllocatorIndex].reset();
+}
+
+void tglPresentBufferTiled(TinyGL::GLContext *c) {
+	TileRenderer &renderer = c->_tileRenderer;
+	renderer.render(c, c->_drawCallsQueue, renderer.getScreenTiles(c->fb->xsize, c->fb->ysize));
+
+	tglDeleteDrawCalls(c->_drawCallsQueue);
+
+	tglDisposeResources(c);
+	tglUpdateFrameAllocationStatistics(c);
 
 	c->_drawCallAllocator[c->_currentAllocatorIndex].reset();
 }
 
 void tglPresentBuffer() {
+	PROFILE_ZONE("TinyGL present");
+
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	if (c->_enableDirtyRectangles) {
 		tglPresentBufferDirtyRects(c);
+	} else if (c->_enableTiledRendering) {
+		tglPresentBufferTiled(c);
 	} else {
 		tglPresentBufferSimple(c);
 	}
@@ -288,9 +652,71 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
 	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		computeDirtyRegion();
 	}
+	if (c->_enableDirtyRectangles) {
+		computeHash();
+	}
+}
+
+void RasterizationDrawCall::computeHash() {
+	TinyGL::DrawCallHasher hasher;
+	hasher.add(_vertexCount);
+	hasher.add((const void *)(size_t)_drawTriangleFront);
+	hasher.add((const void *)(size_t)_drawTriangleBack);
+
+	hasher.add(_state.beginType);
+	hasher.add(_state.currentFrontFace);
+	hasher.add(_state.cullFaceEnabled);
+	hasher.add(_state.colorMask);
+	hasher.add(_state.depthTest);
+	hasher.add(_state.depthFunction);
+	hasher.add(_state.depthWrite);
+	hasher.add(_state.shadowMode);
+	hasher.add(_state.texture2DEnabled);
+	hasher.add(_state.currentShadeModel);
+	hasher.add(_state.polygonModeBack);
+	hasher.add(_state.polygonModeFront);
+	hasher.add(_state.lightingEnabled);
+	hasher.add(_state.enableBlending);
+	hasher.add(_state.sfactor);
+	hasher.add(_state.dfactor);
+	hasher.add(_state.textureVersion);
+	hasher.add(_state.depthTestEnabled);
+	for (int i = 0; i < 4; i++) {
+		hasher.add(_state.currentColor[i]);
+	}
+	hasher.add(_state.viewportTranslation, 3);
+	hasher.add(_state.viewportScaling, 3);
+	hasher.add(_state.alphaTest);
+	hasher.add(_state.alphaFunc);
+	hasher.add(_state.alphaRefValue);
+	hasher.add((const void *)_state.texture);
+	hasher.add((const void *)_state.shadowMaskBuf);
+
+	// Only the vertex members compared by GLVertex::operator== are hashed.
+	for (int i = 0; i < _vertexCount; i++) {
+		const TinyGL::GLVertex &v = _vertex[i];
+		hasher.add(v.edge_flag);
+		hasher.add(v.normal._v, 3);
+		hasher.add(v.coord._v, 4);
+		hasher.add(v.tex_coord._v, 4);
+		hasher.add(v.color._v, 4);
+		hasher.add(v.ec._v, 4);
+		hasher.add(v.pc._v, 4);
+		hasher.add(v.clip_code);
+		hasher.add(v.zp.x);
+		hasher.add(v.zp.y);
+		hasher.add(v.zp.z);
+		hasher.add(v.zp.s);
+		hasher.add(v.zp.t);
+		hasher.add(v.zp.r);
+		hasher.add(v.zp.g);
+		hasher.add(v.zp.b);
+		hasher.add(v.zp.a);
+	}
+	_hash = hasher.getHash();
 }
 
 void RasterizationDrawCall::computeDirtyRegion() {
@@ -385,7 +811,10 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	// Some primitives modify the vertices while they are drawn, so they work
+	// on a copy: the draw call can then be replayed once per rectangle, and by
+	// several worker contexts at the same time.
+	memcpy(c->vertex, _vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
@@ -412,7 +841,8 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		gl_draw_line(c, &c->vertex[cnt - 1], &c->vertex[0]);
 		break;
 	case TGL_TRIANGLES:
-		for(int i = 0; i < cnt; i += 3) {
+		// Incomplete primitives are skipped, they would read past the vertices.
+		for(int i = 0; i + 2 < cnt; i += 3) {
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
 		}
 		break;
@@ -432,12 +862,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		}
 		break;
 	case TGL_TRIANGLE_FAN:
-		for(int i = 1; i < cnt; i += 2) {
+		for(int i = 1; i + 1 < cnt; i += 2) {
 			gl_draw_triangle(c, &c->vertex[0], &c->vertex[i], &c->vertex[i + 1]);
 		}
 		break;
 	case TGL_QUADS:
-		for(int i = 0; i < cnt; i += 4) {
+		for(int i = 0; i + 3 < cnt; i += 4) {
 			c->vertex[i + 2].edge_flag = 0;
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
 			c->vertex[i + 2].edge_flag = 1;
@@ -538,7 +968,8 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 
 void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	c->fb->setScissorRectangle(clippingRectangle.left, clippingRectangle.right, clippingRectangle.top, clippingRectangle.bottom);
+	// The frame buffer scissor rectangle is inclusive, unlike the clipping rectangle.
+	c->fb->setScissorRectangle(clippingRectangle.left, clippingRectangle.right - 1, clippingRectangle.top, clippingRectangle.bottom - 1);
 	execute(restoreState);
 	c->fb->setScissorRectangle(0, c->fb->xsize, 0, c->fb->ysize);
 }
@@ -566,6 +997,33 @@ BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransfo
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
+	computeHash();
+}
+
+void BlittingDrawCall::computeHash() {
+	TinyGL::DrawCallHasher hasher;
+	hasher.add((int)_mode);
+	hasher.add((const void *)_image);
+	hasher.add(_imageVersion);
+	hasher.add(_transform._sourceRectangle);
+	hasher.add(_transform._destinationRectangle);
+	hasher.add(_transform._rotation);
+	hasher.add(_transform._originX);
+	hasher.add(_transform._originY);
+	hasher.add(_transform._aTint);
+	hasher.add(_transform._rTint);
+	hasher.add(_transform._gTint);
+	hasher.add(_transform._bTint);
+	hasher.add(_transform._flipHorizontally);
+	hasher.add(_transform._flipVertically);
+	hasher.add(_blitState.enableBlending);
+	hasher.add(_blitState.sfactor);
+	hasher.add(_blitState.dfactor);
+	hasher.add(_blitState.alphaTest);
+	hasher.add(_blitState.alphaFunc);
+	hasher.add(_blitState.alphaRefValue);
+	hasher.add(_blitState.depthTestEnabled);
+	_hash = hasher.getHash();
 }
 
 BlittingDrawCall::~BlittingDrawCall() {
@@ -657,6 +1115,18 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
+	computeHash();
+}
+
+void ClearBufferDrawCall::computeHash() {
+	TinyGL::DrawCallHasher hasher;
+	hasher.add(_clearZBuffer);
+	hasher.add(_clearColorBuffer);
+	hasher.add(_rValue);
+	hasher.add(_gValue);
+	hasher.add(_bValue);
+	hasher.add(_zValue);
+	_hash = hasher.getHash();
 }
 
 void ClearBufferDrawCall::execute(bool restoreState) const {
@@ -33,10 +33,101 @@
 #include "graphics/tinygl/zblit.h"
 #include "common/array.h"
 
+namespace Common {
+	class WorkerPool;
+}
+
+namespace Graphics {
+	class DrawCall;
+	class DrawCallQueue;
+}
+
 namespace TinyGL {
 	struct GLContext;
 	struct GLVertex;
 	struct GLTexture;
+
+/**
+ * Tracks the dirty area of the frame buffer on a grid of fixed size tiles.
+ * Dirty rectangles only set per-tile dirty bits; coalesce() then turns every row
+ * of dirty tiles into spans and merges spans with the same extent on consecutive
+ * rows, so building the region is linear in the number of tiles touched.
+ * The resulting rectangles never overlap, which means that draw calls executed
+ * once per rectangle never touch a pixel twice.
+ */
+class DirtyRegionGrid {
+public:
+	enum {
+		kTileSize = 32
+	};
+
+	DirtyRegionGrid();
+
+	void resize(int width, int height);
+	void clear();
+	void markDirty(const Common::Rect &rect);
+	void coalesce();
+
+	/**
+	 * Checks if any tile covered by the rectangle is dirty.
+	 * Only valid after coalesce() has been called; this runs in constant time.
+	 */
+	bool isDirty(const Common::Rect &rect) const;
+
+	int getDirtyTileCount() const { return _dirtyTileCount; }
+	const Common::Array<Common::Rect> &getRegions() const { return _regions; }
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+private:
+	bool getTileRange(const Common::Rect &rect, int &x0, int &y0, int &x1, int &y1) const;
+
+	int _width, _height;
+	int _tilesX, _tilesY;
+	int _dirtyTileCount;
+	Common::Array<byte> _tiles;
+	Common::Array<int> _tileSums;
+	Common::Array<int> _previousSpans, _currentSpans;
+	Common::Array<Common::Rect> _regions;
+};
+
+struct DirtyRectStatistics {
+	int drawCalls;         // Draw calls in the current frame
+	int dirtyRectangles;   // Dirty rectangles reported by changed draw calls
+	int mergedRectangles;  // Non overlapping rectangles left after coalescing
+	int dirtyTiles;
+	int matchedDrawCalls;  // Draw calls found unchanged in the previous frame
+	int executedDrawCalls; // Draw call executions, one per touched rectangle
+	int dirtyPixels;
+	int rasterizedPixels;  // Compared to dirtyPixels this gives the overdraw
+
+	void reset() {
+		drawCalls = dirtyRectangles = mergedRectangles = dirtyTiles = 0;
+		matchedDrawCalls = executedDrawCalls = dirtyPixels = rasterizedPixels = 0;
+	}
+};
+
+/**
+ * Returns the statistics gathered during the last tglPresentBuffer() call
+ * with dirty rectangles enabled.
+ */
+const DirtyRectStatistics &tglGetDirtyRectStatistics();
+
+struct FrameAllocationStatistics {
+	int heapAllocations;  // gl_malloc and gl_zalloc calls during the frame
+	int heapFrees;        // gl_free calls during the frame
+	int frameAllocations; // Allocations served by the frame allocator
+	int frameBytes;
+
+	void reset() {
+		heapAllocations = heapFrees = frameAllocations = frameBytes = 0;
+	}
+};
+
+/**
+ * Returns the memory usage of the last frame passed to tglPresentBuffer().
+ */
+const FrameAllocationStatistics &tglGetFrameAllocationStatistics();
+
 }
 
 namespace Internal {
@@ -54,7 +145,7 @@ public:
 		DrawCall_Clear
 	};
 
-	DrawCall(DrawCallType type) : _type(type) { }
+	DrawCall(DrawCallType type) : _type(type), _next(nullptr), _hash(0) { }
 	virtual ~DrawCall() { }
 	bool operator==(const DrawCall &other) const;
 	bool operator!=(const DrawCall &other) const {
@@ -64,8 +155,52 @@ public:
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const = 0;
+	DrawCall *getNext() const { return _next; }
+
+	/**
+	 * Returns a fingerprint of the draw call content, computed when the draw
+	 * call is recorded. Draw calls comparing equal have the same hash.
+	 */
+	uint64 getHash() const { return _hash; }
+protected:
+	uint64 _hash;
 private:
+	friend class DrawCallQueue;
 	DrawCallType _type;
+	DrawCall *_next;
+};
+
+/**
+ * A queue of draw calls linked through the draw calls themselves.
+ * Since draw calls live in the frame allocator, queuing them doesn't need any
+ * memory from the heap and the queue never has to free anything.
+ */
+class DrawCallQueue {
+public:
+	DrawCallQueue() : _first(nullptr), _last(nullptr), _size(0) { }
+
+	void push_back(DrawCall *drawCall) {
+		drawCall->_next = nullptr;
+		if (_last) {
+			_last->_next = drawCall;
+		} else {
+			_first = drawCall;
+		}
+		_last = drawCall;
+		_size++;
+	}
+
+	void clear() {
+		_first = _last = nullptr;
+		_size = 0;
+	}
+
+	DrawCall *front() const { return _first; }
+	uint size() const { return _size; }
+	bool empty() const { return _size == 0; }
+private:
+	DrawCall *_first, *_last;
+	uint _size;
 };
 
 class ClearBufferDrawCall : public DrawCall {
@@ -83,6 +218,8 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	void computeHash();
+
 	bool _clearZBuffer, _clearColorBuffer;
 	int _rValue, _gValue, _bValue, _zValue;
 };
@@ -105,6 +242,7 @@ public:
 private:
 	typedef void (*gl_draw_triangle_func_ptr)(TinyGL::GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	void computeDirtyRegion();
+	void computeHash();
 	Common::Rect _dirtyRegion;
 	int _vertexCount;
 	TinyGL::GLVertex *_vertex;
@@ -170,6 +308,8 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	void computeHash();
+
 	BlitImage *_image;
 	BlitTransform _transform;
 	BlittingMode _mode;
@@ -201,4 +341,93 @@ private:
 
 } // end of namespace Graphics
 
+namespace TinyGL {
+
+/**
+ * A draw call of the previous frame, the entries are sorted by hash so that
+ * draw calls of the current frame can be matched against them.
+ */
+struct DrawCallHashEntry {
+	uint64 hash;
+	uint position; // Position of the draw call in its frame
+	Graphics::DrawCall *drawCall;
+};
+
+/**
+ * Replays the draw calls of a frame once per screen rectangle.
+ * The draw calls are first binned by rectangle, so every rectangle only goes
+ * through the draw calls touching it and its pixels stay in the cache while
+ * they are drawn. The rectangles must not overlap: they can then be replayed
+ * in any order, and in parallel when a worker pool is set. Each worker thread
+ * replays its rectangles with its own context and frame buffer view, which
+ * gl_get_context() returns while the rectangles are replayed.
+ */
+class TileRenderer {
+public:
+	enum {
+		kTileSize = 64
+	};
+
+	TileRenderer();
+	~TileRenderer();
+
+	void setWorkerPool(Common::WorkerPool *pool) { _workerPool = pool; }
+	Common::WorkerPool *getWorkerPool() const { return _workerPool; }
+
+	/**
+	 * Returns the rectangles of the tiles covering a frame buffer, they are
+	 * kTileSize pixels wide and high except on the right and bottom borders.
+	 */
+	const Common::Array<Common::Rect> &getScreenTiles(int width, int height);
+
+	/**
+	 * Executes every draw call of the queue clipped to every rectangle it touches.
+	 * When a dirty region is given, draw calls outside of it are skipped early.
+	 */
+	void render(GLContext *c, const Graphics::DrawCallQueue &queue, const Common::Array<Common::Rect> &rectangles,
+	            const DirtyRegionGrid *dirtyRegion = nullptr);
+
+	/**
+	 * Returns true while the rectangles are replayed by the worker threads.
+	 */
+	bool isRenderingInParallel() const { return _renderingInParallel; }
+
+	/**
+	 * Returns the context of the worker thread calling this method.
+	 * Only valid while isRenderingInParallel() returns true.
+	 */
+	GLContext *getWorkerContext() const;
+
+	int getExecutedDrawCalls() const { return _executedDrawCalls; }
+	int getRasterizedPixels() const { return _rasterizedPixels; }
+private:
+	struct BinEntry {
+		uint rectangle;
+		const Graphics::DrawCall *drawCall;
+	};
+
+	void bin(const Graphics::DrawCallQueue &queue, const Common::Array<Common::Rect> &rectangles, const DirtyRegionGrid *dirtyRegion);
+	void renderRectangle(uint index) const;
+	static void renderRectangleJob(void *renderer, uint index);
+	void updateWorkerContexts(GLContext *c);
+
+	Common::WorkerPool *_workerPool;
+	Common::Array<GLContext *> _workerContexts;
+	bool _renderingInParallel;
+
+	Common::Array<Common::Rect> _screenTiles;
+	int _screenTilesWidth, _screenTilesHeight;
+
+	// The draw calls of rectangle i are _binDrawCalls[_binOffsets[i]] to _binDrawCalls[_binOffsets[i + 1] - 1]
+	const Common::Array<Common::Rect> *_rectangles;
+	Common::Array<BinEntry> _binEntries;
+	Common::Array<uint> _binOffsets;
+	Common::Array<const Graphics::DrawCall *> _binDrawCalls;
+
+	int _executedDrawCalls;
+	int _rasterizedPixels;
+};
+
+} // end of namespace TinyGL
+
 #endif
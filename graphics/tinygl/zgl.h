@@ -202,6 +202,7 @@ struct GLSharedState {
  * The allocator can be initialized to a specific buffer size only once.
  * The allocation scheme is pretty simple: pointers are returned relative to a current memory position,
  * the allocator starts with an offset of 0 and increases its offset by the allocated amount every time.
+ * Allocations are rounded up so that every returned pointer is suitably aligned for any type.
  * Memory is released through the method free(), care has to be taken to call the destructors of the deallocated objects either manually (for complex struct arrays) or
  * by overriding the delete operator (with an empty implementation).
  */
@@ -211,6 +212,7 @@ public:
 		_memoryBuffer = nullptr;
 		_memorySize = 0;
 		_memoryPosition = 0;
+		_allocationCount = 0;
 	}
 
 	void initialize(size_t newSize) {
@@ -230,21 +232,30 @@ public:
 	}
 
 	void *allocate(size_t size) {
+		size = (size + kAlignment - 1) & ~(kAlignment - 1);
 		if (_memoryPosition + size >= _memorySize) {
 			error("Allocator out of memory: couldn't allocate more memory from linear allocator.");
 		}
 		size_t returnPos = _memoryPosition;
 		_memoryPosition += size;
+		_allocationCount++;
 		return ((char *)_memoryBuffer) + returnPos;
 	}
 
 	void reset() {
 		_memoryPosition = 0;
+		_allocationCount = 0;
 	}
+
+	size_t getUsedSize() const { return _memoryPosition; }
+	int getAllocationCount() const { return _allocationCount; }
 private:
+	static const size_t kAlignment = 8;
+
 	void *_memoryBuffer;
 	size_t _memorySize;
 	size_t _memoryPosition;
+	int _allocationCount;
 };
 
 struct GLContext;
@@ -381,15 +392,21 @@ struct GLContext {
 	Common::Rect _scissorRect;
 
 	bool _enableDirtyRectangles;
+	bool _enableTiledRendering;
 
 	// blit test
 	Common::List<Graphics::BlitImage *> _blitImages;
 
 	// Draw call queue
-	Common::List<Graphics::DrawCall *> _drawCallsQueue;
-	Common::List<Graphics::DrawCall *> _previousFrameDrawCallsQueue;
+	Graphics::DrawCallQueue _drawCallsQueue;
+	Graphics::DrawCallQueue _previousFrameDrawCallsQueue;
+	Common::Array<DrawCallHashEntry> _previousFrameDrawCallsIndex;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
+	FrameAllocationStatistics _frameAllocationStats;
+	DirtyRegionGrid _dirtyRegion;
+	DirtyRectStatistics _dirtyRectStats;
+	TileRenderer _tileRenderer;
 };
 
 extern GLContext *gl_ctx;
@@ -433,6 +450,9 @@ void tglIssueDrawCall(Graphics::DrawCall *drawCall);
 void tglDisposeResources(GLContext *c);
 void tglDisposeDrawCallLists(TinyGL::GLContext *c);
 
+// memory.cpp
+void gl_get_heap_call_counts(int &allocations, int &frees);
+
 GLContext *gl_get_context();
 
 // specular buffer "api"
@@ -0,0 +1,378 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * This file is based on, or a modified version of code from TinyGL (C) 1997-1998 Fabrice Bellard,
+ * which is licensed under the zlib-license (see LICENSE).
+ * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SCUMM_LITTLE_ENDIAN) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TGL_SPAN_SSE2
+#include <emmintrin.h>
+#elif defined(SCUMM_LITTLE_ENDIAN) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define TGL_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+#include "graphics/tinygl/zspan.h"
+#include "graphics/tinygl/zbuffer.h"
+#include "common/textconsole.h"
+
+namespace TinyGL {
+
+#if defined(TGL_SPAN_SSE2) || defined(TGL_SPAN_NEON)
+
+// All kernels work on four pixels at a time, with one pixel per 32 bits lane.
+// The helpers below are the only place where SSE2 and NEON differ.
+
+#ifdef TGL_SPAN_SSE2
+
+typedef __m128i Vec;
+
+static inline Vec vSet(uint32 v) { return _mm_set1_epi32((int)v); }
+static inline Vec vLoad(const void *p) { return _mm_loadu_si128((const __m128i *)p); }
+static inline void vStore(void *p, Vec v) { _mm_storeu_si128((__m128i *)p, v); }
+static inline Vec vAdd(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+static inline Vec vSub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+static inline Vec vAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+static inline Vec vOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+static inline Vec vNot(Vec a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+static inline Vec vSelect(Vec mask, Vec a, Vec b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+static inline Vec vShr(Vec a, int n) { return _mm_srl_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline Vec vShl(Vec a, int n) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline Vec vCmpEq(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+static inline Vec vCmpGtSigned(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+
+static inline Vec vCmpGt(Vec a, Vec b) {
+	const Vec bias = _mm_set1_epi32((int)0x80000000);
+	return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+// Lanes of a must be below 256 and lanes of b below 65536, only the low
+// 16 bits of the products are kept.
+static inline Vec vMul8(Vec a, Vec b) { return _mm_mullo_epi16(a, b); }
+
+// Lanes must be below 32768.
+static inline Vec vMin(Vec a, Vec b) { return _mm_min_epi16(a, b); }
+
+static inline bool vAny(Vec a) { return _mm_movemask_epi8(a) != 0; }
+
+#else
+
+typedef uint32x4_t Vec;
+
+static inline Vec vSet(uint32 v) { return vdupq_n_u32(v); }
+static inline Vec vLoad(const void *p) { return vld1q_u32((const uint32 *)p); }
+static inline void vStore(void *p, Vec v) { vst1q_u32((uint32 *)p, v); }
+static inline Vec vAdd(Vec a, Vec b) { return vaddq_u32(a, b); }
+static inline Vec vSub(Vec a, Vec b) { return vsubq_u32(a, b); }
+static inline Vec vAnd(Vec a, Vec b) { return vandq_u32(a, b); }
+static inline Vec vOr(Vec a, Vec b) { return vorrq_u32(a, b); }
+static inline Vec vNot(Vec a) { return vmvnq_u32(a); }
+static inline Vec vSelect(Vec mask, Vec a, Vec b) { return vbslq_u32(mask, a, b); }
+static inline Vec vShr(Vec a, int n) { return vshlq_u32(a, vdupq_n_s32(-n)); }
+static inline Vec vShl(Vec a, int n) { return vshlq_u32(a, vdupq_n_s32(n)); }
+static inline Vec vCmpEq(Vec a, Vec b) { return vceqq_u32(a, b); }
+static inline Vec vCmpGtSigned(Vec a, Vec b) { return vcgtq_s32(vreinterpretq_s32_u32(a), vreinterpretq_s32_u32(b)); }
+static inline Vec vCmpGt(Vec a, Vec b) { return vcgtq_u32(a, b); }
+static inline Vec vMul8(Vec a, Vec b) { return vandq_u32(vmulq_u32(a, b), vdupq_n_u32(0xFFFF)); }
+static inline Vec vMin(Vec a, Vec b) { return vminq_u32(a, b); }
+
+static inline bool vAny(Vec a) {
+	uint32x2_t halves = vorr_u32(vget_low_u32(a), vget_high_u32(a));
+	return (vget_lane_u32(halves, 0) | vget_lane_u32(halves, 1)) != 0;
+}
+
+#endif
+
+static inline Vec vRamp(uint32 v, int step) {
+	const uint32 lanes[4] = { v, v + (uint32)step, v + 2 * (uint32)step, v + 3 * (uint32)step };
+	return vLoad(lanes);
+}
+
+static inline Vec vStep4(int step) {
+	return vSet(4 * (uint32)step);
+}
+
+static inline Vec depthMask(const SpanState &state, Vec zSrc, Vec zDst) {
+	if (!state.depthTest)
+		return vSet(0xFFFFFFFF);
+
+	// Same comparisons as FrameBuffer::compareDepth
+	switch (state.depthFunc) {
+	case TGL_LESS:
+		return vCmpGt(zSrc, zDst);
+	case TGL_EQUAL:
+		return vCmpEq(zDst, zSrc);
+	case TGL_LEQUAL:
+		return vNot(vCmpGt(zDst, zSrc));
+	case TGL_GREATER:
+		return vCmpGt(zDst, zSrc);
+	case TGL_NOTEQUAL:
+		return vNot(vCmpEq(zDst, zSrc));
+	case TGL_GEQUAL:
+		return vNot(vCmpGt(zSrc, zDst));
+	case TGL_ALWAYS:
+		return vSet(0xFFFFFFFF);
+	default:
+		return vSet(0);
+	}
+}
+
+static inline Vec scissorMask(const SpanState &state, int x) {
+	if (!state.scissor)
+		return vSet(0xFFFFFFFF);
+
+	Vec xs = vRamp(x, 1);
+	return vNot(vOr(vCmpGtSigned(vSet(state.clipLeft), xs), vCmpGtSigned(xs, vSet(state.clipRight))));
+}
+
+static inline void writeColor(const SpanState &state, uint32 *pixels, Vec mask, Vec a, Vec r, Vec g, Vec b) {
+	Vec dst = vLoad(pixels);
+	Vec color;
+	if (state.blending) {
+		// Same as FrameBuffer::writePixel with (TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA)
+		const Vec ff = vSet(0xFF);
+		Vec invA = vSub(ff, a);
+		Vec rDst = vAnd(vShr(dst, state.rShift), ff);
+		Vec gDst = vAnd(vShr(dst, state.gShift), ff);
+		Vec bDst = vAnd(vShr(dst, state.bShift), ff);
+		r = vMin(vAdd(vShr(vMul8(r, a), 8), vShr(vMul8(rDst, invA), 8)), ff);
+		g = vMin(vAdd(vShr(vMul8(g, a), 8), vShr(vMul8(gDst, invA), 8)), ff);
+		b = vMin(vAdd(vShr(vMul8(b, a), 8), vShr(vMul8(bDst, invA), 8)), ff);
+		a = ff;
+	}
+	color = vOr(vOr(vShl(vShr(a, state.aLoss), state.aShift), vShl(r, state.rShift)),
+	            vOr(vShl(g, state.gShift), vShl(b, state.bShift)));
+	vStore(pixels, vSelect(mask, color, dst));
+}
+
+static inline void writeDepth(const SpanState &state, unsigned int *zbuf, Vec mask, Vec z, Vec zDst) {
+	if (state.depthWrite)
+		vStore(zbuf, vSelect(mask, z, zDst));
+}
+
+static inline Vec component(Vec v) {
+	return vAnd(vShr(v, 8), vSet(0xFF));
+}
+
+struct DepthQuad {
+	Vec z, dz;
+
+	DepthQuad(const Span &span) {
+		z = vRamp(span.z, span.dzdx);
+		dz = vStep4(span.dzdx);
+	}
+
+	void operator()(const SpanState &state, uint32 *pixels, unsigned int *zbuf, int x, Vec valid) {
+		Vec zDst = vLoad(zbuf);
+		Vec mask = vAnd(vAnd(valid, scissorMask(state, x)), depthMask(state, z, zDst));
+		writeDepth(state, zbuf, mask, z, zDst);
+		z = vAdd(z, dz);
+	}
+};
+
+struct ColorQuad {
+	Vec z, r, g, b, a;
+	Vec dz, dr, dg, db, da;
+
+	ColorQuad(const Span &span) {
+		z = vRamp(span.z, span.dzdx);
+		r = vRamp(span.r, span.drdx);
+		g = vRamp(span.g, span.dgdx);
+		b = vRamp(span.b, span.dbdx);
+		a = vRamp(span.a, span.dadx);
+		dz = vStep4(span.dzdx);
+		dr = vStep4(span.drdx);
+		dg = vStep4(span.dgdx);
+		db = vStep4(span.dbdx);
+		da = vStep4(span.dadx);
+	}
+
+	void step() {
+		z = vAdd(z, dz);
+		r = vAdd(r, dr);
+		g = vAdd(g, dg);
+		b = vAdd(b, db);
+		a = vAdd(a, da);
+	}
+
+	void operator()(const SpanState &state, uint32 *pixels, unsigned int *zbuf, int x, Vec valid) {
+		Vec zDst = vLoad(zbuf);
+		Vec mask = vAnd(vAnd(valid, scissorMask(state, x)), depthMask(state, z, zDst));
+		if (vAny(mask)) {
+			writeColor(state, pixels, mask, component(a), component(r), component(g), component(b));
+			writeDepth(state, zbuf, mask, z, zDst);
+		}
+		step();
+	}
+};
+
+struct TextureQuad : public ColorQuad {
+	Vec s, t;
+	Vec ds, dt;
+
+	TextureQuad(const Span &span) : ColorQuad(span) {
+	}
+
+	void setTextureCoords(unsigned int s0, unsigned int t0, int dsdx, int dtdx) {
+		s = vRamp(s0, dsdx);
+		t = vRamp(t0, dtdx);
+		ds = vStep4(dsdx);
+		dt = vStep4(dtdx);
+	}
+
+	// Only the low 16 bits of the lighting factor matter for the low byte of (texel * light) / 256.
+	static inline Vec light(Vec c, Vec l) {
+		return vAnd(vShr(vMul8(c, vAnd(vShr(l, 8), vSet(0xFFFF))), 8), vSet(0xFF));
+	}
+
+	void operator()(const SpanState &state, uint32 *pixels, unsigned int *zbuf, int x, Vec valid) {
+		Vec zDst = vLoad(zbuf);
+		Vec mask = vAnd(vAnd(valid, scissorMask(state, x)), depthMask(state, z, zDst));
+		if (vAny(mask)) {
+			const Vec textureSizeMask = vSet(state.textureSizeMask);
+			uint32 sss[4], ttt[4], texels[4];
+			vStore(sss, vShr(vAnd(s, textureSizeMask), ZB_POINT_ST_FRAC_BITS));
+			vStore(ttt, vShr(vAnd(t, textureSizeMask), ZB_POINT_ST_FRAC_BITS));
+			for (int i = 0; i < 4; i++) {
+				texels[i] = state.texture[ttt[i] * state.textureSize + sss[i]];
+			}
+			Vec texel = vLoad(texels);
+
+			const Vec ff = vSet(0xFF);
+			Vec cA = light(vAnd(vShr(texel, state.texAShift), ff), a);
+			Vec cR = light(vAnd(vShr(texel, state.texRShift), ff), r);
+			Vec cG = light(vAnd(vShr(texel, state.texGShift), ff), g);
+			Vec cB = light(vAnd(vShr(texel, state.texBShift), ff), b);
+			writeColor(state, pixels, mask, cA, cR, cG, cB);
+			writeDepth(state, zbuf, mask, z, zDst);
+		}
+		step();
+		s = vAdd(s, ds);
+		t = vAdd(t, dt);
+	}
+};
+
+template <class Quad>
+static void runQuads(const SpanState &state, Quad &quad, uint32 *&pixels, unsigned int *&zbuf, int &x, int n) {
+	const Vec all = vSet(0xFFFFFFFF);
+	while (n >= 4) {
+		quad(state, pixels, zbuf, x, all);
+		pixels += 4;
+		zbuf += 4;
+		x += 4;
+		n -= 4;
+	}
+
+	// The last pixels go through a copy, so that nothing is read or written past the span.
+	if (n > 0) {
+		uint32 tailPixels[4];
+		unsigned int tailZ[4];
+		memcpy(tailPixels, pixels, n * sizeof(uint32));
+		memcpy(tailZ, zbuf, n * sizeof(unsigned int));
+		Vec valid = vCmpGtSigned(vSet(n), vRamp(0, 1));
+		quad(state, tailPixels, tailZ, x, valid);
+		memcpy(pixels, tailPixels, n * sizeof(uint32));
+		memcpy(zbuf, tailZ, n * sizeof(unsigned int));
+		pixels += n;
+		zbuf += n;
+		x += n;
+	}
+}
+
+bool spanKernelsAvailable() {
+	return true;
+}
+
+void fillSpanDepth(const SpanState &state, const Span &span) {
+	DepthQuad quad(span);
+	uint32 *pixels = span.pixels;
+	unsigned int *zbuf = span.zbuf;
+	int x = span.x;
+	runQuads(state, quad, pixels, zbuf, x, span.count);
+}
+
+void fillSpanColor(const SpanState &state, const Span &span) {
+	ColorQuad quad(span);
+	uint32 *pixels = span.pixels;
+	unsigned int *zbuf = span.zbuf;
+	int x = span.x;
+	runQuads(state, quad, pixels, zbuf, x, span.count);
+}
+
+void fillSpanTexture(const SpanState &state, const Span &span, SpanPerspective &perspective) {
+	TextureQuad quad(span);
+	uint32 *pixels = span.pixels;
+	unsigned int *zbuf = span.zbuf;
+	int x = span.x;
+
+	// Same perspective correction steps as the scalar loop in FrameBuffer::fillTriangle.
+	int n = span.count - 1;
+	float ss, tt;
+	float zinv = (float)(1.0 / perspective.fz);
+	while (n >= (NB_INTERP - 1)) {
+		ss = perspective.sz * zinv;
+		tt = perspective.tz * zinv;
+		quad.setTextureCoords((int)ss, (int)tt,
+		                      (int)((perspective.dszdx - ss * perspective.fdzdx) * zinv),
+		                      (int)((perspective.dtzdx - tt * perspective.fdzdx) * zinv));
+		perspective.fz += perspective.fndzdx;
+		zinv = (float)(1.0 / perspective.fz);
+		runQuads(state, quad, pixels, zbuf, x, NB_INTERP);
+		n -= NB_INTERP;
+		perspective.sz += perspective.ndszdx;
+		perspective.tz += perspective.ndtzdx;
+	}
+
+	ss = perspective.sz * zinv;
+	tt = perspective.tz * zinv;
+	quad.setTextureCoords((int)ss, (int)tt,
+	                      (int)((perspective.dszdx - ss * perspective.fdzdx) * zinv),
+	                      (int)((perspective.dtzdx - tt * perspective.fdzdx) * zinv));
+	runQuads(state, quad, pixels, zbuf, x, n + 1);
+}
+
+#else
+
+bool spanKernelsAvailable() {
+	return false;
+}
+
+void fillSpanDepth(const SpanState &state, const Span &span) {
+	error("fillSpanDepth: No span kernels available");
+}
+
+void fillSpanColor(const SpanState &state, const Span &span) {
+	error("fillSpanColor: No span kernels available");
+}
+
+void fillSpanTexture(const SpanState &state, const Span &span, SpanPerspective &perspective) {
+	error("fillSpanTexture: No span kernels available");
+}
+
+#endif
+
+} // end of namespace TinyGL
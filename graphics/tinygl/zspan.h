@@ -0,0 +1,92 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * This file is based on, or a modified version of code from TinyGL (C) 1997-1998 Fabrice Bellard,
+ * which is licensed under the zlib-license (see LICENSE).
+ * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H_
+#define GRAPHICS_TINYGL_ZSPAN_H_
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * Pixel pipeline state shared by all the spans of a triangle.
+ * The span kernels only handle 32 bits frame buffers and textures with 8 bits
+ * color components, no alpha test, and either no blending or
+ * (TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA) blending.
+ */
+struct SpanState {
+	bool depthTest;
+	int depthFunc;
+	bool depthWrite;
+	bool blending;
+	bool scissor;
+	int clipLeft, clipRight;
+
+	int aShift, rShift, gShift, bShift;
+	int aLoss;
+
+	const uint32 *texture;
+	int textureSize, textureSizeMask;
+	int texAShift, texRShift, texGShift, texBShift;
+};
+
+/**
+ * A horizontal run of pixels along with the values interpolated over it.
+ */
+struct Span {
+	uint32 *pixels;
+	unsigned int *zbuf;
+	int x;
+	int count;
+
+	unsigned int z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+};
+
+/**
+ * Perspective correct texture coordinates, the texture coordinates are
+ * linearly interpolated between points NB_INTERP pixels apart.
+ */
+struct SpanPerspective {
+	float sz, tz, fz;
+	float dszdx, dtzdx, fdzdx;
+	float ndszdx, ndtzdx, fndzdx;
+};
+
+/**
+ * Checks if vectorized span kernels were compiled in for this CPU.
+ */
+bool spanKernelsAvailable();
+
+void fillSpanDepth(const SpanState &state, const Span &span);
+void fillSpanColor(const SpanState &state, const Span &span);
+void fillSpanTexture(const SpanState &state, const Span &span, SpanPerspective &perspective);
+
+} // end of namespace TinyGL
+
+#endif
@@ -29,11 +29,10 @@
 #include "common/endian.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
-static const int NB_INTERP = 8;
-
 template <bool kDepthWrite, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending>
 FORCEINLINE static void putPixelFlat(FrameBuffer *buffer, int buf, unsigned int *pz, int _a,
                                      int x, int y, unsigned int &z, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a, int &dzdx) {
@@ -160,6 +159,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// Triangles entirely outside of the scissor rectangle don't need any setup.
+	if (kEnableScissor) {
+		if (p2->y < _clipRectangle.top || p0->y > _clipRectangle.bottom)
+			return;
+		if (MAX(p0->x, MAX(p1->x, p2->x)) < _clipRectangle.left || MIN(p0->x, MIN(p1->x, p2->x)) > _clipRectangle.right)
+			return;
+	}
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -277,6 +284,36 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// The vectorized span kernels cover the common pixel pipelines; anything else
+	// goes through the scalar loops below.
+	const bool useSpanKernels = _spanKernels && !kAlphaTestEnabled &&
+		kDrawLogic != DRAW_SHADOW_MASK && kDrawLogic != DRAW_SHADOW &&
+		(!kBlendingEnabled || isAlphaBlendingEnabled());
+	SpanState spanState;
+	if (useSpanKernels) {
+		spanState.depthTest = _depthTestEnabled;
+		spanState.depthFunc = _depthFunc;
+		spanState.depthWrite = kDepthWrite;
+		spanState.blending = kBlendingEnabled;
+		spanState.scissor = kEnableScissor;
+		spanState.clipLeft = _clipRectangle.left;
+		spanState.clipRight = _clipRectangle.right;
+		spanState.aShift = cmode.aShift;
+		spanState.rShift = cmode.rShift;
+		spanState.gShift = cmode.gShift;
+		spanState.bShift = cmode.bShift;
+		spanState.aLoss = cmode.aLoss;
+		if (kInterpST || kInterpSTZ) {
+			spanState.texture = (const uint32 *)texture.getRawBuffer();
+			spanState.textureSize = _textureSize;
+			spanState.textureSizeMask = _textureSizeMask;
+			spanState.texAShift = textureFormat.aShift;
+			spanState.texRShift = textureFormat.rShift;
+			spanState.texGShift = textureFormat.gShift;
+			spanState.texBShift = textureFormat.bShift;
+		}
+	}
+
 	for (part = 0; part < 2; part++) {
 		int y;
 		if (part == 0) {
@@ -311,7 +348,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				l2 = p2;
 			}
 			nb_lines = p2->y - p1->y + 1;
-			y = pr1->y;
+			y = p1->y;
 		}
 
 		// compute the values for the left edge
@@ -380,8 +417,47 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		while (nb_lines > 0) {
 			nb_lines--;
 			int x = x1;
-			{
-				if (kDrawLogic == DRAW_DEPTH_ONLY ||
+			// Scan lines outside of the scissor rectangle only need their edges stepped.
+			if (!kEnableScissor || (y >= _clipRectangle.top && y <= _clipRectangle.bottom)) {
+				if (useSpanKernels) {
+					Span span;
+					span.pixels = (uint32 *)pbuf.getRawBuffer(pp1 + x1);
+					span.zbuf = pz1 + x1;
+					span.x = x1;
+					span.z = z1;
+					span.dzdx = dzdx;
+					span.r = r1;
+					span.g = g1;
+					span.b = b1;
+					span.a = a1;
+					if (kDrawLogic == DRAW_SMOOTH) {
+						span.drdx = drdx;
+						span.dgdx = dgdx;
+						span.dbdx = dbdx;
+						span.dadx = dadx;
+					} else {
+						span.drdx = span.dgdx = span.dbdx = span.dadx = 0;
+					}
+
+					span.count = MAX((x2 >> 16) - x1 + 1, 0);
+					if (kDrawLogic == DRAW_DEPTH_ONLY) {
+						fillSpanDepth(spanState, span);
+					} else if (!(kInterpST || kInterpSTZ)) {
+						fillSpanColor(spanState, span);
+					} else {
+						SpanPerspective perspective;
+						perspective.sz = sz1;
+						perspective.tz = tz1;
+						perspective.fz = (float)z1;
+						perspective.dszdx = dszdx;
+						perspective.dtzdx = dtzdx;
+						perspective.fdzdx = fdzdx;
+						perspective.ndszdx = ndszdx;
+						perspective.ndtzdx = ndtzdx;
+						perspective.fndzdx = fndzdx;
+						fillSpanTexture(spanState, span, perspective);
+					}
+				} else if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
 					int n;
@@ -409,7 +485,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						if (kDrawLogic == DRAW_FLAT) {
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 0, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 1, x, y, z, r, g, b, a, dzdx);
-							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, g, a, dzdx);
+							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 3, x, y, z, r, g, b, a, dzdx);
 						}
 						if (kInterpZ) {
@@ -435,25 +511,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						x += 1;
 					}
 				} else if (kDrawLogic == DRAW_SHADOW_MASK) {
-					unsigned char *pm;
-					int n;
-
-					n = (x2 >> 16) - x1;
-					pm = pm1 + x1;
-					while (n >= 3) {
-						pm[0] = 0xff;
-						pm[1] = 0xff;
-						pm[2] = 0xff;
-						pm[3] = 0xff;
-						pm += 4;
-						n -= 4;
-						x += 4;
+					int left = x1;
+					int right = x2 >> 16;
+					// The mask is clipped too, so that rectangles replayed in parallel
+					// never write the same bytes.
+					if (kEnableScissor) {
+						left = MAX<int>(left, _clipRectangle.left);
+						right = MIN<int>(right, _clipRectangle.right);
 					}
-					while (n >= 0) {
-						pm[0] = 0xff;
-						pm += 1;
-						n -= 1;
-						x += 1;
+					if (right >= left) {
+						memset(pm1 + left, 0xff, right - left + 1);
 					}
 				} else if (kDrawLogic == DRAW_SHADOW) {
 					unsigned char *pm;
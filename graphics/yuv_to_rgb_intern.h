@@ -0,0 +1,60 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Vectorized YUV to RGB converters shared by YUVToRGBManager and
+ * YUVAToRGBAManager.
+ *
+ * They produce exactly the same pixels as the lookup table converters,
+ * but only handle 32 bits pixel formats with 8 bits color components.
+ * They convert the image up to the largest width they can process in
+ * whole vectors, and return that width. The remaining columns are left
+ * to the lookup table converters. When no vectorized converter was
+ * compiled in, or the pixel format is not supported, they return 0.
+ */
+
+/**
+ * Convert the columns [0, width) of a YUV420 image, width is returned.
+ *
+ * @param aSrc    the alpha plane, or 0 for opaque pixels
+ * @param itu     whether the luminance values range from [16, 235]
+ */
+int convertYUV420ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+/**
+ * Convert the columns [0, width) of a YUV444 image, width is returned.
+ *
+ * @param itu     whether the luminance values range from [16, 235]
+ */
+int convertYUV444ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+} // End of namespace Graphics
+
+#endif
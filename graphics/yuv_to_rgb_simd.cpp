@@ -0,0 +1,395 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#if defined(SCUMM_LITTLE_ENDIAN) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GRAPHICS_YUV_SSE2
+#include <emmintrin.h>
+#elif defined(SCUMM_LITTLE_ENDIAN) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define GRAPHICS_YUV_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+#if defined(GRAPHICS_YUV_SSE2) || defined(GRAPHICS_YUV_NEON)
+
+// The lookup table converters compute the chroma contributions as
+// (int16)(c * (x - 128)). Here they are computed as
+// floor(|x - 128| * K / 2^15) with the sign restored afterwards, K being |c|
+// scaled by 2^15. For every 8 bits chroma value, both give the same result.
+enum {
+	kCrRCoef = 45919, //  0.419 / 0.299
+	kCrGCoef = 23383, // -0.299 / 0.419
+	kCbGCoef = 11286, // -0.114 / 0.331
+	kCbBCoef = 58111, //  0.587 / 0.331
+
+	// The ITU luminance scaling (x - 16) * 255 / 219 is computed as
+	// ((x - 16) * 4 * kITUScale) >> 16. It is exact for x in [16, 235], and
+	// gives values out of [0, 255] outside of that range, the clamping to
+	// [16, 235] is then done by saturating the result to [0, 255].
+	kITUScale = 19078
+};
+
+// The helpers below are the only place where SSE2 and NEON differ.
+
+#ifdef GRAPHICS_YUV_SSE2
+
+typedef __m128i ComponentVec; ///< 8 signed 16 bits color components
+typedef __m128i PixelBytes;   ///< One byte of 16 pixels
+
+static inline ComponentVec loadChroma(const byte *src) {
+	__m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+	return _mm_sub_epi16(c, _mm_set1_epi16(128));
+}
+
+static inline ComponentVec chromaTerm(ComponentVec x, int coef, bool negative) {
+	__m128i sign = _mm_srai_epi16(x, 15);
+	__m128i abs = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+	__m128i q = _mm_srli_epi16(_mm_mulhi_epu16(_mm_slli_epi16(abs, 8), _mm_set1_epi16((int16)coef)), 7);
+
+	if (negative)
+		sign = _mm_xor_si128(sign, _mm_set1_epi32(-1));
+
+	return _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+}
+
+static inline ComponentVec addComponents(ComponentVec a, ComponentVec b) {
+	return _mm_add_epi16(a, b);
+}
+
+static inline ComponentVec duplicateLow(ComponentVec x) {
+	return _mm_unpacklo_epi16(x, x);
+}
+
+static inline ComponentVec duplicateHigh(ComponentVec x) {
+	return _mm_unpackhi_epi16(x, x);
+}
+
+static inline void loadLuma(const byte *src, ComponentVec &low, ComponentVec &high) {
+	__m128i y = _mm_loadu_si128((const __m128i *)src);
+	low = _mm_unpacklo_epi8(y, _mm_setzero_si128());
+	high = _mm_unpackhi_epi8(y, _mm_setzero_si128());
+}
+
+static inline ComponentVec prescaleLumaITU(ComponentVec y) {
+	return _mm_slli_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), 2);
+}
+
+static inline ComponentVec prescaleChromaITU(ComponentVec c) {
+	return _mm_slli_epi16(c, 2);
+}
+
+static inline ComponentVec scaleITU(ComponentVec c) {
+	return _mm_mulhi_epi16(c, _mm_set1_epi16(kITUScale));
+}
+
+static inline PixelBytes packComponent(ComponentVec low, ComponentVec high) {
+	return _mm_packus_epi16(low, high);
+}
+
+static inline PixelBytes loadBytes(const byte *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+static inline PixelBytes setBytes(byte value) {
+	return _mm_set1_epi8((char)value);
+}
+
+static inline void storePixels(byte *dst, const PixelBytes bytes[4]) {
+	__m128i low01  = _mm_unpacklo_epi8(bytes[0], bytes[1]);
+	__m128i high01 = _mm_unpackhi_epi8(bytes[0], bytes[1]);
+	__m128i low23  = _mm_unpacklo_epi8(bytes[2], bytes[3]);
+	__m128i high23 = _mm_unpackhi_epi8(bytes[2], bytes[3]);
+
+	_mm_storeu_si128((__m128i *)(dst +  0), _mm_unpacklo_epi16(low01, low23));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(low01, low23));
+	_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(high01, high23));
+	_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(high01, high23));
+}
+
+#else
+
+typedef int16x8_t ComponentVec; ///< 8 signed 16 bits color components
+typedef uint8x16_t PixelBytes;  ///< One byte of 16 pixels
+
+static inline ComponentVec loadChroma(const byte *src) {
+	return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src))), vdupq_n_s16(128));
+}
+
+static inline ComponentVec chromaTerm(ComponentVec x, int coef, bool negative) {
+	uint16x8_t abs = vreinterpretq_u16_s16(vabsq_s16(x));
+	uint16x4_t low = vshrn_n_u32(vmull_n_u16(vget_low_u16(abs), coef), 15);
+	uint16x4_t high = vshrn_n_u32(vmull_n_u16(vget_high_u16(abs), coef), 15);
+	int16x8_t q = vreinterpretq_s16_u16(vcombine_u16(low, high));
+
+	uint16x8_t isNegative = vcltq_s16(x, vdupq_n_s16(0));
+	if (negative)
+		return vbslq_s16(isNegative, q, vnegq_s16(q));
+	else
+		return vbslq_s16(isNegative, vnegq_s16(q), q);
+}
+
+static inline ComponentVec addComponents(ComponentVec a, ComponentVec b) {
+	return vaddq_s16(a, b);
+}
+
+static inline ComponentVec duplicateLow(ComponentVec x) {
+	return vzipq_s16(x, x).val[0];
+}
+
+static inline ComponentVec duplicateHigh(ComponentVec x) {
+	return vzipq_s16(x, x).val[1];
+}
+
+static inline void loadLuma(const byte *src, ComponentVec &low, ComponentVec &high) {
+	uint8x16_t y = vld1q_u8(src);
+	low = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y)));
+	high = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y)));
+}
+
+// vqdmulh doubles the product, so the values are only scaled by 2 beforehand
+
+static inline ComponentVec prescaleLumaITU(ComponentVec y) {
+	return vshlq_n_s16(vsubq_s16(y, vdupq_n_s16(16)), 1);
+}
+
+static inline ComponentVec prescaleChromaITU(ComponentVec c) {
+	return vshlq_n_s16(c, 1);
+}
+
+static inline ComponentVec scaleITU(ComponentVec c) {
+	return vqdmulhq_n_s16(c, kITUScale);
+}
+
+static inline PixelBytes packComponent(ComponentVec low, ComponentVec high) {
+	return vcombine_u8(vqmovun_s16(low), vqmovun_s16(high));
+}
+
+static inline PixelBytes loadBytes(const byte *src) {
+	return vld1q_u8(src);
+}
+
+static inline PixelBytes setBytes(byte value) {
+	return vdupq_n_u8(value);
+}
+
+static inline void storePixels(byte *dst, const PixelBytes bytes[4]) {
+	uint8x16x4_t pixels;
+	pixels.val[0] = bytes[0];
+	pixels.val[1] = bytes[1];
+	pixels.val[2] = bytes[2];
+	pixels.val[3] = bytes[3];
+	vst4q_u8(dst, pixels);
+}
+
+#endif
+
+/** The position of the color components in the bytes of a pixel */
+struct PixelLayout {
+	int r, g, b, a;
+	byte opaqueAlpha; ///< The alpha byte of opaque pixels
+	bool hasAlpha;    ///< Does the format store alpha?
+};
+
+static bool getPixelLayout(const PixelFormat &format, PixelLayout &layout) {
+	if (format.bytesPerPixel != 4 || format.rLoss != 0 || format.gLoss != 0 || format.bLoss != 0)
+		return false;
+
+	if ((format.rShift & 7) || (format.gShift & 7) || (format.bShift & 7))
+		return false;
+
+	layout.r = format.rShift >> 3;
+	layout.g = format.gShift >> 3;
+	layout.b = format.bShift >> 3;
+
+	if (layout.r == layout.g || layout.r == layout.b || layout.g == layout.b)
+		return false;
+
+	// The remaining byte holds the alpha component, if any
+	layout.a = 6 - layout.r - layout.g - layout.b;
+
+	if (format.aLoss == 8) {
+		layout.hasAlpha = false;
+		layout.opaqueAlpha = 0;
+	} else if (format.aLoss == 0 && format.aShift == layout.a * 8) {
+		layout.hasAlpha = true;
+		layout.opaqueAlpha = 0xFF;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+/** The chroma contributions to the color components of 8 pixels */
+struct ChromaTerms {
+	ComponentVec r, g, b;
+};
+
+template<bool itu>
+static inline void computeChroma(const byte *uSrc, const byte *vSrc, ChromaTerms &terms) {
+	ComponentVec u = loadChroma(uSrc);
+	ComponentVec v = loadChroma(vSrc);
+
+	terms.r = chromaTerm(v, kCrRCoef, false);
+	terms.g = addComponents(chromaTerm(v, kCrGCoef, true), chromaTerm(u, kCbGCoef, true));
+	terms.b = chromaTerm(u, kCbBCoef, false);
+
+	if (itu) {
+		terms.r = prescaleChromaITU(terms.r);
+		terms.g = prescaleChromaITU(terms.g);
+		terms.b = prescaleChromaITU(terms.b);
+	}
+}
+
+template<bool itu>
+static inline PixelBytes convertComponent(ComponentVec yLow, ComponentVec yHigh, ComponentVec chromaLow, ComponentVec chromaHigh) {
+	ComponentVec low = addComponents(yLow, chromaLow);
+	ComponentVec high = addComponents(yHigh, chromaHigh);
+
+	if (itu) {
+		low = scaleITU(low);
+		high = scaleITU(high);
+	}
+
+	// Saturating to [0, 255] does the clamping
+	return packComponent(low, high);
+}
+
+template<bool itu>
+static inline void convertPixels(byte *dst, const PixelLayout &layout, const byte *ySrc, const ChromaTerms &low, const ChromaTerms &high, PixelBytes alpha) {
+	ComponentVec yLow, yHigh;
+	loadLuma(ySrc, yLow, yHigh);
+
+	if (itu) {
+		yLow = prescaleLumaITU(yLow);
+		yHigh = prescaleLumaITU(yHigh);
+	}
+
+	PixelBytes bytes[4];
+	bytes[layout.r] = convertComponent<itu>(yLow, yHigh, low.r, high.r);
+	bytes[layout.g] = convertComponent<itu>(yLow, yHigh, low.g, high.g);
+	bytes[layout.b] = convertComponent<itu>(yLow, yHigh, low.b, high.b);
+	bytes[layout.a] = alpha;
+
+	storePixels(dst, bytes);
+}
+
+template<bool itu>
+static void convertYUV420Vector(byte *dstPtr, int dstPitch, const PixelLayout &layout, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, int yHeight, int yPitch, int uvPitch) {
+	bool alphaPlane = aSrc && layout.hasAlpha;
+	PixelBytes opaque = setBytes(layout.opaqueAlpha);
+
+	for (int h = 0; h < yHeight; h += 2) {
+		for (int x = 0; x < width; x += 16) {
+			ChromaTerms chroma, low, high;
+			computeChroma<itu>(uSrc + (x >> 1), vSrc + (x >> 1), chroma);
+
+			// Each chroma sample covers two columns
+			low.r = duplicateLow(chroma.r);
+			low.g = duplicateLow(chroma.g);
+			low.b = duplicateLow(chroma.b);
+			high.r = duplicateHigh(chroma.r);
+			high.g = duplicateHigh(chroma.g);
+			high.b = duplicateHigh(chroma.b);
+
+			convertPixels<itu>(dstPtr + x * 4, layout, ySrc + x, low, high,
+			                   alphaPlane ? loadBytes(aSrc + x) : opaque);
+			convertPixels<itu>(dstPtr + dstPitch + x * 4, layout, ySrc + yPitch + x, low, high,
+			                   alphaPlane ? loadBytes(aSrc + yPitch + x) : opaque);
+		}
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		if (aSrc)
+			aSrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<bool itu>
+static void convertYUV444Vector(byte *dstPtr, int dstPitch, const PixelLayout &layout, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int yHeight, int yPitch, int uvPitch) {
+	PixelBytes opaque = setBytes(layout.opaqueAlpha);
+
+	for (int h = 0; h < yHeight; h++) {
+		for (int x = 0; x < width; x += 16) {
+			ChromaTerms low, high;
+			computeChroma<itu>(uSrc + x, vSrc + x, low);
+			computeChroma<itu>(uSrc + x + 8, vSrc + x + 8, high);
+
+			convertPixels<itu>(dstPtr + x * 4, layout, ySrc + x, low, high, opaque);
+		}
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+int convertYUV420ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int width = yWidth & ~15;
+
+	PixelLayout layout;
+	if (!width || !getPixelLayout(format, layout))
+		return 0;
+
+	// Use a templated function to avoid an if check on every pixel
+	if (itu)
+		convertYUV420Vector<true>(dstPtr, dstPitch, layout, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+	else
+		convertYUV420Vector<false>(dstPtr, dstPitch, layout, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+
+	return width;
+}
+
+int convertYUV444ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int width = yWidth & ~15;
+
+	PixelLayout layout;
+	if (!width || !getPixelLayout(format, layout))
+		return 0;
+
+	if (itu)
+		convertYUV444Vector<true>(dstPtr, dstPitch, layout, ySrc, uSrc, vSrc, width, yHeight, yPitch, uvPitch);
+	else
+		convertYUV444Vector<false>(dstPtr, dstPitch, layout, ySrc, uSrc, vSrc, width, yHeight, yPitch, uvPitch);
+
+	return width;
+}
+
+#else
+
+int convertYUV420ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	return 0;
+}
+
+int convertYUV444ToRGB32Vector(byte *dstPtr, int dstPitch, const PixelFormat &format, bool itu, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	return 0;
+}
+
+#endif
+
+} // End of namespace Graphics
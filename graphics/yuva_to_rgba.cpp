@@ -85,6 +85,7 @@
 
 #include "graphics/surface.h"
 #include "graphics/yuva_to_rgba.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVAToRGBAManager);
@@ -238,7 +239,7 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lo
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		aSrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
@@ -254,13 +255,28 @@ void YUVAToRGBAManager::convert420(Graphics::Surface *dst, YUVAToRGBAManager::Lu
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	byte *dstPtr = (byte *)dst->getPixels();
+
+	// Convert as much as possible with the vectorized converter,
+	// and the remaining columns using the lookup tables
+	int vectorWidth = convertYUV420ToRGB32Vector(dstPtr, dst->pitch, dst->format, scale == kScaleITU, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (vectorWidth == yWidth)
+		return;
+
+	dstPtr += vectorWidth * dst->format.bytesPerPixel;
+	ySrc += vectorWidth;
+	uSrc += vectorWidth >> 1;
+	vSrc += vectorWidth >> 1;
+	aSrc += vectorWidth;
+	yWidth -= vectorWidth;
+
 	const YUVAToRGBALookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 } // End of namespace Graphics
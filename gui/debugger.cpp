@@ -25,6 +25,8 @@
 
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/file.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
@@ -77,6 +79,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("profiler",			WRAP_METHOD(Debugger, cmdProfiler));
 }
 
 Debugger::~Debugger() {
@@ -717,6 +721,35 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdProfiler(int argc, const char **argv) {
+	if (argc == 2 && !scumm_stricmp(argv[1], "on")) {
+		ProfileMan.setEnabled(true);
+		debugPrintf("Profiler enabled\n");
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "off")) {
+		ProfileMan.setEnabled(false);
+		debugPrintf("Profiler disabled\n");
+	} else if (argc == 3 && !scumm_stricmp(argv[1], "export")) {
+		if (!Common::Profiler::isEnabled()) {
+			debugPrintf("The profiler is not enabled\n");
+			return true;
+		}
+
+		Common::DumpFile file;
+		if (!file.open(argv[2])) {
+			debugPrintf("Failed to open '%s'\n", argv[2]);
+			return true;
+		}
+
+		uint32 zones = ProfileMan.exportChromeTrace(file);
+		file.finalize();
+		debugPrintf("Exported %d zones to '%s'\n", zones, argv[2]);
+	} else {
+		debugPrintf("Profiler is %s\n", Common::Profiler::isEnabled() ? "enabled" : "disabled");
+		debugPrintf("Usage: %s [on | off | export <file>]\n", argv[0]);
+	}
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
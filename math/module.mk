@@ -13,6 +13,7 @@ MODULE_OBJS := \
 	quat.o \
 	ray.o \
 	rect2d.o \
+	uniformgrid.o \
 	vector2d.o \
 	vector3d.o \
 	vector4d.o
@@ -0,0 +1,323 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "math/uniformgrid.h"
+
+#include "common/util.h"
+
+#include <float.h>
+
+namespace Math {
+
+UniformGrid::UniformGrid() :
+		_minX(0),
+		_minY(0),
+		_maxX(0),
+		_maxY(0),
+		_cellWidth(0),
+		_cellHeight(0),
+		_columns(0),
+		_rows(0),
+		_queryId(0) {
+}
+
+void UniformGrid::clear() {
+	_bounds.reset();
+	_cellWidth = 0;
+	_cellHeight = 0;
+	_columns = 0;
+	_rows = 0;
+	_cellBounds.clear();
+	_cellStart.clear();
+	_cellItems.clear();
+	_itemMarks.clear();
+	_queryId = 0;
+}
+
+void UniformGrid::build(const Common::Array<AABB> &boxes, uint itemsPerCell) {
+	clear();
+
+	for (uint i = 0; i < boxes.size(); i++) {
+		if (boxes[i].isValid()) {
+			_bounds.expand(boxes[i].getMin());
+			_bounds.expand(boxes[i].getMax());
+		}
+	}
+
+	if (!_bounds.isValid()) {
+		return;
+	}
+
+	// Add a margin so the points computed on the boundaries of the items
+	// are not rejected because of rounding errors
+	Vector3d size = _bounds.getMax() - _bounds.getMin();
+	float margin = MAX(MAX(size.x(), size.y()), size.z()) * 0.001f + 0.001f;
+	Vector3d marginVector(margin, margin, margin);
+	_bounds = AABB(_bounds.getMin() - marginVector, _bounds.getMax() + marginVector);
+	size = _bounds.getMax() - _bounds.getMin();
+	_minX = _bounds.getMin().x();
+	_minY = _bounds.getMin().y();
+	_maxX = _bounds.getMax().x();
+	_maxY = _bounds.getMax().y();
+
+	// Use roughly square cells
+	float targetCellCount = MAX<float>(1.0f, boxes.size() / (float)MAX<uint>(itemsPerCell, 1));
+	_columns = CLIP<int>((int)(sqrt(targetCellCount * size.x() / size.y()) + 0.5f), 1, 256);
+	_rows = CLIP<int>((int)(targetCellCount / _columns + 0.5f), 1, 256);
+	_cellWidth = size.x() / _columns;
+	_cellHeight = size.y() / _rows;
+
+	uint cellCount = _columns * _rows;
+	_cellBounds.resize(cellCount);
+	_cellStart.resize(cellCount + 1);
+	for (uint i = 0; i <= cellCount; i++) {
+		_cellStart[i] = 0;
+	}
+
+	// Count the items of each cell, then store them in a single array
+	for (uint pass = 0; pass < 2; pass++) {
+		for (uint i = 0; i < boxes.size(); i++) {
+			if (!boxes[i].isValid()) {
+				continue;
+			}
+
+			const Vector3d &min = boxes[i].getMin();
+			const Vector3d &max = boxes[i].getMax();
+			int column1 = getColumn(min.x());
+			int column2 = getColumn(max.x());
+			int row1 = getRow(min.y());
+			int row2 = getRow(max.y());
+
+			for (int row = row1; row <= row2; row++) {
+				for (int column = column1; column <= column2; column++) {
+					uint cell = row * _columns + column;
+					if (pass == 0) {
+						_cellStart[cell + 1]++;
+					} else {
+						_cellItems[_cellStart[cell]++] = i;
+						_cellBounds[cell].expand(min);
+						_cellBounds[cell].expand(max);
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (uint cell = 0; cell < cellCount; cell++) {
+				_cellStart[cell + 1] += _cellStart[cell];
+			}
+			_cellItems.resize(_cellStart[cellCount]);
+		} else {
+			// The start positions have been moved to the end of the cells
+			for (uint cell = cellCount; cell > 0; cell--) {
+				_cellStart[cell] = _cellStart[cell - 1];
+			}
+			_cellStart[0] = 0;
+		}
+	}
+
+	_itemMarks.resize(boxes.size());
+	for (uint i = 0; i < _itemMarks.size(); i++) {
+		_itemMarks[i] = 0;
+	}
+}
+
+int UniformGrid::getColumn(float x) const {
+	return CLIP<int>((int)floor((x - _minX) / _cellWidth), 0, _columns - 1);
+}
+
+int UniformGrid::getRow(float y) const {
+	return CLIP<int>((int)floor((y - _minY) / _cellHeight), 0, _rows - 1);
+}
+
+const uint32 *UniformGrid::getCellItems(uint cell, uint &count) const {
+	count = _cellStart[cell + 1] - _cellStart[cell];
+	return count ? &_cellItems[_cellStart[cell]] : nullptr;
+}
+
+const uint32 *UniformGrid::findItemsAtPoint(const Vector3d &point, uint &count) const {
+	if (!_bounds.isValid()
+			|| point.x() < _minX || point.x() > _maxX || point.y() < _minY || point.y() > _maxY) {
+		count = 0;
+		return nullptr;
+	}
+
+	return getCellItems(getRow(point.y()) * _columns + getColumn(point.x()), count);
+}
+
+void UniformGrid::startQuery() const {
+	_queryId++;
+	if (_queryId == 0) {
+		for (uint i = 0; i < _itemMarks.size(); i++) {
+			_itemMarks[i] = 0;
+		}
+		_queryId = 1;
+	}
+}
+
+void UniformGrid::addCellItems(uint cell, Common::Array<uint32> &items) const {
+	for (uint32 i = _cellStart[cell]; i < _cellStart[cell + 1]; i++) {
+		uint32 item = _cellItems[i];
+		if (_itemMarks[item] != _queryId) {
+			_itemMarks[item] = _queryId;
+			items.push_back(item);
+		}
+	}
+}
+
+void UniformGrid::findItemsInRect(float minX, float minY, float maxX, float maxY, Common::Array<uint32> &items) const {
+	if (!_bounds.isValid()
+			|| maxX < _minX || minX > _maxX || maxY < _minY || minY > _maxY) {
+		return;
+	}
+
+	startQuery();
+
+	int column1 = getColumn(minX);
+	int column2 = getColumn(maxX);
+	int row1 = getRow(minY);
+	int row2 = getRow(maxY);
+
+	for (int row = row1; row <= row2; row++) {
+		for (int column = column1; column <= column2; column++) {
+			addCellItems(row * _columns + column, items);
+		}
+	}
+}
+
+/**
+ * Clip the parameter range of a segment to a slab along one axis
+ *
+ * @return false when nothing is left of the segment
+ */
+static bool clipToSlab(float origin, float delta, float min, float max, float &tMin, float &tMax) {
+	if (delta == 0.0f) {
+		return origin >= min && origin <= max;
+	}
+
+	float t1 = (min - origin) / delta;
+	float t2 = (max - origin) / delta;
+	tMin = MAX(tMin, MIN(t1, t2));
+	tMax = MIN(tMax, MAX(t1, t2));
+	return tMin <= tMax;
+}
+
+void UniformGrid::findItemsAlongSegment(const Vector3d &begin, const Vector3d &end, Common::Array<uint32> &items) const {
+	if (!_bounds.isValid()) {
+		return;
+	}
+
+	float x = begin.x();
+	float y = begin.y();
+	float dx = end.x() - x;
+	float dy = end.y() - y;
+
+	// Clip the segment to the XY bounds of the items
+	float tMin = 0.0f;
+	float tMax = 1.0f;
+	if (!clipToSlab(x, dx, _minX, _maxX, tMin, tMax) || !clipToSlab(y, dy, _minY, _maxY, tMin, tMax)) {
+		return;
+	}
+
+	startQuery();
+
+	int column = getColumn(x + tMin * dx);
+	int row = getRow(y + tMin * dy);
+	int lastColumn = getColumn(x + tMax * dx);
+	int lastRow = getRow(y + tMax * dy);
+
+	// Walk through the cells in the order the segment crosses them, stepping
+	// to the next column or row depending on which boundary is crossed first
+	// (Amanatides and Woo's traversal).
+	int stepColumn = dx > 0.0f ? 1 : -1;
+	int stepRow = dy > 0.0f ? 1 : -1;
+	float tDeltaX = dx != 0.0f ? _cellWidth / fabs(dx) : FLT_MAX;
+	float tDeltaY = dy != 0.0f ? _cellHeight / fabs(dy) : FLT_MAX;
+	float tNextX = FLT_MAX;
+	float tNextY = FLT_MAX;
+	if (dx != 0.0f) {
+		tNextX = (_minX + (column + (dx > 0.0f ? 1 : 0)) * _cellWidth - x) / dx;
+	}
+	if (dy != 0.0f) {
+		tNextY = (_minY + (row + (dy > 0.0f ? 1 : 0)) * _cellHeight - y) / dy;
+	}
+
+	addCellItems(row * _columns + column, items);
+
+	// Rounding errors can't make the walk miss the last cell, a step
+	// is only taken along an axis where it has not been reached yet.
+	while (column != lastColumn || row != lastRow) {
+		if (row == lastRow || (column != lastColumn && tNextX < tNextY)) {
+			column += stepColumn;
+			tNextX += tDeltaX;
+		} else {
+			row += stepRow;
+			tNextY += tDeltaY;
+		}
+
+		addCellItems(row * _columns + column, items);
+	}
+}
+
+void UniformGrid::findItemsAlongRay(const Ray &ray, Common::Array<uint32> &items) const {
+	if (!_bounds.isValid()) {
+		return;
+	}
+
+	// Clip the ray to the bounds of the items, using the slab method
+	Vector3d origin = ray.getOrigin();
+	Vector3d direction = ray.getDirection();
+	float tMin = 0.0f;
+	float tMax = FLT_MAX;
+
+	for (int axis = 0; axis < 3; axis++) {
+		float min = _bounds.getMin().getValue(axis);
+		float max = _bounds.getMax().getValue(axis);
+
+		if (fabs(direction.getValue(axis)) < 0.00001f) {
+			// The ray is parallel to the slab
+			if (origin.getValue(axis) < min || origin.getValue(axis) > max) {
+				return;
+			}
+			continue;
+		}
+
+		float t1 = (min - origin.getValue(axis)) / direction.getValue(axis);
+		float t2 = (max - origin.getValue(axis)) / direction.getValue(axis);
+		tMin = MAX(tMin, MIN(t1, t2));
+		tMax = MIN(tMax, MAX(t1, t2));
+
+		if (tMin > tMax) {
+			return;
+		}
+	}
+
+	if (tMax == FLT_MAX) {
+		// The ray has no direction
+		tMax = 0.0f;
+	}
+
+	findItemsAlongSegment(origin + tMin * direction, origin + tMax * direction, items);
+}
+
+} // end of namespace Math
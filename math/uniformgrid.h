@@ -0,0 +1,139 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef MATH_UNIFORMGRID_H
+#define MATH_UNIFORMGRID_H
+
+#include "common/array.h"
+
+#include "math/aabb.h"
+#include "math/ray.h"
+
+namespace Math {
+
+/**
+ * A uniform grid over the XY plane, to quickly find the items close to a point
+ * or along a ray amongst a large set of bounding boxes.
+ *
+ * The items are identified by their index in the array of boxes the grid is
+ * built from. Each cell lists, by increasing index, the items whose box
+ * overlaps it on the XY plane.
+ */
+class UniformGrid {
+public:
+	UniformGrid();
+
+	/**
+	 * Build the grid for a set of items
+	 *
+	 * @param boxes        the bounding boxes of the items
+	 * @param itemsPerCell the average number of items per cell to aim for
+	 */
+	void build(const Common::Array<AABB> &boxes, uint itemsPerCell = 2);
+
+	/** Remove all the items */
+	void clear();
+
+	/** Get the bounding box of all the items */
+	const AABB &getBounds() const { return _bounds; }
+
+	uint getCellCount() const { return _cellBounds.size(); }
+
+	/**
+	 * Get the bounding box of the items of a cell
+	 *
+	 * The box is not valid when the cell has no items.
+	 */
+	const AABB &getCellBounds(uint cell) const { return _cellBounds[cell]; }
+
+	/**
+	 * Get the items of a cell
+	 *
+	 * @param cell  the cell index
+	 * @param count set to the number of items of the cell
+	 * @return a pointer to the item indices, by increasing index
+	 */
+	const uint32 *getCellItems(uint cell, uint &count) const;
+
+	/**
+	 * Get the items whose box may contain a point projected on the XY plane
+	 *
+	 * @param count set to the number of items
+	 * @return a pointer to the item indices, by increasing index
+	 */
+	const uint32 *findItemsAtPoint(const Vector3d &point, uint &count) const;
+
+	/**
+	 * List the items whose box may overlap a rectangle on the XY plane
+	 *
+	 * @param items the indices of the items are appended to this array, without duplicates
+	 */
+	void findItemsInRect(float minX, float minY, float maxX, float maxY, Common::Array<uint32> &items) const;
+
+	/**
+	 * List the items whose box may be crossed by a segment projected on the XY plane
+	 *
+	 * Only the cells crossed by the segment are visited.
+	 *
+	 * @param items the indices of the items are appended to this array, without duplicates
+	 */
+	void findItemsAlongSegment(const Vector3d &begin, const Vector3d &end, Common::Array<uint32> &items) const;
+
+	/**
+	 * List the items whose box may be hit by a ray
+	 *
+	 * Only the cells crossed by the ray, once clipped to the bounds, are visited.
+	 *
+	 * @param items the indices of the items are appended to this array, without duplicates
+	 */
+	void findItemsAlongRay(const Ray &ray, Common::Array<uint32> &items) const;
+
+private:
+	int getColumn(float x) const;
+	int getRow(float y) const;
+
+	/** Start a query, so that the items are listed only once */
+	void startQuery() const;
+
+	/** Append the items of a cell not listed yet by the current query */
+	void addCellItems(uint cell, Common::Array<uint32> &items) const;
+
+	AABB _bounds;
+	float _minX, _minY, _maxX, _maxY; ///< The XY bounds, kept apart for the queries
+	float _cellWidth;
+	float _cellHeight;
+	int _columns;
+	int _rows;
+
+	Common::Array<AABB> _cellBounds;
+	Common::Array<uint32> _cellStart; ///< Position of the first item of each cell in _cellItems, plus the total count
+	Common::Array<uint32> _cellItems;
+
+	// Used to list each item only once in the queries
+	mutable Common::Array<uint32> _itemMarks;
+	mutable uint32 _queryId;
+};
+
+} // end of namespace Math
+
+#endif
@@ -0,0 +1,244 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/frac.h"
+
+#include <math.h>
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	int16 nextSample() {
+		_seed = _seed * 1103515245 + 12345;
+		return (int16)(_seed >> 16);
+	}
+
+	// Loud noise, so that the mix buffer saturates often
+	int16 *createNoise(int samples) {
+		int16 *noise = (int16 *)malloc(sizeof(int16) * samples);
+		for (int i = 0; i < samples; ++i)
+			noise[i] = nextSample();
+		return noise;
+	}
+
+	Audio::AudioStream *createNoiseStream(const int16 *noise, int samples, int rate, bool isStereo) {
+		return Audio::makeRawStream((const byte *)noise, samples * sizeof(int16), rate,
+		                            Audio::FLAG_16BITS
+#ifdef SCUMM_LITTLE_ENDIAN
+		                            | Audio::FLAG_LITTLE_ENDIAN
+#endif
+		                            | (isStereo ? Audio::FLAG_STEREO : 0), DisposeAfterUse::NO);
+	}
+
+	static void mixReference(int16 &out, int sample, int vol) {
+		int val = out + (sample * vol) / Audio::Mixer::kMaxMixerVolume;
+		out = (int16)CLIP<int>(val, -32768, 32767);
+	}
+
+	// Straightforward version of the sample selection done by the converters
+	static int16 referenceSample(const int16 *in, int frame, int channel, bool isStereo) {
+		return in[isStereo ? frame * 2 + channel : frame];
+	}
+
+	void testConverter(int inRate, int outRate, bool isStereo, bool reverseStereo, int volL, int volR) {
+		const int inFrames = 4099;
+		const int channels = isStereo ? 2 : 1;
+		const int outFrames = (int)((int64)inFrames * outRate / inRate) - 2;
+
+		int16 *noise = createNoise(inFrames * channels);
+		int16 *output = createNoise(outFrames * 2);
+		int16 *expected = (int16 *)malloc(sizeof(int16) * outFrames * 2);
+		memcpy(expected, output, sizeof(int16) * outFrames * 2);
+
+		// Compute the expected output
+		const int outL = reverseStereo ? 1 : 0;
+		const int outR = reverseStereo ? 0 : 1;
+		if (inRate == outRate) {
+			for (int i = 0; i < outFrames; ++i) {
+				mixReference(expected[i * 2 + outL], referenceSample(noise, i, 0, isStereo), volL);
+				mixReference(expected[i * 2 + outR], referenceSample(noise, i, 1, isStereo), volR);
+			}
+		} else if (inRate % outRate == 0) {
+			const int step = inRate / outRate;
+			for (int i = 0; i < outFrames; ++i) {
+				const int frame = i * step + 1;
+				mixReference(expected[i * 2 + outL], referenceSample(noise, frame, 0, isStereo), volL);
+				mixReference(expected[i * 2 + outR], referenceSample(noise, frame, 1, isStereo), volR);
+			}
+		} else {
+			const frac_t one = 1 << 15;
+			const frac_t inc = (inRate << 15) / outRate;
+			frac_t pos = one;
+			int frame = 0;
+			int16 last[2] = { 0, 0 }, cur[2] = { 0, 0 };
+			for (int i = 0; i < outFrames; ++i) {
+				while (pos >= one) {
+					for (int c = 0; c < 2; ++c) {
+						last[c] = cur[c];
+						cur[c] = referenceSample(noise, frame, c, isStereo);
+					}
+					frame++;
+					pos -= one;
+				}
+				for (int c = 0; c < 2; ++c) {
+					int16 sample = (int16)(last[c] + (((cur[c] - last[c]) * pos + (one >> 1)) >> 15));
+					mixReference(expected[i * 2 + (c ? outR : outL)], sample, c ? volR : volL);
+				}
+				pos += inc;
+			}
+		}
+
+		Audio::AudioStream *input = createNoiseStream(noise, inFrames * channels, inRate, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, reverseStereo);
+
+		// Convert in uneven chunks, to exercise the leftover handling of the converters
+		int done = 0;
+		while (done < outFrames) {
+			int chunk = MIN(outFrames - done, 333);
+			TS_ASSERT_EQUALS(converter->flow(*input, output + done * 2, chunk, volL, volR), chunk);
+			done += chunk;
+		}
+
+		TS_ASSERT_EQUALS(memcmp(output, expected, sizeof(int16) * outFrames * 2), 0);
+
+		delete converter;
+		delete input;
+		free(expected);
+		free(output);
+		free(noise);
+	}
+
+	void testAllLayouts(int inRate, int outRate) {
+		testConverter(inRate, outRate, false, false, 256, 0);
+		testConverter(inRate, outRate, false, false, 183, 97);
+		testConverter(inRate, outRate, true, false, 256, 256);
+		testConverter(inRate, outRate, true, false, 31, 200);
+		testConverter(inRate, outRate, true, true, 255, 12);
+	}
+
+	int16 *createTone(int rate, int frames, double frequency) {
+		int16 *tone = (int16 *)malloc(sizeof(int16) * frames);
+		for (int i = 0; i < frames; ++i)
+			tone[i] = (int16)floor(16000 * sin(2 * M_PI * frequency * i / rate) + 0.5);
+		return tone;
+	}
+
+	// Resample a mono tone, returns the largest difference with the ideal tone
+	int sincToneError(int inRate, int outRate, double frequency, bool compareToTone) {
+		const int inFrames = inRate / 4;
+		const int outFrames = (int)((int64)inFrames * outRate / inRate) - 64;
+
+		Audio::SincFilterBank *filters = Audio::SincFilterBank::create(inRate, outRate);
+		TS_ASSERT(filters);
+
+		int16 *tone = createTone(inRate, inFrames, frequency);
+		Audio::AudioStream *input = createNoiseStream(tone, inFrames, inRate, false);
+		Audio::RateConverter *converter = Audio::makeSincRateConverter(*filters, false);
+
+		int16 *output = (int16 *)calloc(outFrames * 2, sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*input, output, outFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), outFrames);
+
+		// Skip the frames where the filter still covers the silence before the tone
+		int maxError = 0;
+		for (int i = 64; i < outFrames; ++i) {
+			double expected = compareToTone ? 16000 * sin(2 * M_PI * frequency * i / outRate) : 0.0;
+			maxError = MAX<int>(maxError, (int)fabs(output[i * 2] - expected));
+		}
+
+		free(output);
+		delete converter;
+		delete input;
+		free(tone);
+		delete filters;
+
+		return maxError;
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_copy_converter() {
+		testAllLayouts(22050, 22050);
+	}
+
+	void test_simple_converter() {
+		testAllLayouts(44100, 22050);
+		testAllLayouts(44100, 11025);
+	}
+
+	void test_linear_converter() {
+		testAllLayouts(22050, 44100);
+		testAllLayouts(11025, 48000);
+		testAllLayouts(48000, 44100);
+	}
+
+	void test_sinc_filter_bank() {
+		Audio::SincFilterBank *filters = Audio::SincFilterBank::create(22050, 48000);
+		TS_ASSERT(filters);
+		TS_ASSERT_EQUALS(filters->getPhases(), 320);
+		TS_ASSERT_EQUALS(filters->getStep(), 147);
+		TS_ASSERT_EQUALS(filters->getTaps() % 8, 0);
+
+		// Each phase has unity gain
+		for (int p = 0; p < filters->getPhases(); ++p) {
+			int sum = 0;
+			for (int j = 0; j < filters->getTaps(); ++j)
+				sum += filters->getCoefficients(p)[j];
+			TS_ASSERT_EQUALS(sum, 1 << 14);
+		}
+		delete filters;
+
+		// Too many phases
+		TS_ASSERT(!Audio::SincFilterBank::create(22050, 48001));
+	}
+
+	void test_sinc_converter_tone() {
+		TS_ASSERT_LESS_THAN(sincToneError(11025, 48000, 1000, true), 16);
+		TS_ASSERT_LESS_THAN(sincToneError(22050, 48000, 1000, true), 16);
+		TS_ASSERT_LESS_THAN(sincToneError(44100, 48000, 1000, true), 16);
+		TS_ASSERT_LESS_THAN(sincToneError(48000, 44100, 1000, true), 16);
+		TS_ASSERT_LESS_THAN(sincToneError(44100, 22050, 1000, true), 16);
+	}
+
+	void test_sinc_converter_aliasing() {
+		// Above the output Nyquist frequency, the tone must be filtered out
+		TS_ASSERT_LESS_THAN(sincToneError(44100, 22050, 15000, false), 32);
+		TS_ASSERT_LESS_THAN(sincToneError(48000, 11025, 8000, false), 32);
+	}
+
+	void test_sinc_converter_stereo() {
+		const int inFrames = 2000;
+		int16 *constant = (int16 *)malloc(sizeof(int16) * inFrames * 2);
+		for (int i = 0; i < inFrames; ++i) {
+			constant[i * 2] = 10000;
+			constant[i * 2 + 1] = -5000;
+		}
+
+		Audio::SincFilterBank *filters = Audio::SincFilterBank::create(22050, 48000);
+		for (int reverse = 0; reverse < 2; ++reverse) {
+			Audio::AudioStream *input = createNoiseStream(constant, inFrames * 2, 22050, true);
+			Audio::RateConverter *converter = Audio::makeSincRateConverter(*filters, true, reverse != 0);
+
+			int16 output[200 * 2];
+			memset(output, 0, sizeof(output));
+			TS_ASSERT_EQUALS(converter->flow(*input, output, 200, 128, 256), 200);
+
+			// Once past the initial silence, constant signals come out unchanged
+			TS_ASSERT_EQUALS(output[199 * 2 + reverse], 5000);
+			TS_ASSERT_EQUALS(output[199 * 2 + 1 - reverse], -5000);
+
+			delete converter;
+			delete input;
+		}
+
+		delete filters;
+		free(constant);
+	}
+};
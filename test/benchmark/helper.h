@@ -0,0 +1,37 @@
+#ifndef TEST_BENCHMARK_HELPER_H
+#define TEST_BENCHMARK_HELPER_H
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Measures the processor time spent since its creation.
+ */
+class BenchmarkTimer {
+public:
+	BenchmarkTimer() : _start(clock()) {}
+
+	double getElapsedSeconds() const {
+		return (double)(clock() - _start) / CLOCKS_PER_SEC;
+	}
+
+private:
+	clock_t _start;
+};
+
+/**
+ * Print the throughput of a benchmark, in millions of items per second,
+ * or in thousands for the slow ones.
+ */
+static void reportThroughput(const char *name, double items, const char *unit, double seconds) {
+	if (seconds <= 0.0)
+		seconds = 1.0 / CLOCKS_PER_SEC;
+
+	double rate = items / seconds;
+	if (rate < 1000000.0)
+		printf("\n  %-52s %10.2f k%s/s", name, rate / 1000.0, unit);
+	else
+		printf("\n  %-52s %10.2f M%s/s", name, rate / 1000000.0, unit);
+}
+
+#endif
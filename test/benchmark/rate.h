@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/util.h"
+
+#include "helper.h"
+
+/**
+ * Never ending stream of noise, so that the benchmarks measure the rate
+ * converters rather than the decoding of their input.
+ */
+class NoiseAudioStream : public Audio::AudioStream {
+public:
+	NoiseAudioStream(int rate, bool stereo) : _rate(rate), _stereo(stereo), _pos(0) {
+		uint32 seed = 1;
+		for (int i = 0; i < BUFFER_SIZE; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_noise[i] = (int16)(seed >> 16);
+		}
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		int samples = numSamples;
+		while (samples > 0) {
+			int len = MIN(samples, BUFFER_SIZE - _pos);
+			memcpy(buffer, _noise + _pos, len * sizeof(int16));
+			_pos = (_pos + len) % BUFFER_SIZE;
+			buffer += len;
+			samples -= len;
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+
+private:
+	enum {
+		BUFFER_SIZE = 4096
+	};
+
+	int16 _noise[BUFFER_SIZE];
+	int _rate;
+	bool _stereo;
+	int _pos;
+};
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	void benchmarkConverter(const char *type, int inRate, int outRate, bool stereo) {
+		// The mixer converts in chunks of a few thousand frames
+		const int chunkFrames = 2048;
+		const int totalFrames = 40 * 1000 * 1000;
+
+		Audio::SincFilterBank *filters = 0;
+		if (!strcmp(type, "sinc"))
+			filters = Audio::SincFilterBank::create(inRate, outRate);
+
+		NoiseAudioStream input(inRate, stereo);
+		Audio::RateConverter *converter;
+		if (filters)
+			converter = Audio::makeSincRateConverter(*filters, stereo, false);
+		else
+			converter = Audio::makeRateConverter(inRate, outRate, stereo, false);
+		int16 *output = new int16[chunkFrames * 2];
+		memset(output, 0, chunkFrames * 2 * sizeof(int16));
+
+		BenchmarkTimer timer;
+		for (int done = 0; done < totalFrames; done += chunkFrames)
+			converter->flow(input, output, chunkFrames, 200, 180);
+		double seconds = timer.getElapsedSeconds();
+
+		char name[64];
+		snprintf(name, sizeof(name), "%-6s %-6s %5d Hz -> %5d Hz", type, stereo ? "stereo" : "mono", inRate, outRate);
+		reportThroughput(name, totalFrames, "frames", seconds);
+
+		delete[] output;
+		delete converter;
+		delete filters;
+	}
+
+	void benchmarkRates(const char *type, int inRate, int outRate) {
+		benchmarkConverter(type, inRate, outRate, false);
+		benchmarkConverter(type, inRate, outRate, true);
+	}
+
+public:
+	void test_copy_converter() {
+		benchmarkRates("copy", 22050, 22050);
+		benchmarkRates("copy", 44100, 44100);
+	}
+
+	void test_simple_converter() {
+		benchmarkRates("simple", 44100, 22050);
+		benchmarkRates("simple", 44100, 11025);
+	}
+
+	void test_linear_converter() {
+		benchmarkRates("linear", 11025, 44100);
+		benchmarkRates("linear", 22050, 44100);
+		benchmarkRates("linear", 22050, 48000);
+		benchmarkRates("linear", 44100, 48000);
+	}
+
+	void test_sinc_converter() {
+		benchmarkRates("sinc", 11025, 48000);
+		benchmarkRates("sinc", 22050, 44100);
+		benchmarkRates("sinc", 22050, 48000);
+		benchmarkRates("sinc", 44100, 48000);
+		benchmarkRates("sinc", 48000, 44100);
+	}
+};
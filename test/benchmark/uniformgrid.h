@@ -0,0 +1,176 @@
+#include <cxxtest/TestSuite.h>
+
+#include "math/uniformgrid.h"
+
+#include "helper.h"
+
+/**
+ * Compares testing all the faces of a walkable floor mesh with only testing
+ * the faces listed by a uniform grid, for the queries of the Stark floors.
+ */
+class UniformGridBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	// Testing all the faces is much slower, so it is done for fewer queries
+	enum {
+		kQueries = 200000,
+		kBruteForceQueries = 4000
+	};
+
+	struct Triangle {
+		Math::Vector3d v[3];
+	};
+
+	Common::Array<Triangle> _triangles;
+	uint32 _seed;
+
+	float randomFloat(float max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % 10000 / 10000.0f * max;
+	}
+
+	/** A gently sloping floor made of a grid of quads, split in two triangles */
+	void buildFloor(int size) {
+		_triangles.clear();
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				Math::Vector3d a(x * 10.0f, y * 10.0f, (x + y) * 0.5f);
+				Math::Vector3d b(a.x() + 10.0f, a.y(), a.z() + 0.5f);
+				Math::Vector3d c(a.x(), a.y() + 10.0f, a.z() + 0.5f);
+				Math::Vector3d d(a.x() + 10.0f, a.y() + 10.0f, a.z() + 1.0f);
+
+				Triangle t1 = { { a, b, c } };
+				Triangle t2 = { { b, d, c } };
+				_triangles.push_back(t1);
+				_triangles.push_back(t2);
+			}
+		}
+	}
+
+	static bool isPointInside(const Triangle &t, const Math::Vector3d &p) {
+		float d1 = (p.x() - t.v[1].x()) * (t.v[0].y() - t.v[1].y()) - (t.v[0].x() - t.v[1].x()) * (p.y() - t.v[1].y());
+		float d2 = (p.x() - t.v[2].x()) * (t.v[1].y() - t.v[2].y()) - (t.v[1].x() - t.v[2].x()) * (p.y() - t.v[2].y());
+		float d3 = (p.x() - t.v[0].x()) * (t.v[2].y() - t.v[0].y()) - (t.v[2].x() - t.v[0].x()) * (p.y() - t.v[0].y());
+		bool hasNegative = d1 < 0 || d2 < 0 || d3 < 0;
+		bool hasPositive = d1 > 0 || d2 > 0 || d3 > 0;
+		return !(hasNegative && hasPositive);
+	}
+
+	static bool intersectRay(const Triangle &t, const Math::Ray &ray) {
+		Math::Vector3d n = Math::Vector3d::crossProduct(t.v[1] - t.v[0], t.v[2] - t.v[0]);
+		float denom = Math::Vector3d::dotProduct(n, ray.getDirection());
+		if (fabs(denom) < 0.00001f)
+			return false;
+
+		float r = -Math::Vector3d::dotProduct(n, ray.getOrigin() - t.v[0]) / denom;
+		return r >= 0.0f && isPointInside(t, ray.getOrigin() + r * ray.getDirection());
+	}
+
+	void benchmarkFloor(int size) {
+		buildFloor(size);
+
+		Common::Array<Math::AABB> boxes;
+		for (uint i = 0; i < _triangles.size(); i++) {
+			Math::AABB box;
+			for (uint j = 0; j < 3; j++) {
+				box.expand(_triangles[i].v[j]);
+			}
+			boxes.push_back(box);
+		}
+
+		Math::UniformGrid grid;
+		grid.build(boxes);
+
+		Common::Array<Math::Vector3d> points;
+		Common::Array<Math::Ray> rays;
+		for (uint i = 0; i < 1024; i++) {
+			points.push_back(Math::Vector3d(randomFloat(size * 10.0f), randomFloat(size * 10.0f), 0.0f));
+
+			// Rays from a camera above the floor, looking down at it
+			Math::Vector3d target(randomFloat(size * 10.0f), randomFloat(size * 10.0f), 0.0f);
+			Math::Vector3d origin(size * 5.0f, -size * 5.0f, size * 10.0f);
+			rays.push_back(Math::Ray(origin, target - origin));
+		}
+
+		uint found = 0;
+		BenchmarkTimer bruteForcePointTimer;
+		for (uint i = 0; i < kBruteForceQueries; i++) {
+			const Math::Vector3d &point = points[i % points.size()];
+			for (uint j = 0; j < _triangles.size(); j++) {
+				if (isPointInside(_triangles[j], point)) {
+					found++;
+					break;
+				}
+			}
+		}
+		double bruteForcePointSeconds = bruteForcePointTimer.getElapsedSeconds();
+
+		uint gridFound = 0;
+		BenchmarkTimer gridPointTimer;
+		for (uint i = 0; i < kQueries; i++) {
+			const Math::Vector3d &point = points[i % points.size()];
+			uint count;
+			const uint32 *items = grid.findItemsAtPoint(point, count);
+			for (uint j = 0; j < count; j++) {
+				if (isPointInside(_triangles[items[j]], point)) {
+					if (i < kBruteForceQueries)
+						gridFound++;
+					break;
+				}
+			}
+		}
+		double gridPointSeconds = gridPointTimer.getElapsedSeconds();
+
+		BenchmarkTimer bruteForceRayTimer;
+		for (uint i = 0; i < kBruteForceQueries / 4; i++) {
+			const Math::Ray &ray = rays[i % rays.size()];
+			for (uint j = 0; j < _triangles.size(); j++) {
+				if (intersectRay(_triangles[j], ray)) {
+					found++;
+					break;
+				}
+			}
+		}
+		double bruteForceRaySeconds = bruteForceRayTimer.getElapsedSeconds();
+
+		Common::Array<uint32> items;
+		BenchmarkTimer gridRayTimer;
+		for (uint i = 0; i < kQueries / 4; i++) {
+			const Math::Ray &ray = rays[i % rays.size()];
+			items.clear();
+			grid.findItemsAlongRay(ray, items);
+			for (uint j = 0; j < items.size(); j++) {
+				if (intersectRay(_triangles[items[j]], ray)) {
+					if (i < kBruteForceQueries / 4)
+						gridFound++;
+					break;
+				}
+			}
+		}
+		double gridRaySeconds = gridRayTimer.getElapsedSeconds();
+
+		// Both methods find the same number of faces
+		TS_ASSERT_EQUALS(found, gridFound);
+
+		char name[64];
+		snprintf(name, sizeof(name), "point in %4d faces, all faces", _triangles.size());
+		reportThroughput(name, kBruteForceQueries, "queries", bruteForcePointSeconds);
+		snprintf(name, sizeof(name), "point in %4d faces, grid", _triangles.size());
+		reportThroughput(name, kQueries, "queries", gridPointSeconds);
+		snprintf(name, sizeof(name), "ray hit %4d faces, all faces", _triangles.size());
+		reportThroughput(name, kBruteForceQueries / 4, "queries", bruteForceRaySeconds);
+		snprintf(name, sizeof(name), "ray hit %4d faces, grid", _triangles.size());
+		reportThroughput(name, kQueries / 4, "queries", gridRaySeconds);
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_floor_queries() {
+		benchmarkFloor(8);
+		benchmarkFloor(24);
+		benchmarkFloor(48);
+	}
+};
@@ -0,0 +1,68 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+#include "helper.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 500
+	};
+
+	void benchmarkConvert(const char *type, const Graphics::PixelFormat &format, const char *formatName) {
+		byte *yPlane = new byte[kWidth * kHeight];
+		byte *aPlane = new byte[kWidth * kHeight];
+		byte *uPlane = new byte[kWidth * kHeight];
+		byte *vPlane = new byte[kWidth * kHeight];
+
+		uint32 seed = 1;
+		for (int i = 0; i < kWidth * kHeight; ++i) {
+			seed = seed * 1103515245 + 12345;
+			yPlane[i] = (byte)(seed >> 16);
+			aPlane[i] = (byte)(seed >> 8);
+			uPlane[i] = (byte)(seed >> 20);
+			vPlane[i] = (byte)(seed >> 24);
+		}
+
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, format);
+
+		BenchmarkTimer timer;
+		for (int i = 0; i < kFrames; ++i) {
+			if (!strcmp(type, "yuv420"))
+				YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, kWidth, kHeight, kWidth, kWidth / 2);
+			else if (!strcmp(type, "yuva420"))
+				YUVAToRGBAMan.convert420(&surface, Graphics::YUVAToRGBAManager::kScaleITU, yPlane, uPlane, vPlane, aPlane, kWidth, kHeight, kWidth, kWidth / 2);
+			else
+				YUVToRGBMan.convert444(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, kWidth, kHeight, kWidth, kWidth);
+		}
+		double seconds = timer.getElapsedSeconds();
+
+		char name[64];
+		snprintf(name, sizeof(name), "%-7s -> %-8s %dx%d", type, formatName, kWidth, kHeight);
+		reportThroughput(name, (double)kWidth * kHeight * kFrames, "pixels", seconds);
+
+		surface.free();
+		delete[] vPlane;
+		delete[] uPlane;
+		delete[] aPlane;
+		delete[] yPlane;
+	}
+
+public:
+	void test_convert() {
+		const Graphics::PixelFormat rgba8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		benchmarkConvert("yuv420", rgba8888, "RGBA8888");
+		benchmarkConvert("yuv420", rgb565, "RGB565");
+		benchmarkConvert("yuva420", rgba8888, "RGBA8888");
+		benchmarkConvert("yuv444", rgba8888, "RGBA8888");
+	}
+};
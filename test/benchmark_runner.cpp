@@ -0,0 +1,74 @@
+/* Generated file, do not edit */
+
+#ifndef CXXTEST_RUNNING
+#define CXXTEST_RUNNING
+#endif
+
+#include "./test/cxxtest_mingw.h"
+#include <cxxtest/TestListener.h>
+#include <cxxtest/TestTracker.h>
+#include <cxxtest/TestRunner.h>
+#include <cxxtest/RealDescriptions.h>
+#include <cxxtest/StdioPrinter.h>
+
+int main() {
+ return CxxTest::StdioPrinter().run();
+}
+#include "test/benchmark/rate.h"
+
+static RateConverterBenchmarkSuite suite_RateConverterBenchmarkSuite;
+
+static CxxTest::List Tests_RateConverterBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RateConverterBenchmarkSuite( "test/benchmark/rate.h", 52, "RateConverterBenchmarkSuite", suite_RateConverterBenchmarkSuite, Tests_RateConverterBenchmarkSuite );
+
+static class TestDescription_RateConverterBenchmarkSuite_test_copy_converter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_copy_converter() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 93, "test_copy_converter" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_copy_converter(); }
+} testDescription_RateConverterBenchmarkSuite_test_copy_converter;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_simple_converter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_simple_converter() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 98, "test_simple_converter" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_simple_converter(); }
+} testDescription_RateConverterBenchmarkSuite_test_simple_converter;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_linear_converter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_linear_converter() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 103, "test_linear_converter" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_linear_converter(); }
+} testDescription_RateConverterBenchmarkSuite_test_linear_converter;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_converter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_converter() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 110, "test_sinc_converter" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_converter(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_converter;
+
+#include "test/benchmark/uniformgrid.h"
+
+static UniformGridBenchmarkSuite suite_UniformGridBenchmarkSuite;
+
+static CxxTest::List Tests_UniformGridBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_UniformGridBenchmarkSuite( "test/benchmark/uniformgrid.h", 11, "UniformGridBenchmarkSuite", suite_UniformGridBenchmarkSuite, Tests_UniformGridBenchmarkSuite );
+
+static class TestDescription_UniformGridBenchmarkSuite_test_floor_queries : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UniformGridBenchmarkSuite_test_floor_queries() : CxxTest::RealTestDescription( Tests_UniformGridBenchmarkSuite, suiteDescription_UniformGridBenchmarkSuite, 171, "test_floor_queries" ) {}
+ void runTest() { suite_UniformGridBenchmarkSuite.test_floor_queries(); }
+} testDescription_UniformGridBenchmarkSuite_test_floor_queries;
+
+#include "test/benchmark/yuv_to_rgb.h"
+
+static YUVToRGBBenchmarkSuite suite_YUVToRGBBenchmarkSuite;
+
+static CxxTest::List Tests_YUVToRGBBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_YUVToRGBBenchmarkSuite( "test/benchmark/yuv_to_rgb.h", 9, "YUVToRGBBenchmarkSuite", suite_YUVToRGBBenchmarkSuite, Tests_YUVToRGBBenchmarkSuite );
+
+static class TestDescription_YUVToRGBBenchmarkSuite_test_convert : public CxxTest::RealTestDescription {
+public:
+ TestDescription_YUVToRGBBenchmarkSuite_test_convert() : CxxTest::RealTestDescription( Tests_YUVToRGBBenchmarkSuite, suiteDescription_YUVToRGBBenchmarkSuite, 59, "test_convert" ) {}
+ void runTest() { suite_YUVToRGBBenchmarkSuite.test_convert(); }
+} testDescription_YUVToRGBBenchmarkSuite_test_convert;
+
+#include <cxxtest/Root.cpp>
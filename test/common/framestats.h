@@ -0,0 +1,53 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/framestats.h"
+
+class FrameStatisticsTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty() {
+		Common::FrameStatistics stats;
+
+		TS_ASSERT_EQUALS(stats.getFrameCount(), 0u);
+		TS_ASSERT_EQUALS(stats.getFramesPerSecond(), 0.0);
+		TS_ASSERT_EQUALS(stats.getPercentile(50), 0u);
+	}
+
+	void test_frames_per_second() {
+		Common::FrameStatistics stats;
+		for (int i = 0; i < 100; i++)
+			stats.addFrame(10000);
+
+		TS_ASSERT_EQUALS(stats.getFrameCount(), 100u);
+		TS_ASSERT_EQUALS(stats.getTotalTime(), 1000000u);
+		TS_ASSERT_DELTA(stats.getFramesPerSecond(), 100.0, 0.001);
+	}
+
+	void test_percentiles() {
+		Common::FrameStatistics stats;
+
+		// Add the durations 1 to 100 out of order
+		for (uint32 i = 0; i < 100; i++)
+			stats.addFrame((i * 37) % 100 + 1);
+
+		TS_ASSERT_EQUALS(stats.getPercentile(0), 1u);
+		TS_ASSERT_EQUALS(stats.getPercentile(1), 1u);
+		TS_ASSERT_EQUALS(stats.getPercentile(50), 50u);
+		TS_ASSERT_EQUALS(stats.getPercentile(90), 90u);
+		TS_ASSERT_EQUALS(stats.getPercentile(99), 99u);
+		TS_ASSERT_EQUALS(stats.getPercentile(100), 100u);
+
+		// Adding frames after a percentile was computed
+		stats.addFrame(1000);
+		TS_ASSERT_EQUALS(stats.getPercentile(100), 1000u);
+		TS_ASSERT_EQUALS(stats.getPercentile(0), 1u);
+	}
+
+	void test_reset() {
+		Common::FrameStatistics stats;
+		stats.addFrame(5);
+		stats.reset();
+
+		TS_ASSERT_EQUALS(stats.getFrameCount(), 0u);
+		TS_ASSERT_EQUALS(stats.getTotalTime(), 0u);
+	}
+};
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelbuffer.h"
+#include "graphics/tinygl/zgl.h"
+
+class TinyGLSpansTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 157,
+		kHeight = 67,
+		kTextureSize = 16,
+		kTriangles = 300
+	};
+
+	uint32 _seed;
+
+	uint32 nextInt() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	float nextFloat(float min, float max) {
+		return min + (max - min) * (nextInt() & 0x7fff) / 32767.0f;
+	}
+
+	// Small triangles make spans of a few pixels, anywhere on the screen so
+	// that they start at any alignment. The large ones go out of the screen.
+	void randomTriangle() {
+		float size = (nextInt() & 3) ? nextFloat(0.01f, 0.1f) : nextFloat(0.1f, 1.5f);
+		float x = nextFloat(-1.1f, 1.1f);
+		float y = nextFloat(-1.1f, 1.1f);
+		for (int v = 0; v < 3; v++) {
+			tglColor4f(nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f));
+			tglTexCoord2f(nextFloat(-1.0f, 2.0f), nextFloat(-1.0f, 2.0f));
+			tglVertex3f(x + nextFloat(-size, size), y + nextFloat(-size, size), nextFloat(-0.9f, 0.9f));
+		}
+	}
+
+	void drawScene(bool depthWrite, bool alphaTest) {
+		_seed = 42;
+
+		tglClearColor(0.2f, 0.3f, 0.4f, 0.5f);
+		tglClearDepth(1.0);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		if (alphaTest)
+			tglEnable(TGL_ALPHA_TEST);
+		tglAlphaFunc(TGL_GREATER, 0.5f);
+
+		for (int i = 0; i < kTriangles; i++) {
+			uint32 flags = nextInt();
+			if (flags & 1)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+			// The span kernels only handle the first blending mode
+			if (flags & 2)
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			else
+				tglBlendFunc(TGL_ONE, TGL_ONE);
+			if (flags & 4)
+				tglEnable(TGL_TEXTURE_2D);
+			else
+				tglDisable(TGL_TEXTURE_2D);
+			tglShadeModel((flags & 8) ? TGL_SMOOTH : TGL_FLAT);
+
+			static const int depthFunctions[] = {
+				TGL_LESS, TGL_LEQUAL, TGL_GREATER, TGL_GEQUAL, TGL_EQUAL, TGL_NOTEQUAL, TGL_ALWAYS
+			};
+			tglDepthFunc(depthFunctions[(flags >> 4) % ARRAYSIZE(depthFunctions)]);
+
+			// The first triangles always fill the depth buffer, so that the
+			// depth test has something to compare to.
+			tglDepthMask((depthWrite || i < kTriangles / 10) ? TGL_TRUE : TGL_FALSE);
+
+			tglBegin(TGL_TRIANGLES);
+			randomTriangle();
+			tglEnd();
+		}
+	}
+
+	void render(bool spanKernels, bool depthWrite, bool alphaTest, bool scissor, uint32 *pixels, uint32 *depth) {
+		Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::PixelBuffer buffer(format, kWidth * kHeight, DisposeAfterUse::YES);
+		TinyGL::FrameBuffer *frameBuffer = new TinyGL::FrameBuffer(kWidth, kHeight, buffer);
+		TinyGL::glInit(frameBuffer, 256);
+		frameBuffer->enableSpanKernels(spanKernels);
+
+		uint32 texels[kTextureSize * kTextureSize];
+		_seed = 1;
+		for (int i = 0; i < kTextureSize * kTextureSize; i++)
+			texels[i] = nextInt() | (nextInt() << 16);
+
+		uint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, 4, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		drawScene(depthWrite, alphaTest);
+		// Odd bounds, so that the scissor test cuts the spans anywhere
+		if (scissor)
+			frameBuffer->setScissorRectangle(13, kWidth - 10, 7, kHeight - 6);
+		TinyGL::tglPresentBuffer();
+
+		memcpy(pixels, frameBuffer->getPixelBuffer(), kWidth * kHeight * sizeof(uint32));
+		memcpy(depth, frameBuffer->getZBuffer(), kWidth * kHeight * sizeof(uint32));
+
+		tglDeleteTextures(1, &texture);
+		TinyGL::glClose();
+		delete frameBuffer;
+	}
+
+	// Renders the same triangles with and without the span kernels
+	void checkSpans(bool depthWrite, bool alphaTest, bool scissor) {
+		uint32 *referencePixels = new uint32[kWidth * kHeight];
+		uint32 *referenceDepth = new uint32[kWidth * kHeight];
+		uint32 *pixels = new uint32[kWidth * kHeight];
+		uint32 *depth = new uint32[kWidth * kHeight];
+
+		render(false, depthWrite, alphaTest, scissor, referencePixels, referenceDepth);
+		render(true, depthWrite, alphaTest, scissor, pixels, depth);
+
+		int pixelDifferences = 0, depthDifferences = 0;
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			pixelDifferences += pixels[i] != referencePixels[i];
+			depthDifferences += depth[i] != referenceDepth[i];
+		}
+		TS_ASSERT_EQUALS(pixelDifferences, 0);
+		TS_ASSERT_EQUALS(depthDifferences, 0);
+
+		delete[] referencePixels;
+		delete[] referenceDepth;
+		delete[] pixels;
+		delete[] depth;
+	}
+
+public:
+	void test_depth_write() {
+		checkSpans(true, false, false);
+	}
+
+	void test_no_depth_write() {
+		checkSpans(false, false, false);
+	}
+
+	// The alpha test always goes through the scalar loops
+	void test_alpha_test() {
+		checkSpans(true, true, false);
+		checkSpans(false, true, false);
+	}
+
+	void test_scissor() {
+		checkSpans(true, false, true);
+		checkSpans(false, false, true);
+	}
+};
@@ -0,0 +1,246 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/workerpool.h"
+
+#include "graphics/pixelbuffer.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zblit.h"
+
+// Runs the jobs on the calling thread in a scrambled order, each one as a
+// different worker, which is enough to catch state shared between workers.
+class ScrambledWorkerPool : public Common::WorkerPool {
+public:
+	ScrambledWorkerPool(uint workerCount) : _workerCount(workerCount), _currentWorker(0), _jobs(0) {}
+
+	virtual uint getWorkerCount() const { return _workerCount; }
+	virtual uint getCurrentWorker() const { return _currentWorker; }
+
+	virtual void run(Job job, void *data, uint count) {
+		// Odd indices first in decreasing order, then even ones
+		for (uint pass = 0; pass < 2; pass++) {
+			for (uint i = count; i > 0; i--) {
+				uint index = i - 1;
+				if ((index & 1) == pass)
+					continue;
+				_currentWorker = _jobs++ % _workerCount;
+				job(data, index);
+			}
+		}
+		_currentWorker = 0;
+	}
+
+	uint getJobCount() const { return _jobs; }
+
+private:
+	uint _workerCount;
+	uint _currentWorker;
+	uint _jobs;
+};
+
+class TinyGLTilesTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 203,
+		kHeight = 141,
+		kTextureSize = 16
+	};
+
+	enum PresentMode {
+		kPresentSimple,
+		kPresentTiled,
+		kPresentDirtyRects
+	};
+
+	uint32 _seed;
+
+	uint32 nextInt() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	float nextFloat(float min, float max) {
+		return min + (max - min) * (nextInt() & 0x7fff) / 32767.0f;
+	}
+
+	void randomVertex() {
+		tglColor4f(nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f));
+		tglTexCoord2f(nextFloat(0.0f, 1.0f), nextFloat(0.0f, 1.0f));
+		// Some vertices are out of the screen, so that clipping is exercised too
+		tglVertex3f(nextFloat(-1.2f, 1.2f), nextFloat(-1.2f, 1.2f), nextFloat(-0.9f, 0.9f));
+	}
+
+	// Draws a scene going through every kind of draw call, the ones which
+	// modify the vertices while they are drawn and the shadow mask included.
+	void drawScene(uint32 seed, Graphics::BlitImage *image, byte *shadowMask) {
+		_seed = seed;
+
+		tglClearColor(0.2f, 0.3f, 0.4f, 1.0f);
+		tglClearDepth(1.0);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+
+		for (int i = 0; i < 60; i++) {
+			uint32 flags = nextInt();
+			if (flags & 1)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+			if (flags & 2)
+				tglEnable(TGL_ALPHA_TEST);
+			else
+				tglDisable(TGL_ALPHA_TEST);
+			if (flags & 4)
+				tglEnable(TGL_TEXTURE_2D);
+			else
+				tglDisable(TGL_TEXTURE_2D);
+			tglShadeModel((flags & 8) ? TGL_SMOOTH : TGL_FLAT);
+			tglDepthMask((flags & 16) ? TGL_TRUE : TGL_FALSE);
+			tglAlphaFunc(TGL_GREATER, 0.3f);
+
+			static const int primitives[] = {
+				TGL_TRIANGLES, TGL_TRIANGLE_STRIP, TGL_TRIANGLE_FAN, TGL_QUADS, TGL_QUAD_STRIP, TGL_POLYGON, TGL_LINES
+			};
+			int primitive = primitives[(flags >> 5) % ARRAYSIZE(primitives)];
+			tglBegin(primitive);
+			int vertexCount = primitive == TGL_LINES ? 6 : 4 + (flags >> 8) % 2 * 2;
+			for (int v = 0; v < vertexCount; v++)
+				randomVertex();
+			tglEnd();
+		}
+
+		tglDisable(TGL_BLEND);
+		tglDisable(TGL_ALPHA_TEST);
+		tglDisable(TGL_TEXTURE_2D);
+		tglDepthMask(TGL_TRUE);
+
+		// A shadow mask covering the screen partially, then a shadow through it
+		tglSetShadowMaskBuf(shadowMask);
+		tglSetShadowColor(20, 30, 40);
+		tglEnable(TGL_SHADOW_MASK_MODE);
+		tglBegin(TGL_TRIANGLES);
+		for (int v = 0; v < 3; v++)
+			randomVertex();
+		tglEnd();
+		tglDisable(TGL_SHADOW_MASK_MODE);
+		tglEnable(TGL_SHADOW_MODE);
+		tglBegin(TGL_QUADS);
+		tglVertex3f(-1.0f, -1.0f, -0.95f);
+		tglVertex3f(1.0f, -1.0f, -0.95f);
+		tglVertex3f(1.0f, 1.0f, -0.95f);
+		tglVertex3f(-1.0f, 1.0f, -0.95f);
+		tglEnd();
+		tglDisable(TGL_SHADOW_MODE);
+
+		Graphics::BlitTransform transform(nextInt() % kWidth - 8, nextInt() % kHeight - 8);
+		transform.tint(0.7f);
+		Graphics::tglBlit(image, transform);
+	}
+
+	// Draws two small quads in opposite corners of the screen, moving on every
+	// frame, so that the dirty rectangles don't merge into a single one.
+	void drawMarkers(int frame) {
+		tglDisable(TGL_DEPTH_TEST);
+		for (int i = 0; i < 2; i++) {
+			float x = (i ? 0.5f : -0.9f) + frame * 0.05f;
+			float y = (i ? 0.5f : -0.9f) + frame * 0.03f;
+			tglColor4f(1.0f, 0.5f * i, 0.25f * frame, 1.0f);
+			tglBegin(TGL_QUADS);
+			tglVertex3f(x, y, 0.0f);
+			tglVertex3f(x + 0.2f, y, 0.0f);
+			tglVertex3f(x + 0.2f, y + 0.2f, 0.0f);
+			tglVertex3f(x, y + 0.2f, 0.0f);
+			tglEnd();
+		}
+		tglEnable(TGL_DEPTH_TEST);
+	}
+
+	void render(PresentMode mode, Common::WorkerPool *pool, int frames, uint32 *pixels, uint32 *depth) {
+		Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::PixelBuffer buffer(format, kWidth * kHeight, DisposeAfterUse::YES);
+		TinyGL::FrameBuffer *frameBuffer = new TinyGL::FrameBuffer(kWidth, kHeight, buffer);
+		TinyGL::glInit(frameBuffer, 256);
+		tglEnableDirtyRects(mode == kPresentDirtyRects);
+		tglEnableTiledRendering(mode == kPresentTiled);
+		tglSetWorkerPool(pool);
+
+		uint32 texels[kTextureSize * kTextureSize];
+		Graphics::Surface surface;
+		surface.create(kTextureSize, kTextureSize, format);
+		_seed = 1;
+		for (int i = 0; i < kTextureSize * kTextureSize; i++) {
+			texels[i] = nextInt() | (nextInt() << 16);
+			((uint32 *)surface.getPixels())[i] = texels[i];
+		}
+
+		uint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, 4, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		Graphics::BlitImage *image = Graphics::tglGenBlitImage();
+		Graphics::tglUploadBlitImage(image, surface, 0, false);
+		surface.free();
+
+		byte *shadowMask = new byte[kWidth * kHeight];
+		for (int frame = 0; frame < frames; frame++) {
+			memset(shadowMask, 0, kWidth * kHeight);
+			// Only the markers change from one frame to the next
+			drawScene(123, image, shadowMask);
+			drawMarkers(frame);
+			TinyGL::tglPresentBuffer();
+		}
+		delete[] shadowMask;
+
+		memcpy(pixels, frameBuffer->getPixelBuffer(), kWidth * kHeight * sizeof(uint32));
+		memcpy(depth, frameBuffer->getZBuffer(), kWidth * kHeight * sizeof(uint32));
+
+		Graphics::tglDeleteBlitImage(image);
+		tglDeleteTextures(1, &texture);
+		TinyGL::glClose();
+		delete frameBuffer;
+	}
+
+	void checkSameImage(PresentMode mode, Common::WorkerPool *pool, int frames) {
+		uint32 *referencePixels = new uint32[kWidth * kHeight];
+		uint32 *referenceDepth = new uint32[kWidth * kHeight];
+		uint32 *pixels = new uint32[kWidth * kHeight];
+		uint32 *depth = new uint32[kWidth * kHeight];
+
+		render(kPresentSimple, nullptr, frames, referencePixels, referenceDepth);
+		render(mode, pool, frames, pixels, depth);
+
+		int pixelDifferences = 0, depthDifferences = 0;
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			pixelDifferences += pixels[i] != referencePixels[i];
+			depthDifferences += depth[i] != referenceDepth[i];
+		}
+		TS_ASSERT_EQUALS(pixelDifferences, 0);
+		TS_ASSERT_EQUALS(depthDifferences, 0);
+
+		delete[] referencePixels;
+		delete[] referenceDepth;
+		delete[] pixels;
+		delete[] depth;
+	}
+
+public:
+	void test_tiled() {
+		checkSameImage(kPresentTiled, nullptr, 1);
+	}
+
+	void test_tiled_workers() {
+		ScrambledWorkerPool pool(3);
+		checkSameImage(kPresentTiled, &pool, 1);
+		// One job per screen tile
+		const int tileSize = TinyGL::TileRenderer::kTileSize;
+		int tiles = ((kWidth + tileSize - 1) / tileSize) * ((kHeight + tileSize - 1) / tileSize);
+		TS_ASSERT_EQUALS(pool.getJobCount(), (uint)tiles);
+	}
+
+	void test_dirty_rects_workers() {
+		ScrambledWorkerPool pool(4);
+		checkSameImage(kPresentDirtyRects, &pool, 3);
+		TS_ASSERT(pool.getJobCount() > 0);
+	}
+};
@@ -0,0 +1,173 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	byte nextByte() {
+		_seed = _seed * 1103515245 + 12345;
+		return (byte)(_seed >> 16);
+	}
+
+	static int referenceComponent(int value, bool itu) {
+		if (itu) {
+			value = CLIP(value, 16, 235);
+			return (value - 16) * 255 / 219;
+		}
+
+		return CLIP(value, 0, 255);
+	}
+
+	// Straightforward version of the conversion done through the lookup tables
+	static uint32 referencePixel(const Graphics::PixelFormat &format, bool itu, byte y, byte u, byte v, const byte *a) {
+		int16 cr = v - 128, cb = u - 128;
+		int r = y + (int16)((0.419 / 0.299) * cr);
+		int g = y + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb);
+		int b = y + (int16)((0.587 / 0.331) * cb);
+
+		r = referenceComponent(r, itu);
+		g = referenceComponent(g, itu);
+		b = referenceComponent(b, itu);
+
+		if (a)
+			return format.ARGBToColor(*a, r, g, b);
+
+		return format.RGBToColor(r, g, b);
+	}
+
+	static uint32 readPixel(const Graphics::Surface &surface, int x, int y) {
+		const void *pixel = surface.getBasePtr(x, y);
+		if (surface.format.bytesPerPixel == 2)
+			return *(const uint16 *)pixel;
+
+		return *(const uint32 *)pixel;
+	}
+
+	byte *createPlane(int size) {
+		byte *plane = new byte[size];
+		for (int i = 0; i < size; ++i)
+			plane[i] = nextByte();
+		return plane;
+	}
+
+	// Every combination of chroma values, with random luminance and alpha values
+	void testConvert420(const Graphics::PixelFormat &format, bool itu, bool alpha, int width) {
+		const int uvWidth = 256;
+		const int uvHeight = 256;
+		const int yPitch = uvWidth * 2;
+		const int height = uvHeight * 2;
+
+		byte *yPlane = createPlane(yPitch * height);
+		byte *aPlane = createPlane(yPitch * height);
+		byte *uPlane = new byte[uvWidth * uvHeight];
+		byte *vPlane = new byte[uvWidth * uvHeight];
+		for (int i = 0; i < uvWidth * uvHeight; ++i) {
+			uPlane[i] = i & 0xFF;
+			vPlane[i] = i >> 8;
+		}
+
+		// Leave some room after the converted pixels, so that the pitches differ from the widths
+		Graphics::Surface surface;
+		surface.create(width + 5, height, format);
+		memset(surface.getPixels(), 0xAB, surface.pitch * surface.h);
+
+		Graphics::YUVToRGBManager::LuminanceScale scale = itu ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+		if (alpha)
+			YUVAToRGBAMan.convert420(&surface, (Graphics::YUVAToRGBAManager::LuminanceScale)scale, yPlane, uPlane, vPlane, aPlane, width, height, yPitch, uvWidth);
+		else
+			YUVToRGBMan.convert420(&surface, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvWidth);
+
+		int errors = 0;
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				int uvIndex = (y >> 1) * uvWidth + (x >> 1);
+				const byte *a = alpha ? &aPlane[y * yPitch + x] : 0;
+				uint32 expected = referencePixel(format, itu, yPlane[y * yPitch + x], uPlane[uvIndex], vPlane[uvIndex], a);
+				if (readPixel(surface, x, y) != expected)
+					errors++;
+			}
+
+			// The pixels past the width are left untouched
+			if (format.bytesPerPixel == 4 && readPixel(surface, width, y) != 0xABABABAB)
+				errors++;
+		}
+		TS_ASSERT_EQUALS(errors, 0);
+
+		surface.free();
+		delete[] vPlane;
+		delete[] uPlane;
+		delete[] aPlane;
+		delete[] yPlane;
+	}
+
+	void testConvert444(const Graphics::PixelFormat &format, bool itu, int width) {
+		const int height = 256;
+		const int pitch = 256;
+
+		byte *yPlane = createPlane(pitch * height);
+		byte *uPlane = new byte[pitch * height];
+		byte *vPlane = new byte[pitch * height];
+		for (int i = 0; i < pitch * height; ++i) {
+			uPlane[i] = i & 0xFF;
+			vPlane[i] = i >> 8;
+		}
+
+		Graphics::Surface surface;
+		surface.create(width + 3, height, format);
+
+		Graphics::YUVToRGBManager::LuminanceScale scale = itu ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+		YUVToRGBMan.convert444(&surface, scale, yPlane, uPlane, vPlane, width, height, pitch, pitch);
+
+		int errors = 0;
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				int index = y * pitch + x;
+				if (readPixel(surface, x, y) != referencePixel(format, itu, yPlane[index], uPlane[index], vPlane[index], 0))
+					errors++;
+			}
+		}
+		TS_ASSERT_EQUALS(errors, 0);
+
+		surface.free();
+		delete[] vPlane;
+		delete[] uPlane;
+		delete[] yPlane;
+	}
+
+	void testAllFormats(bool itu) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), // RGBA8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), // ABGR8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), // ARGB8888
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),  // XRGB8888
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)   // RGB565
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			testConvert420(formats[i], itu, false, 512);
+			testConvert420(formats[i], itu, false, 38);
+			testConvert420(formats[i], itu, true, 512);
+			testConvert420(formats[i], itu, true, 38);
+			testConvert444(formats[i], itu, 256);
+			testConvert444(formats[i], itu, 21);
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_convert_full_scale() {
+		testAllFormats(false);
+	}
+
+	void test_convert_itu_scale() {
+		testAllFormats(true);
+	}
+};
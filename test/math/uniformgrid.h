@@ -0,0 +1,207 @@
+#include <cxxtest/TestSuite.h>
+
+#include "math/uniformgrid.h"
+
+class UniformGridTestSuite : public CxxTest::TestSuite {
+private:
+	uint32 _seed;
+
+	float randomFloat(float max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % 10000 / 10000.0f * max;
+	}
+
+	void buildRandomBoxes(Common::Array<Math::AABB> &boxes, uint count) {
+		for (uint i = 0; i < count; i++) {
+			Math::Vector3d min(randomFloat(100.0f), randomFloat(50.0f), randomFloat(5.0f));
+			Math::Vector3d size(randomFloat(8.0f), randomFloat(8.0f), randomFloat(2.0f));
+			boxes.push_back(Math::AABB(min, min + size));
+		}
+	}
+
+	static bool containsXY(const Math::AABB &box, float x, float y) {
+		return x >= box.getMin().x() && x <= box.getMax().x()
+				&& y >= box.getMin().y() && y <= box.getMax().y();
+	}
+
+	static bool overlapsXY(const Math::AABB &box, float minX, float minY, float maxX, float maxY) {
+		return box.getMax().x() >= minX && box.getMin().x() <= maxX
+				&& box.getMax().y() >= minY && box.getMin().y() <= maxY;
+	}
+
+	static bool contains(const Common::Array<uint32> &items, uint32 item) {
+		for (uint i = 0; i < items.size(); i++) {
+			if (items[i] == item)
+				return true;
+		}
+		return false;
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_empty() {
+		Math::UniformGrid grid;
+		Common::Array<Math::AABB> boxes;
+		grid.build(boxes);
+
+		uint count = 1;
+		grid.findItemsAtPoint(Math::Vector3d(0, 0, 0), count);
+		TS_ASSERT_EQUALS(count, 0u);
+
+		Common::Array<uint32> items;
+		grid.findItemsInRect(-10, -10, 10, 10, items);
+		grid.findItemsAlongRay(Math::Ray(Math::Vector3d(0, 0, 10), Math::Vector3d(0, 0, -1)), items);
+		TS_ASSERT(items.empty());
+	}
+
+	void test_items_at_point() {
+		Common::Array<Math::AABB> boxes;
+		buildRandomBoxes(boxes, 500);
+
+		Math::UniformGrid grid;
+		grid.build(boxes);
+
+		for (uint i = 0; i < 1000; i++) {
+			float x = randomFloat(120.0f) - 10.0f;
+			float y = randomFloat(70.0f) - 10.0f;
+
+			uint count;
+			const uint32 *items = grid.findItemsAtPoint(Math::Vector3d(x, y, 0), count);
+
+			// The items are sorted by index
+			for (uint j = 1; j < count; j++) {
+				TS_ASSERT_LESS_THAN(items[j - 1], items[j]);
+			}
+
+			// No item containing the point is missing
+			for (uint j = 0; j < boxes.size(); j++) {
+				if (!containsXY(boxes[j], x, y))
+					continue;
+
+				bool found = false;
+				for (uint k = 0; k < count; k++) {
+					found |= items[k] == j;
+				}
+				TS_ASSERT(found);
+			}
+		}
+	}
+
+	void test_items_in_rect() {
+		Common::Array<Math::AABB> boxes;
+		buildRandomBoxes(boxes, 500);
+
+		Math::UniformGrid grid;
+		grid.build(boxes);
+
+		for (uint i = 0; i < 200; i++) {
+			float minX = randomFloat(110.0f) - 5.0f;
+			float minY = randomFloat(60.0f) - 5.0f;
+			float maxX = minX + randomFloat(20.0f);
+			float maxY = minY + randomFloat(20.0f);
+
+			Common::Array<uint32> items;
+			grid.findItemsInRect(minX, minY, maxX, maxY, items);
+
+			// No duplicates
+			for (uint j = 0; j < items.size(); j++) {
+				for (uint k = j + 1; k < items.size(); k++) {
+					TS_ASSERT_DIFFERS(items[j], items[k]);
+				}
+			}
+
+			for (uint j = 0; j < boxes.size(); j++) {
+				if (overlapsXY(boxes[j], minX, minY, maxX, maxY)) {
+					TS_ASSERT(contains(items, j));
+				}
+			}
+		}
+	}
+
+	void test_items_along_segment() {
+		Common::Array<Math::AABB> boxes;
+		buildRandomBoxes(boxes, 500);
+
+		Math::UniformGrid grid;
+		grid.build(boxes);
+
+		for (uint i = 0; i < 200; i++) {
+			// Some segments start or end outside of the grid, or are axis aligned
+			Math::Vector3d begin(randomFloat(140.0f) - 20.0f, randomFloat(90.0f) - 20.0f, 0.0f);
+			Math::Vector3d end(randomFloat(140.0f) - 20.0f, randomFloat(90.0f) - 20.0f, 0.0f);
+			if (i % 10 == 0)
+				end.x() = begin.x();
+			else if (i % 10 == 1)
+				end.y() = begin.y();
+
+			Common::Array<uint32> items;
+			grid.findItemsAlongSegment(begin, end, items);
+
+			// No duplicates
+			for (uint j = 0; j < items.size(); j++) {
+				for (uint k = j + 1; k < items.size(); k++) {
+					TS_ASSERT_DIFFERS(items[j], items[k]);
+				}
+			}
+
+			for (uint j = 0; j < boxes.size(); j++) {
+				// Sample points of the segment inside the box
+				for (float t = 0.0f; t <= 1.0f; t += 0.001f) {
+					Math::Vector3d point = begin + t * (end - begin);
+					if (containsXY(boxes[j], point.x(), point.y())) {
+						TS_ASSERT(contains(items, j));
+						break;
+					}
+				}
+			}
+		}
+
+		// Only the cells crossed by a diagonal are visited, not its bounding rectangle
+		Common::Array<uint32> diagonalItems, rectItems;
+		grid.findItemsAlongSegment(Math::Vector3d(0, 0, 0), Math::Vector3d(100, 50, 0), diagonalItems);
+		grid.findItemsInRect(0, 0, 100, 50, rectItems);
+		TS_ASSERT_LESS_THAN(diagonalItems.size(), rectItems.size() / 2);
+
+		// A segment outside of the grid
+		Common::Array<uint32> items;
+		grid.findItemsAlongSegment(Math::Vector3d(-20, -20, 0), Math::Vector3d(-10, 80, 0), items);
+		TS_ASSERT(items.empty());
+	}
+
+	void test_items_along_ray() {
+		Common::Array<Math::AABB> boxes;
+		buildRandomBoxes(boxes, 500);
+
+		Math::UniformGrid grid;
+		grid.build(boxes);
+
+		for (uint i = 0; i < 200; i++) {
+			Math::Vector3d origin(randomFloat(100.0f), randomFloat(50.0f), 20.0f);
+			Math::Vector3d direction(randomFloat(2.0f) - 1.0f, randomFloat(2.0f) - 1.0f, -1.0f);
+			Math::Ray ray(origin, direction);
+
+			Common::Array<uint32> items;
+			grid.findItemsAlongRay(ray, items);
+
+			for (uint j = 0; j < boxes.size(); j++) {
+				// Sample points of the ray inside the box
+				for (float t = 0.0f; t < 30.0f; t += 0.05f) {
+					Math::Vector3d point = origin + t * direction;
+					if (containsXY(boxes[j], point.x(), point.y())
+							&& point.z() >= boxes[j].getMin().z() && point.z() <= boxes[j].getMax().z()) {
+						TS_ASSERT(contains(items, j));
+						break;
+					}
+				}
+			}
+		}
+
+		// A ray going away from the items
+		Common::Array<uint32> items;
+		grid.findItemsAlongRay(Math::Ray(Math::Vector3d(50, 25, 20), Math::Vector3d(0, 0, 1)), items);
+		TS_ASSERT(items.empty());
+	}
+};
@@ -39,6 +39,7 @@
 #include "common/rdft.h"
 #include "common/dct.h"
 #include "common/system.h"
+#include "common/workerpool.h"
 
 #include "graphics/yuva_to_rgba.h" // ResidualVM specific
 #include "graphics/surface.h"
@@ -245,6 +246,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
+	_surfaceDirty = false;
 
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
@@ -384,8 +386,10 @@ bool BinkDecoder::seekIntern(const Audio::Timestamp &time) {
 		audioTrack->seek(videoTrack->getFrameTime(keyFrame));
 	}
 
+	// The frames up to the target are never displayed, only decode them
+	// and leave the YUV to RGB conversion out.
 	while (getCurFrame() < (int32)frame - 1)
-		decodeNextFrame();
+		readNextPacket();
 
 	// Skip decoded audio between the keyframe and the target frame
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
@@ -478,21 +482,72 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _curPlanes[3]
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-	YUVAToRGBAMan.convert420(&_surface, Graphics::YUVAToRGBAManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-			_surfaceWidth, _surfaceHeight, _surfaceWidth, _surfaceWidth >> 1);
-
-	// And swap the planes with the reference planes
+	// Swap the planes with the reference planes. The conversion to our format
+	// is deferred until the frame is requested, so that the frames decoded
+	// but never displayed, when seeking for example, are not converted.
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
+	_surfaceDirty = true;
 	_curFrame++;
 }
 
+const Graphics::Surface *BinkDecoder::BinkVideoTrack::decodeNextFrame() {
+	if (_surfaceDirty)
+		convertPlanes();
+
+	return &_surface;
+}
+
+// The height of the bands of rows converted by the workers, must be even
+static const uint kConversionBandHeight = 32;
+
+void BinkDecoder::BinkVideoTrack::convertPlanes() {
+	// After decoding, the last frame is held in the reference planes.
+	assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2] && _oldPlanes[3]);
+
+	uint bandCount = (_surfaceHeight + kConversionBandHeight - 1) / kConversionBandHeight;
+	Common::WorkerPool *workerPool = g_system->getWorkerPool();
+	if (!workerPool || bandCount < 2) {
+		convertRows(0, _surfaceHeight);
+	} else {
+		// The bands are independent, but the first one is converted before
+		// the others so that the lookup tables of YUVAToRGBAMan are only
+		// ever built by this thread.
+		convertBand(this, 0);
+		workerPool->run(convertBandJob, this, bandCount - 1);
+	}
+
+	_surfaceDirty = false;
+}
+
+void BinkDecoder::BinkVideoTrack::convertBandJob(void *data, uint index) {
+	convertBand(data, index + 1);
+}
+
+void BinkDecoder::BinkVideoTrack::convertBand(void *data, uint index) {
+	BinkVideoTrack *track = (BinkVideoTrack *)data;
+	uint firstRow = index * kConversionBandHeight;
+	track->convertRows(firstRow, MIN<uint>(kConversionBandHeight, track->_surfaceHeight - firstRow));
+}
+
+void BinkDecoder::BinkVideoTrack::convertRows(uint firstRow, uint rowCount) {
+	// Only the pixels and the pitch of the destination are used
+	Graphics::Surface band = _surface;
+	band.setPixels(_surface.getBasePtr(0, firstRow));
+	band.h = rowCount;
+
+	// Convert the YUV data we have to our format
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _oldPlanes[3]
+	uint uvPitch = _surfaceWidth >> 1;
+	YUVAToRGBAMan.convert420(&band, Graphics::YUVAToRGBAManager::kScaleITU,
+			_oldPlanes[0] + firstRow * _surfaceWidth, _oldPlanes[1] + (firstRow >> 1) * uvPitch,
+			_oldPlanes[2] + (firstRow >> 1) * uvPitch, _oldPlanes[3] + firstRow * _surfaceWidth,
+			_surfaceWidth, rowCount, _surfaceWidth, uvPitch);
+}
+
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? ((_surface.w  + 15) >> 4) : ((_surface.w  + 7) >> 3);
 	uint32 blockHeight = isChroma ? ((_surface.h + 15) >> 4) : ((_surface.h + 7) >> 3);
@@ -156,7 +156,7 @@ private:
 		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() { return &_surface; }
+		const Graphics::Surface *decodeNextFrame();
 // ResidualVM-specific:
 		bool isSeekable() const { return true; }
 		bool seek(const Audio::Timestamp &time) { return true; }
@@ -247,6 +247,7 @@ private:
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		bool _surfaceDirty; ///< Does the surface need to be converted from the last decoded planes?
 
 		uint32 _id; ///< The BIK FourCC.
 
@@ -275,6 +276,15 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Convert the planes of the last decoded frame to the surface. */
+		void convertPlanes();
+		/** Convert the given rows of the planes of the last decoded frame to the surface. */
+		void convertRows(uint firstRow, uint rowCount);
+		/** Convert the given band of rows, data is the track. */
+		static void convertBand(void *data, uint index);
+		/** WorkerPool job converting the bands after the first one. */
+		static void convertBandJob(void *data, uint index);
+
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 